@@ -110,6 +110,31 @@ ApplicationWindow {
         onActivated: handleSpaceKey()
     }
 
+    // Покадровый шаг и скорость воспроизведения
+    Shortcut {
+        sequence: ","
+        enabled: controller.logMode && controller.logLoaded
+        onActivated: controller.stepLog(-1)
+    }
+
+    Shortcut {
+        sequence: "."
+        enabled: controller.logMode && controller.logLoaded
+        onActivated: controller.stepLog(1)
+    }
+
+    Shortcut {
+        sequence: "["
+        enabled: controller.logMode && controller.logLoaded
+        onActivated: changePlaybackRate(-1)
+    }
+
+    Shortcut {
+        sequence: "]"
+        enabled: controller.logMode && controller.logLoaded
+        onActivated: changePlaybackRate(1)
+    }
+
     // Добавляем shortcut для меню (Esc закрывает меню)
     Shortcut {
         sequence: "Esc"
@@ -129,7 +154,7 @@ ApplicationWindow {
         currentFolder: StandardPaths.writableLocation(StandardPaths.DocumentsLocation) + "/MonitorHead/research"
 
         fileMode: FileDialog.OpenFile
-        nameFilters: ["Текстовые файлы (*.txt)", "Все файлы (*)"]
+        nameFilters: ["Исследования (*.txt *.mhs *.mha)", "Текстовые файлы (*.txt)", "Файлы сессии (*.mhs)", "Сжатые архивы (*.mha)", "Все файлы (*)"]
 
         onAccepted: {
             var filePath = selectedFile.toString();
@@ -923,6 +948,110 @@ ApplicationWindow {
                                              "Больше = плавнее анимация цифр, Меньше = меньше мелькания"
                             }
                         }
+
+                        // Плавное движение 3D-модели между записями при воспроизведении
+                        CheckBox {
+                            id: menuOrientationInterpolationCheck
+                            Layout.fillWidth: true
+                            text: "Плавное движение модели при воспроизведении"
+                            checked: controller.orientationInterpolation
+                            onToggled: controller.orientationInterpolation = checked
+
+                            contentItem: Text {
+                                text: menuOrientationInterpolationCheck.text
+                                color: "#cccccc"
+                                font.pixelSize: 12
+                                wrapMode: Text.WordWrap
+                                leftPadding: menuOrientationInterpolationCheck.indicator.width + menuOrientationInterpolationCheck.spacing
+                                verticalAlignment: Text.AlignVCenter
+                            }
+
+                            ToolTip.visible: tooltipsEnabled && hovered
+                            ToolTip.delay: 500
+                            ToolTip.text: "Положение головы рассчитывается на каждый кадр экрана\n" +
+                                          "между соседними записями, а не сменяется ступеньками\n" +
+                                          "с частотой датчика"
+                        }
+
+                        // Строка для задержки сглаживания в реальном времени
+                        RowLayout {
+                            Layout.fillWidth: true
+                            spacing: 5
+
+                            Text {
+                                text: "Сглаживание модели в реальном времени"
+                                color: "#cccccc"
+                                font.pixelSize: 12
+                                Layout.fillWidth: true
+                            }
+
+                            Text {
+                                text: menuLiveLatencySlider.value > 0 ? Math.round(menuLiveLatencySlider.value) + " мс" : "выкл"
+                                color: "#2196F3"
+                                font.pixelSize: 12
+                                font.bold: true
+                                Layout.preferredWidth: 50
+                                horizontalAlignment: Text.AlignRight
+                            }
+                        }
+
+                        // Контейнер для слайдера задержки
+                        Item {
+                            Layout.fillWidth: true
+                            Layout.preferredHeight: 24
+
+                            Slider {
+                                id: menuLiveLatencySlider
+                                anchors.fill: parent
+                                from: 0
+                                to: 100
+                                stepSize: 5
+                                value: controller.liveLatencyBudget
+                                snapMode: Slider.SnapAlways
+
+                                onMoved: {
+                                    controller.liveLatencyBudget = Math.round(value)
+                                }
+
+                                background: Rectangle {
+                                    color: "#3c3c3c"
+                                    radius: 2
+                                    height: 6
+                                    anchors.verticalCenter: parent.verticalCenter
+                                    anchors.left: parent.left
+                                    anchors.right: parent.right
+
+                                    Rectangle {
+                                        width: menuLiveLatencySlider.visualPosition * parent.width
+                                        height: parent.height
+                                        color: "#2196F3"
+                                        radius: 2
+                                    }
+                                }
+
+                                handle: Rectangle {
+                                    x: menuLiveLatencySlider.visualPosition * (menuLiveLatencySlider.availableWidth - width)
+                                    y: menuLiveLatencySlider.availableHeight / 2 - height / 2
+                                    width: 20
+                                    height: 20
+                                    radius: 10
+                                    color: menuLiveLatencySlider.pressed ? "#1976d2" : "#2196F3"
+                                    border.color: "#ffffff"
+                                    border.width: 2
+
+                                    scale: menuLiveLatencySlider.hovered ? 1.2 : 1.0
+                                    Behavior on scale {
+                                        NumberAnimation { duration: 150 }
+                                    }
+                                }
+
+                                ToolTip.visible: tooltipsEnabled && hovered
+                                ToolTip.text: "Задержка показа модели: " + Math.round(value) + " мс\n" +
+                                             "Модель показывает положение с этой задержкой и плавно\n" +
+                                             "движется между принятыми кадрами.\n" +
+                                             "0 = без задержки, последний кадр как есть"
+                            }
+                        }
                     }
                 }
             }
@@ -1096,6 +1225,166 @@ ApplicationWindow {
         }
     }
 
+    // ПАНЕЛЬ ЗАГРУЗКИ ИССЛЕДОВАНИЯ (файл разбирается в фоне, окно остаётся отзывчивым)
+    Rectangle {
+        id: loadingPanel
+        width: 420
+        height: 90
+        radius: 8
+        color: "#2d2d2d"
+        border.color: "#505050"
+        border.width: 1
+        anchors.horizontalCenter: parent.horizontalCenter
+        anchors.bottom: parent.bottom
+        anchors.bottomMargin: 40
+        visible: controller.loading
+        z: 998
+
+        ColumnLayout {
+            anchors.fill: parent
+            anchors.margins: 12
+            spacing: 8
+
+            RowLayout {
+                Layout.fillWidth: true
+
+                Text {
+                    Layout.fillWidth: true
+                    text: "Загрузка исследования... " + Math.round(controller.loadProgress * 100) + "%"
+                    color: "white"
+                    font.pixelSize: 14
+                }
+
+                Rectangle {
+                    width: 90
+                    height: 28
+                    radius: 4
+                    color: cancelLoadingMouseArea.pressed ? buttonPressed :
+                           (cancelLoadingMouseArea.containsMouse ? buttonHover : buttonNormal)
+
+                    Text {
+                        anchors.centerIn: parent
+                        text: "Отменить"
+                        color: "white"
+                        font.pixelSize: 13
+                    }
+
+                    MouseArea {
+                        id: cancelLoadingMouseArea
+                        anchors.fill: parent
+                        hoverEnabled: true
+                        cursorShape: Qt.PointingHandCursor
+                        onClicked: controller.cancelLogLoading()
+                    }
+                }
+            }
+
+            ProgressBar {
+                Layout.fillWidth: true
+                from: 0
+                to: 1
+                value: controller.loadProgress
+            }
+        }
+    }
+
+    // КАТАЛОГ ИССЛЕДОВАНИЙ
+    Popup {
+        id: catalogDialog
+        width: Math.min(parent.width - 40, 760)
+        height: Math.min(parent.height - 40, 520)
+        modal: true
+        focus: true
+        anchors.centerIn: parent
+        closePolicy: Popup.CloseOnEscape | Popup.CloseOnPressOutside
+
+        background: Rectangle {
+            color: "#2d2d2d"
+            radius: 8
+            border.color: "#444"
+            border.width: 2
+        }
+
+        contentItem: ColumnLayout {
+            spacing: 8
+
+            Text {
+                text: "Исследования: " + controller.researchCatalog.count +
+                      (controller.researchCatalog.scanning ? " (обновление...)" : "")
+                color: "#4CAF50"
+                font.pixelSize: 16
+                font.bold: true
+                Layout.alignment: Qt.AlignHCenter
+            }
+
+            ListView {
+                id: catalogList
+                Layout.fillWidth: true
+                Layout.fillHeight: true
+                clip: true
+                model: controller.researchCatalog
+                ScrollBar.vertical: ScrollBar { }
+
+                delegate: Rectangle {
+                    width: catalogList.width
+                    height: 44
+                    color: catalogRowMouseArea.containsMouse ? "#3d3d3d" : (index % 2 ? "#2d2d2d" : "#333")
+
+                    Row {
+                        anchors.verticalCenter: parent.verticalCenter
+                        anchors.left: parent.left
+                        anchors.leftMargin: 10
+                        spacing: 16
+
+                        Text {
+                            width: 70
+                            text: "№ " + researchNumber
+                            color: "white"
+                            font.pixelSize: 14
+                            font.bold: true
+                        }
+                        Text {
+                            width: 140
+                            text: recordedAt ? Qt.formatDateTime(recordedAt, "dd.MM.yyyy hh:mm") : "-"
+                            color: "#ccc"
+                            font.pixelSize: 13
+                        }
+                        Text {
+                            width: 80
+                            text: pending ? "..." : Formatters.formatTimeWithoutMs(duration, duration)
+                            color: "#ccc"
+                            font.pixelSize: 13
+                        }
+                        Text {
+                            width: 220
+                            text: pending ? "" :
+                                  "пациент: " + patientEpisodes + " (" + (patientDizziness / 1000).toFixed(0) + " с), " +
+                                  "врач: " + doctorEpisodes
+                            color: patientEpisodes > 0 || doctorEpisodes > 0 ? "#ff9800" : "#888"
+                            font.pixelSize: 13
+                        }
+                        Text {
+                            text: format
+                            color: "#888"
+                            font.pixelSize: 12
+                        }
+                    }
+
+                    MouseArea {
+                        id: catalogRowMouseArea
+                        anchors.fill: parent
+                        hoverEnabled: true
+                        cursorShape: Qt.PointingHandCursor
+                        onClicked: {
+                            catalogDialog.close()
+                            controller.loadLogFile(filePath)
+                        }
+                    }
+                }
+            }
+        }
+    }
+
     // ДИАЛОГ "О ПРОГРАММЕ"
     Popup {
         id: aboutDialog
@@ -1532,6 +1821,29 @@ ApplicationWindow {
                         }
                     }
 
+                    // Формат записи: текст или сжатый архив .mha
+                    CheckBox {
+                        id: compressedRecordingCheck
+                        text: "Сжатый\nархив"
+                        checked: controller.compressedRecording
+                        enabled: !controller.recording
+                        anchors.verticalCenter: parent.verticalCenter
+                        onToggled: controller.compressedRecording = checked
+
+                        contentItem: Text {
+                            text: compressedRecordingCheck.text
+                            color: compressedRecordingCheck.enabled ? "white" : "#888"
+                            font.pixelSize: 12
+                            leftPadding: compressedRecordingCheck.indicator.width + compressedRecordingCheck.spacing
+                            verticalAlignment: Text.AlignVCenter
+                        }
+
+                        ToolTip.visible: tooltipsEnabled && hovered
+                        ToolTip.delay: 500
+                        ToolTip.text: "Записывать исследование в сжатый архив .mha\n" +
+                                      "(в 7-8 раз меньше текстового файла, открывается так же)"
+                    }
+
                     // Кнопка калибровки
                     Rectangle {
                         id: calibrationButton
@@ -1713,6 +2025,45 @@ ApplicationWindow {
                             }
                         }
                     }
+
+                    // Кнопка каталога исследований
+                    Rectangle {
+                        width: 50
+                        height: 50
+                        radius: 6
+                        enabled: !recording
+                        anchors.verticalCenter: parent.verticalCenter
+                        color: catalogMouseArea.pressed ? "#5a5a5a" : (catalogMouseArea.containsMouse ? "#6a6a6a" : "#4a4a4a")
+
+                        Behavior on color {
+                            ColorAnimation { duration: 150 }
+                        }
+
+                        Text {
+                            anchors.centerIn: parent
+                            text: "📋"
+                            color: "white"
+                            font.pixelSize: 20
+                            horizontalAlignment: Text.AlignHCenter
+                        }
+
+                        MouseArea {
+                            id: catalogMouseArea
+                            anchors.fill: parent
+                            hoverEnabled: true
+                            cursorShape: enabled ? Qt.PointingHandCursor : Qt.ArrowCursor
+
+                            ToolTip.visible: tooltipsEnabled && containsMouse
+                            ToolTip.delay: 500
+                            ToolTip.text: "Каталог исследований"
+
+                            onClicked: {
+                                if (parent.enabled) {
+                                    catalogDialog.open()
+                                }
+                            }
+                        }
+                    }
                 }
 
                 // === ЦЕНТРАЛЬНАЯ ЧАСТЬ - ИНФОРМАЦИЯ О РЕЖИМЕ (АБСОЛЮТНО ПО ЦЕНТРУ) ===
@@ -1772,18 +2123,25 @@ ApplicationWindow {
                                 id: connectionTypeCombo
                                 Layout.fillWidth: true
                                 Layout.preferredHeight: 25
-                                model: ["WiFi", "COM-порт"]
-                                currentIndex: controller.connectionType === "WiFi" ? 0 : 1
+                                // Значения controller.connectionType в порядке пунктов списка
+                                property var connectionTypes: ["WiFi", "UDP", "COM"]
+                                model: ["WiFi", "UDP", "COM-порт"]
+                                currentIndex: Math.max(0, connectionTypes.indexOf(controller.connectionType))
                                 onActivated: {
-                                    var type = currentIndex === 0 ? "WiFi" : "COM"
+                                    var type = connectionTypes[currentIndex]
                                     controller.connectionType = type
                                     // Принудительно обновляем видимость панелей после смены
                                     Qt.callLater(function() {
                                         comPortSettings.visible = (type === "COM")
-                                        wifiSettings.visible = (type === "WiFi")
+                                        wifiSettings.visible = (type === "WiFi" || type === "UDP")
                                     })
                                 }
 
+                                ToolTip.visible: tooltipsEnabled && hovered
+                                ToolTip.text: "WiFi - TCP, данные без потерь, но с задержками при повторах\n" +
+                                              "UDP - без повторов: потерянный отсчёт пропускается, изображение не замирает"
+
+
                                 Layout.minimumWidth: 80
                                 Layout.maximumWidth: 80
                                 Layout.preferredWidth: 80
@@ -1827,9 +2185,9 @@ ApplicationWindow {
 
                                 Component.onCompleted: {
                                     // Принудительно устанавливаем видимость панелей при запуске
-                                    var type = controller.connectionType === "WiFi" ? "WiFi" : "COM"
+                                    var type = controller.connectionType
                                     comPortSettings.visible = (type === "COM")
-                                    wifiSettings.visible = (type === "WiFi")
+                                    wifiSettings.visible = (type === "WiFi" || type === "UDP")
                                 }
                             }
                         }
@@ -2035,7 +2393,8 @@ ApplicationWindow {
                                                                     hoverEnabled: true
                                                                     cursorShape: Qt.PointingHandCursor
                                                                     onClicked: {
-                                                                        comPortCombo.updatePortsList();
+                                                                        // Список перечитывается в фоне и придёт через onAvailablePortsChanged
+                                                                        controller.refreshPorts();
                                                                     }
                                                                 }
 
@@ -2300,9 +2659,28 @@ ApplicationWindow {
                                         spacing: 6
                                         Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
 
+                                        // Цвет и подпись по состоянию менеджера подключения
+                                        property color stateColor: {
+                                            switch (controller.connectionState) {
+                                            case "connected": return "#4CAF50"
+                                            case "degraded": return "#ffc107"
+                                            case "connecting":
+                                            case "reconnecting": return "#ff9800"
+                                            default: return "#f44336"
+                                            }
+                                        }
+
                                         Text {
-                                            text: controller.connected ? "Подключен" : "Отключен"
-                                            color: controller.connected ? "#4CAF50" : "#f44336"
+                                            text: {
+                                                switch (controller.connectionState) {
+                                                case "connected": return "Подключен"
+                                                case "degraded": return "Нет данных"
+                                                case "connecting": return "Подключение..."
+                                                case "reconnecting": return "Переподключение..."
+                                                default: return "Отключен"
+                                                }
+                                            }
+                                            color: parent.stateColor
                                             font.pixelSize: 12
                                             font.bold: true
                                             Layout.alignment: Qt.AlignVCenter
@@ -2313,7 +2691,7 @@ ApplicationWindow {
                                             width: 8
                                             height: 8
                                             radius: 4
-                                            color: controller.connected ? "#4CAF50" : "#f44336"
+                                            color: parent.stateColor
                                             Layout.alignment: Qt.AlignVCenter
                                         }
                                     }
@@ -2346,7 +2724,8 @@ ApplicationWindow {
 
                                         Text {
                                             anchors.centerIn: parent
-                                            text: controller.connected ? "Отключить" : "Подключить"
+                                            text: controller.connected ? "Отключить" :
+                                                  (controller.connectionState === "connecting" ? "Отменить" : "Подключить")
                                             color: "white"
                                             font.pixelSize: 12
                                             font.bold: true
@@ -2893,6 +3272,59 @@ ApplicationWindow {
                             }
                         }
 
+                        // Кнопка "Кадр назад"
+                        Rectangle {
+                            id: stepBackButton
+                            Layout.preferredWidth: 40
+                            Layout.preferredHeight: 40
+                            radius: 4
+                            enabled: controller.logControlsEnabled && controller.logLoaded
+
+                            property color normalColor: enabled ? "#2196F3" : "#555"
+                            property color hoverColor: enabled ? "#42A5F5" : "#666"
+                            property color pressedColor: enabled ? "#1976D2" : "#444"
+
+                            color: {
+                                if (!enabled) return normalColor;
+                                if (stepBackMouseArea.pressed) {
+                                    return pressedColor
+                                } else if (stepBackMouseArea.containsMouse) {
+                                    return hoverColor
+                                } else {
+                                    return normalColor
+                                }
+                            }
+
+                            Behavior on color {
+                                ColorAnimation { duration: 150 }
+                            }
+
+                            Text {
+                                anchors.centerIn: parent
+                                text: "◀|"
+                                color: enabled ? "white" : "#888"
+                                font.pixelSize: 14
+                                horizontalAlignment: Text.AlignHCenter
+                                verticalAlignment: Text.AlignVCenter
+                            }
+
+                            MouseArea {
+                                id: stepBackMouseArea
+                                anchors.fill: parent
+                                hoverEnabled: true
+                                cursorShape: enabled ? Qt.PointingHandCursor : Qt.ArrowCursor
+                                onClicked: {
+                                    if (enabled) {
+                                        controller.stepLog(-1)
+                                    }
+                                }
+
+                                ToolTip.visible: tooltipsEnabled && containsMouse
+                                ToolTip.delay: 500
+                                ToolTip.text: "Кадр назад\n[ , ]"
+                            }
+                        }
+
                         // Кнопка Play/Pause (уже в правильном стиле) - оставляем как есть
                         Rectangle {
                             id: playPauseBtn
@@ -2946,6 +3378,59 @@ ApplicationWindow {
                             }
                         }
 
+                        // Кнопка "Кадр вперёд"
+                        Rectangle {
+                            id: stepForwardButton
+                            Layout.preferredWidth: 40
+                            Layout.preferredHeight: 40
+                            radius: 4
+                            enabled: controller.logControlsEnabled && controller.logLoaded
+
+                            property color normalColor: enabled ? "#2196F3" : "#555"
+                            property color hoverColor: enabled ? "#42A5F5" : "#666"
+                            property color pressedColor: enabled ? "#1976D2" : "#444"
+
+                            color: {
+                                if (!enabled) return normalColor;
+                                if (stepForwardMouseArea.pressed) {
+                                    return pressedColor
+                                } else if (stepForwardMouseArea.containsMouse) {
+                                    return hoverColor
+                                } else {
+                                    return normalColor
+                                }
+                            }
+
+                            Behavior on color {
+                                ColorAnimation { duration: 150 }
+                            }
+
+                            Text {
+                                anchors.centerIn: parent
+                                text: "|▶"
+                                color: enabled ? "white" : "#888"
+                                font.pixelSize: 14
+                                horizontalAlignment: Text.AlignHCenter
+                                verticalAlignment: Text.AlignVCenter
+                            }
+
+                            MouseArea {
+                                id: stepForwardMouseArea
+                                anchors.fill: parent
+                                hoverEnabled: true
+                                cursorShape: enabled ? Qt.PointingHandCursor : Qt.ArrowCursor
+                                onClicked: {
+                                    if (enabled) {
+                                        controller.stepLog(1)
+                                    }
+                                }
+
+                                ToolTip.visible: tooltipsEnabled && containsMouse
+                                ToolTip.delay: 500
+                                ToolTip.text: "Кадр вперёд\n[ . ]"
+                            }
+                        }
+
                         // Кнопка "Вперед на 5с"
                         Rectangle {
                             id: forwardButton
@@ -3105,6 +3590,91 @@ ApplicationWindow {
                                 ToolTip.text: "Остановить воспроизведение и вернуться в начало"
                             }
                         }
+
+                        // Направление воспроизведения
+                        Rectangle {
+                            id: reverseButton
+                            Layout.preferredWidth: 40
+                            Layout.preferredHeight: 40
+                            radius: 4
+                            enabled: controller.logControlsEnabled && controller.logLoaded
+
+                            property color normalColor: !enabled ? "#555" : (controller.playbackReverse ? "#ff9800" : "#2196F3")
+                            property color hoverColor: !enabled ? "#666" : (controller.playbackReverse ? "#ffa726" : "#42A5F5")
+                            property color pressedColor: !enabled ? "#444" : (controller.playbackReverse ? "#f57c00" : "#1976D2")
+
+                            color: {
+                                if (!enabled) return normalColor;
+                                if (reverseMouseArea.pressed) {
+                                    return pressedColor
+                                } else if (reverseMouseArea.containsMouse) {
+                                    return hoverColor
+                                } else {
+                                    return normalColor
+                                }
+                            }
+
+                            Behavior on color {
+                                ColorAnimation { duration: 150 }
+                            }
+
+                            Text {
+                                anchors.centerIn: parent
+                                text: controller.playbackReverse ? "◀" : "▶"
+                                color: enabled ? "white" : "#888"
+                                font.pixelSize: 14
+                                horizontalAlignment: Text.AlignHCenter
+                                verticalAlignment: Text.AlignVCenter
+                            }
+
+                            MouseArea {
+                                id: reverseMouseArea
+                                anchors.fill: parent
+                                hoverEnabled: true
+                                cursorShape: enabled ? Qt.PointingHandCursor : Qt.ArrowCursor
+                                onClicked: {
+                                    if (enabled) {
+                                        controller.playbackReverse = !controller.playbackReverse
+                                    }
+                                }
+
+                                ToolTip.visible: tooltipsEnabled && containsMouse
+                                ToolTip.delay: 500
+                                ToolTip.text: controller.playbackReverse ? "Воспроизведение назад\nнажмите для воспроизведения вперёд"
+                                                                         : "Воспроизведение вперёд\nнажмите для воспроизведения назад"
+                            }
+                        }
+
+                        // Скорость воспроизведения
+                        ComboBox {
+                            id: playbackRateCombo
+                            Layout.preferredWidth: 70
+                            Layout.preferredHeight: 40
+                            enabled: controller.logControlsEnabled && controller.logLoaded
+                            property var rates: [0.1, 0.25, 0.5, 1, 2, 4, 8, 16, 32]
+                            model: ["0.1x", "0.25x", "0.5x", "1x", "2x", "4x", "8x", "16x", "32x"]
+                            currentIndex: Math.max(0, rates.indexOf(controller.playbackRate))
+                            onActivated: controller.playbackRate = rates[currentIndex]
+
+                            background: Rectangle {
+                                color: playbackRateCombo.enabled ? "#3c3c3c" : "#555"
+                                radius: 4
+                                border.color: playbackRateCombo.activeFocus ? "#4caf50" : "#555"
+                                border.width: 1
+                            }
+
+                            contentItem: Text {
+                                text: playbackRateCombo.displayText
+                                color: playbackRateCombo.enabled ? "white" : "#888"
+                                font.pixelSize: 12
+                                horizontalAlignment: Text.AlignHCenter
+                                verticalAlignment: Text.AlignVCenter
+                            }
+
+                            ToolTip.visible: tooltipsEnabled && hovered
+                            ToolTip.delay: 500
+                            ToolTip.text: "Скорость воспроизведения\nклавиши [ и ] - медленнее и быстрее"
+                        }
                     }
                 }
 
@@ -3497,6 +4067,8 @@ ApplicationWindow {
             // Автоматически показываем соответствующие настройки
             if (type === "WiFi") {
                 showNotification("Режим WiFi активирован. Укажите IP-адрес и порт.", false)
+            } else if (type === "UDP") {
+                showNotification("Режим UDP активирован. Укажите IP-адрес устройства и порт приёма.", false)
             } else {
                 showNotification("Режим COM-порта активирован. Выберите порт.", false)
             }
@@ -3559,7 +4131,7 @@ ApplicationWindow {
 
             // Обновляем видимость панелей настроек
             comPortSettings.visible = (type === "COM")
-            wifiSettings.visible = (type === "WiFi")
+            wifiSettings.visible = (type === "WiFi" || type === "UDP")
 
             // Если переключились на COM-порт, обновляем список портов
             if (type === "COM" && comPortSettings.visible) {
@@ -3573,6 +4145,8 @@ ApplicationWindow {
             // Автоматически показываем соответствующие настройки
             if (type === "WiFi") {
                 showNotification("Режим WiFi активирован. Укажите IP-адрес и порт.", false)
+            } else if (type === "UDP") {
+                showNotification("Режим UDP активирован. Укажите IP-адрес устройства и порт приёма.", false)
             } else {
                 showNotification("Режим COM-порта активирован. Выберите порт.", false)
             }
@@ -3625,6 +4199,15 @@ ApplicationWindow {
             (seconds < 10 ? "0" + seconds : seconds)
     }
 
+    // Следующая или предыдущая скорость из списка воспроизведения
+    function changePlaybackRate(direction) {
+        var rates = playbackRateCombo.rates
+        var index = Math.max(0, rates.indexOf(controller.playbackRate))
+        index = Math.max(0, Math.min(rates.length - 1, index + direction))
+        controller.playbackRate = rates[index]
+        showNotification("Скорость воспроизведения: " + rates[index] + "x", false)
+    }
+
     // Функция для обработки клавиши пробела
     function handleSpaceKey() {
         // РЕЖИМ ВОСПРОИЗВЕДЕНИЯ: пробел работает как плей/пауза
@@ -3685,11 +4268,13 @@ ApplicationWindow {
         // Принудительно обновляем видимость панелей при запуске
         var type = controller.connectionType
         comPortSettings.visible = (type === "COM")
-        wifiSettings.visible = (type === "WiFi")
+        wifiSettings.visible = (type === "WiFi" || type === "UDP")
 
         // Показываем информацию о режиме по умолчанию
         if (type === "WiFi") {
             showNotification("Режим подключения по WiFi установлен по умолчанию", false)
+        } else if (type === "UDP") {
+            showNotification("Режим приёма по UDP", false)
         } else {
             showNotification("Режим подключения по COM-порту", false)
         }
@@ -0,0 +1,109 @@
+#include "angular_speed_channels.h"
+
+namespace {
+
+// Последняя запись со временем <= time, начиная с index (-1 - все записи позже).
+// Указатель ходит в обе стороны: при нечётном окне в мс конец окна у самого начала
+// записи может отступить на 1 мс
+int moveToTime(const SampleStore &samples, int index, qint64 time)
+{
+    const int n = samples.size();
+    while (index + 1 < n && samples.time(index + 1) <= time) {
+        ++index;
+    }
+    while (index >= 0 && samples.time(index) > time) {
+        --index;
+    }
+    return index;
+}
+
+// Скорость по концам окна - формула LogReader::calculateSimpleSpeed.
+// Пустое окно задаётся как first == last, duration = 1: изменение угла 0, скорость 0
+template <typename Angle>
+void fillSpeeds(float *speed, const Angle &angle, const int *first, const int *last,
+                const float *duration, int n)
+{
+    const float maxSpeed = 180.0f;
+
+    for (int i = 0; i < n; ++i) {
+        float angularChange = angle(last[i]) - angle(first[i]);
+
+        // Переход через ±180°
+        if (angularChange > 180.0f) {
+            angularChange -= 360.0f;
+        } else if (angularChange < -180.0f) {
+            angularChange += 360.0f;
+        }
+
+        speed[i] = qBound(-maxSpeed, angularChange / duration[i], maxSpeed);
+    }
+}
+
+} // namespace
+
+AngularSpeedChannels AngularSpeedChannels::compute(const SampleStore &samples, float windowSeconds,
+                                                   const std::atomic<bool> *cancelled)
+{
+    AngularSpeedChannels channels;
+    const int n = samples.size();
+    if (n == 0) {
+        return channels;
+    }
+
+    // Окно - как в LogReader::angularSpeedAt: симметричное вокруг записи,
+    // в начале файла [0, window], обрезанное по длительности файла
+    const qint64 windowMs = static_cast<qint64>(windowSeconds * 1000);
+    const qint64 halfWindowMs = windowMs / 2;
+    const qint64 fileDuration = samples.lastTime();
+
+    QVector<int> first(n);
+    QVector<int> last(n);
+    QVector<float> duration(n);     // Длительность окна, с
+
+    int startIndex = -1;
+    int endIndex = -1;
+    for (int i = 0; i < n; ++i) {
+        if ((i & 0xFFFF) == 0 && cancelled && cancelled->load(std::memory_order_relaxed)) {
+            return AngularSpeedChannels();
+        }
+
+        const qint64 time = samples.time(i);
+        const qint64 startTime = time < halfWindowMs ? 0 : time - halfWindowMs;
+        const qint64 endTime = qMin(fileDuration, time < halfWindowMs ? windowMs : time + halfWindowMs);
+
+        startIndex = moveToTime(samples, startIndex, startTime);
+        endIndex = moveToTime(samples, endIndex, endTime);
+
+        const qint64 timeDiff = startIndex >= 0 && endIndex > startIndex
+                                    ? samples.time(endIndex) - samples.time(startIndex) : 0;
+        if (timeDiff > 0) {
+            first[i] = startIndex;
+            last[i] = endIndex;
+            duration[i] = static_cast<float>(timeDiff) / 1000.0f;
+        } else {
+            first[i] = last[i] = 0;
+            duration[i] = 1.0f;
+        }
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        if (cancelled && cancelled->load(std::memory_order_relaxed)) {
+            return AngularSpeedChannels();
+        }
+
+        QVector<float> &speed = channels.m_speed[axis];
+        speed.resize(n);
+
+        const float *column = samples.angles(SampleStore::Axis(axis));
+        if (column) {
+            fillSpeeds(speed.data(), [column](int index) { return column[index]; },
+                       first.constData(), last.constData(), duration.constData(), n);
+        } else {
+            fillSpeeds(speed.data(), [&samples, axis](int index) { return samples.angle(SampleStore::Axis(axis), index); },
+                       first.constData(), last.constData(), duration.constData(), n);
+        }
+    }
+
+    channels.m_window = windowSeconds;
+    return channels;
+}
@@ -0,0 +1,39 @@
+#ifndef ANGULAR_SPEED_CHANNELS_H
+#define ANGULAR_SPEED_CHANNELS_H
+
+#include <QtCore/QVector>
+#include <QtCore/QtGlobal>
+#include <atomic>
+#include "sample_store.h"
+
+// Угловая скорость по каждой оси, посчитанная заранее для всех записей исследования
+// с одним окном сглаживания: те же значения, что LogReader::angularSpeedAt во время
+// каждой записи, но при воспроизведении скорость - просто элемент массива.
+// ОПТИМИЗАЦИЯ: с ростом времени записи окно только сдвигается вперёд, поэтому
+// границы всех окон находятся одним проходом двух указателей (O(n) на всё
+// исследование вместо двух двоичных поисков на запись), а сами скорости - отдельным
+// проходом без ветвлений по колонке каждой оси.
+// Память - 12 байт на запись (в 3-4 раза меньше текстового файла)
+class AngularSpeedChannels
+{
+public:
+    // Расчёт идёт в фоновом потоке; cancelled прерывает его (окно сменилось ещё раз),
+    // прерванный расчёт возвращает пустые каналы
+    static AngularSpeedChannels compute(const SampleStore &samples, float windowSeconds,
+                                        const std::atomic<bool> *cancelled = nullptr);
+
+    bool isEmpty() const { return m_speed[0].isEmpty(); }
+    int size() const { return m_speed[0].size(); }
+    float window() const { return m_window; }
+
+    // °/с во время записи index
+    float speed(SampleStore::Axis axis, int index) const { return m_speed[axis][index]; }
+
+    qint64 memoryUsage() const { return qint64(size()) * 3 * sizeof(float); }
+
+private:
+    float m_window = 0.0f;
+    QVector<float> m_speed[3];
+};
+
+#endif // ANGULAR_SPEED_CHANNELS_H
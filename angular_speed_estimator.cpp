@@ -0,0 +1,128 @@
+#include "angular_speed_estimator.h"
+
+AngularSpeedEstimator::AngularSpeedEstimator()
+    : m_points(Capacity)
+{
+}
+
+void AngularSpeedEstimator::clear()
+{
+    m_oldest = 0;
+    m_count = 0;
+    m_appendsSinceRebase = 0;
+    m_sumT = m_sumTT = 0.0;
+    for (int axis = 0; axis < 3; ++axis) {
+        m_sumA[axis] = m_sumTA[axis] = 0.0;
+    }
+}
+
+bool AngularSpeedEstimator::append(qint64 time, float pitch, float roll, float yaw)
+{
+    const float raw[3] = {pitch, roll, yaw};
+
+    if (m_count == 0) {
+        m_originTime = time;
+        for (int axis = 0; axis < 3; ++axis) {
+            m_lastAngle[axis] = 0.0;
+        }
+    } else {
+        if (time <= m_lastTime) {
+            return false;
+        }
+
+        // Переход через ±180° продолжает угол, а не даёт скачок на 360°
+        for (int axis = 0; axis < 3; ++axis) {
+            float change = raw[axis] - m_lastRaw[axis];
+            if (change > 180.0f) {
+                change -= 360.0f;
+            } else if (change < -180.0f) {
+                change += 360.0f;
+            }
+            m_lastAngle[axis] += change;
+        }
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        m_lastRaw[axis] = raw[axis];
+    }
+    m_lastTime = time;
+
+    if (m_count == Capacity) {
+        dropOldest();
+    }
+
+    Point &p = m_points[(m_oldest + m_count) & (Capacity - 1)];
+    p.time = static_cast<double>(time - m_originTime);
+    for (int axis = 0; axis < 3; ++axis) {
+        p.angle[axis] = m_lastAngle[axis];
+    }
+    m_count++;
+    add(p, 1.0);
+
+    // Кадры старше окна вытесняются
+    while (m_count > 1 && time - m_originTime - point(0).time > m_window) {
+        dropOldest();
+    }
+
+    if (++m_appendsSinceRebase >= Capacity) {
+        rebase();
+    }
+    return true;
+}
+
+float AngularSpeedEstimator::speed(SampleStore::Axis axis) const
+{
+    if (m_count < 2) {
+        return 0.0f;
+    }
+
+    // Наклон прямой МНК: (nΣta - ΣtΣa) / (nΣt² - (Σt)²), градусы в мс
+    const double n = m_count;
+    const double denominator = n * m_sumTT - m_sumT * m_sumT;
+    if (denominator <= 0.0) {
+        return 0.0f;
+    }
+    return static_cast<float>((n * m_sumTA[axis] - m_sumT * m_sumA[axis]) / denominator * 1000.0);
+}
+
+void AngularSpeedEstimator::add(const Point &p, double sign)
+{
+    m_sumT += sign * p.time;
+    m_sumTT += sign * p.time * p.time;
+    for (int axis = 0; axis < 3; ++axis) {
+        m_sumA[axis] += sign * p.angle[axis];
+        m_sumTA[axis] += sign * p.time * p.angle[axis];
+    }
+}
+
+void AngularSpeedEstimator::dropOldest()
+{
+    add(point(0), -1.0);
+    m_oldest = (m_oldest + 1) & (Capacity - 1);
+    m_count--;
+}
+
+void AngularSpeedEstimator::rebase()
+{
+    m_appendsSinceRebase = 0;
+
+    // Отсчёт времени и углов - от самого старого кадра окна: значения остаются
+    // небольшими, суммы считаются заново без накопленной ошибки
+    const Point origin = point(0);
+    m_originTime += static_cast<qint64>(origin.time);
+
+    m_sumT = m_sumTT = 0.0;
+    for (int axis = 0; axis < 3; ++axis) {
+        m_sumA[axis] = m_sumTA[axis] = 0.0;
+        m_lastAngle[axis] -= origin.angle[axis];
+    }
+
+    for (int age = 0; age < m_count; ++age) {
+        Point &p = m_points[(m_oldest + age) & (Capacity - 1)];
+        p.time -= origin.time;
+        for (int axis = 0; axis < 3; ++axis) {
+            p.angle[axis] -= origin.angle[axis];
+        }
+        add(p, 1.0);
+    }
+}
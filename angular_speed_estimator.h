@@ -0,0 +1,66 @@
+#ifndef ANGULAR_SPEED_ESTIMATOR_H
+#define ANGULAR_SPEED_ESTIMATOR_H
+
+#include <QtCore/QVector>
+#include <QtCore/QtGlobal>
+#include "sample_store.h"
+
+// Угловая скорость в реальном времени: наклон прямой, проведённой методом
+// наименьших квадратов через кадры за последние window мс, по каждой оси.
+// В отличие от разности первого и последнего кадра, в оценку входят все кадры
+// окна, поэтому шум датчика и дрожание меток времени сглаживаются сильнее при той
+// же задержке. Неравномерные интервалы между кадрами учитываются точно.
+// ОПТИМИЗАЦИЯ: кадры лежат в кольцевом буфере фиксированного размера, суммы для
+// наклона (Σt, Σt², Σa, Σta) обновляются при добавлении и вытеснении кадра -
+// O(1) на кадр, без сдвигов массива и выделений памяти. Раз в Capacity кадров
+// начало отсчёта переносится на самый старый кадр и суммы пересчитываются заново,
+// чтобы ошибка округления не накапливалась за многочасовую сессию
+class AngularSpeedEstimator
+{
+public:
+    static const int Capacity = 1024;       // Степень двойки; ~1 с при 1000 Гц
+
+    AngularSpeedEstimator();
+
+    void setWindow(qint64 windowMs) { m_window = qMax<qint64>(1, windowMs); }
+    qint64 window() const { return m_window; }
+
+    void clear();
+
+    // Кадр с временем не позже последнего не принимается (false)
+    bool append(qint64 time, float pitch, float roll, float yaw);
+
+    int count() const { return m_count; }
+
+    // °/с по кадрам окна; 0, пока в окне меньше двух кадров
+    float speed(SampleStore::Axis axis) const;
+
+private:
+    struct Point {
+        double time;        // мс от m_originTime
+        double angle[3];    // Углы без скачков на ±180°, от начала отсчёта
+    };
+
+    const Point &point(int age) const { return m_points[(m_oldest + age) & (Capacity - 1)]; }
+    void add(const Point &p, double sign);
+    void dropOldest();
+    void rebase();
+
+    QVector<Point> m_points;
+    int m_oldest = 0;
+    int m_count = 0;
+    int m_appendsSinceRebase = 0;
+    qint64 m_window = 500;
+
+    qint64 m_originTime = 0;
+    qint64 m_lastTime = 0;
+    float m_lastRaw[3] = {0.0f, 0.0f, 0.0f};
+    double m_lastAngle[3] = {0.0, 0.0, 0.0};
+
+    double m_sumT = 0.0;
+    double m_sumTT = 0.0;
+    double m_sumA[3] = {0.0, 0.0, 0.0};
+    double m_sumTA[3] = {0.0, 0.0, 0.0};
+};
+
+#endif // ANGULAR_SPEED_ESTIMATOR_H
@@ -0,0 +1,175 @@
+#include "connection_manager.h"
+#include <QDebug>
+#include <QRandomGenerator>
+
+ConnectionManager::ConnectionManager(QObject *parent) : QObject(parent)
+{
+    m_retryTimer.setSingleShot(true);
+    connect(&m_retryTimer, &QTimer::timeout, this, &ConnectionManager::retry);
+
+    // Поток данных проверяется 4 раза в секунду - этого хватает для порогов в секундах
+    m_watchdogTimer.setInterval(250);
+    connect(&m_watchdogTimer, &QTimer::timeout, this, &ConnectionManager::checkDataFlow);
+}
+
+QString ConnectionManager::stateName() const
+{
+    switch (m_state) {
+    case Connecting:
+        return "connecting";
+    case Connected:
+        return "connected";
+    case Degraded:
+        return "degraded";
+    case Reconnecting:
+        return "reconnecting";
+    case Disconnected:
+    default:
+        return "disconnected";
+    }
+}
+
+void ConnectionManager::start()
+{
+    m_retryTimer.stop();
+    m_watchdogTimer.stop();
+    m_attempt = 0;
+
+    setState(Connecting);
+    m_resumeRequested = false;
+    emit openRequested(false);
+}
+
+void ConnectionManager::stop()
+{
+    m_retryTimer.stop();
+    m_watchdogTimer.stop();
+    m_attempt = 0;
+
+    setState(Disconnected);
+}
+
+void ConnectionManager::handleOpened()
+{
+    if (m_state != Connecting && m_state != Reconnecting) {
+        return;
+    }
+
+    const bool reconnected = (m_state == Reconnecting);
+    const int attempts = m_attempt;
+
+    m_attempt = 0;
+    m_lastData.start();
+    m_watchdogTimer.start();
+    setState(Connected);
+
+    // После паузы дольше ResumeWindowMs транспорт открывался без продолжения сессии
+    if (reconnected) {
+        if (m_resumeRequested) {
+            emit sessionResumed(attempts);
+        } else {
+            emit sessionRestarted(attempts);
+        }
+    }
+}
+
+void ConnectionManager::handleOpenFailed(const QString &errorString)
+{
+    if (m_state == Connecting) {
+        // Первое подключение не повторяем: скорее всего неверный адрес или порт
+        setState(Disconnected);
+        emit connectFailed(errorString);
+        return;
+    }
+
+    if (m_state == Reconnecting) {
+        qDebug() << "Reconnect attempt" << m_attempt << "failed:" << errorString;
+        scheduleRetry();
+    }
+}
+
+void ConnectionManager::handleLinkLost(const QString &reason)
+{
+    if (!isLinkUp()) {
+        return;
+    }
+
+    m_watchdogTimer.stop();
+    m_attempt = 0;
+    m_lostSince.start();
+    setState(Reconnecting);
+
+    emit linkLost(reason);
+    scheduleRetry();
+}
+
+void ConnectionManager::handleDataReceived()
+{
+    m_lastData.start();
+
+    if (m_state == Degraded) {
+        setState(Connected);
+    }
+}
+
+void ConnectionManager::retryNow()
+{
+    if (m_state == Reconnecting && m_retryTimer.isActive()) {
+        m_retryTimer.stop();
+        retry();
+    }
+}
+
+void ConnectionManager::checkDataFlow()
+{
+    if (!isLinkUp()) {
+        return;
+    }
+
+    const qint64 silence = m_lastData.elapsed();
+
+    if (silence >= LostAfterMs) {
+        // UDP и "зависший" TCP сами о разрыве не сообщают
+        handleLinkLost("нет данных от устройства");
+    } else if (silence >= DegradedAfterMs) {
+        if (m_state == Connected) {
+            setState(Degraded);
+        }
+    }
+}
+
+void ConnectionManager::scheduleRetry()
+{
+    if (m_lostSince.elapsed() >= GiveUpAfterMs) {
+        stop();
+        emit gaveUp();
+        return;
+    }
+
+    // 250 мс, 500 мс, 1 с ... до 8 с, со случайной добавкой до четверти паузы,
+    // чтобы попытки не совпадали с периодическими помехами
+    const int exponent = qMin(m_attempt, 5);
+    int delay = qMin(InitialRetryMs << exponent, MaxRetryMs);
+    delay += QRandomGenerator::global()->bounded(delay / 4 + 1);
+
+    m_attempt++;
+    m_retryTimer.start(delay);
+}
+
+void ConnectionManager::retry()
+{
+    if (m_state != Reconnecting) {
+        return;
+    }
+
+    m_resumeRequested = m_lostSince.elapsed() < ResumeWindowMs;
+    emit openRequested(m_resumeRequested);
+}
+
+void ConnectionManager::setState(State state)
+{
+    if (m_state != state) {
+        m_state = state;
+        emit stateChanged(m_state);
+    }
+}
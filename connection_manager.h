@@ -0,0 +1,90 @@
+#ifndef CONNECTION_MANAGER_H
+#define CONNECTION_MANAGER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+
+// Состояние подключения к устройству и переподключение с нарастающей паузой.
+// Сам транспорт (COM, TCP, UDP) открывает контроллер по сигналу openRequested
+// и сообщает о результате через handleOpened/handleOpenFailed. Менеджер только
+// решает, когда пробовать снова и можно ли продолжить прерванную сессию.
+class ConnectionManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum State {
+        Disconnected,   // Нет сессии
+        Connecting,     // Первое подключение по команде пользователя
+        Connected,      // Данные идут
+        Degraded,       // Соединение есть, но данных нет дольше DegradedAfterMs
+        Reconnecting    // Связь потеряна, ждём следующей попытки или её результата
+    };
+    Q_ENUM(State)
+
+    static const int DegradedAfterMs = 1000;    // Пауза в данных - связь ухудшилась
+    static const int LostAfterMs = 5000;        // Пауза в данных - связь потеряна
+    static const int InitialRetryMs = 250;
+    static const int MaxRetryMs = 8000;
+    static const int ResumeWindowMs = 30000;    // Дольше - данные сессии уже не продолжить
+    static const int GiveUpAfterMs = 120000;
+
+    explicit ConnectionManager(QObject *parent = nullptr);
+
+    State state() const { return m_state; }
+    QString stateName() const;
+    int reconnectAttempts() const { return m_attempt; }
+
+    // Транспорт открыт и данные можно принимать
+    bool isLinkUp() const { return m_state == Connected || m_state == Degraded; }
+    // Сессия существует (включая паузу на переподключение)
+    bool hasSession() const { return m_state != Disconnected && m_state != Connecting; }
+
+public slots:
+    // Подключение по команде пользователя: новая сессия
+    void start();
+    // Отключение по команде пользователя или окончательная ошибка
+    void stop();
+
+    void handleOpened();
+    void handleOpenFailed(const QString &errorString);
+    // Транспорт сообщил о разрыве (ошибка порта, закрытие сокета)
+    void handleLinkLost(const QString &reason);
+    // Пришли данные - вызывается при каждой выборке непустой очереди
+    void handleDataReceived();
+    // Внешний признак, что связь можно восстановить (например, порт появился снова)
+    void retryNow();
+
+signals:
+    void stateChanged(ConnectionManager::State state);
+    // Открыть транспорт. resume = true - продолжить текущую сессию без сброса данных
+    void openRequested(bool resume);
+    // Разрыв: транспорт нужно закрыть до следующей попытки
+    void linkLost(const QString &reason);
+    void sessionResumed(int attempts);
+    // Связь вернулась после ResumeWindowMs: транспорт открыт как новая сессия
+    void sessionRestarted(int attempts);
+    // Первое подключение не удалось или переподключение так и не получилось
+    void connectFailed(const QString &errorString);
+    void gaveUp();
+
+private slots:
+    void checkDataFlow();
+    void retry();
+
+private:
+    void setState(State state);
+    void scheduleRetry();
+
+    State m_state = Disconnected;
+    int m_attempt = 0;
+    bool m_resumeRequested = false; // С каким resume запрошено последнее открытие
+
+    QTimer m_retryTimer;
+    QTimer m_watchdogTimer;
+    QElapsedTimer m_lastData;     // С последней порции данных
+    QElapsedTimer m_lostSince;    // С момента разрыва
+};
+
+#endif // CONNECTION_MANAGER_H
@@ -0,0 +1,19 @@
+#ifndef DATA_FRAME_H
+#define DATA_FRAME_H
+
+#include <QtCore/QtGlobal>
+
+// Структура для хранения одного кадра данных
+struct DataFrame {
+    qint64 timestamp;        // Время в мс
+    float pitch;             // Угол по pitch
+    float roll;              // Угол по roll
+    float yaw;               // Угол по yaw
+    bool patientDizziness;   // Головокружение пациента (0 или 1)
+    bool doctorDizziness;    // Головокружение врача (0 или 1)
+
+    DataFrame() : timestamp(0), pitch(0), roll(0), yaw(0),
+        patientDizziness(false), doctorDizziness(false) {}
+};
+
+#endif // DATA_FRAME_H
@@ -0,0 +1,192 @@
+#include "device_timebase.h"
+#include <QtMath>
+
+namespace {
+
+const double kForgetting = 0.998;          // Эффективное окно ~500 кадров
+const double kJitterAlpha = 0.02;          // Сглаживание оценки джиттера
+const double kMaxRateError = 0.005;        // Дрейф больше 5000 ppm считаем ошибкой оценки
+const double kMinLateSampleMs = 40.0;      // Кадр пришёл позже модели - задержан сетью
+const double kLateJitterFactor = 4.0;      // Порог задержки в единицах текущего джиттера
+const double kResyncMs = 2000.0;           // Кадр "раньше" модели на столько - часы устройства прыгнули
+const int kMaxConsecutiveLate = 300;       // Столько задержанных кадров подряд - модель устарела
+const int kMinSamplesForRate = 30;         // До этого дрейф не оцениваем
+const double kRebaseIntervalMs = 60000.0;  // Перенос начала отсчёта для точности сумм
+const qint64 kCounterPeriod = Q_INT64_C(1) << 32; // millis() на ESP32 - 32-битный
+const qint64 kMaxReorderMs = 500;          // Дольше датаграмма в пути не задерживается
+const int kRebootBackwardFrames = 5;       // Столько кадров подряд "в прошлом" - перезапуск устройства
+
+} // namespace
+
+DeviceTimebase::DeviceTimebase()
+{
+    reset();
+}
+
+void DeviceTimebase::reset()
+{
+    m_hasLastRaw = false;
+    m_lastRaw = 0;
+    m_wrapOffset = 0;
+    m_deviceOrigin = 0;
+    m_hostOrigin = 0.0;
+    m_sumW = m_sumX = m_sumY = m_sumXX = m_sumXY = 0.0;
+    m_samples = 0;
+    m_offset = 0.0;
+    m_rate = 1.0;
+    m_jitter = 0.0;
+    m_lastMapped = 0.0;
+    m_consecutiveLate = 0;
+    m_consecutiveBackward = 0;
+    m_resyncCount = 0;
+}
+
+qint64 DeviceTimebase::unwrap(qint64 deviceTime)
+{
+    if (m_hasLastRaw && deviceTime < m_lastRaw) {
+        // Переполнение счётчика: был у верхней границы, начался с нуля
+        m_wrapOffset += kCounterPeriod;
+    }
+
+    m_hasLastRaw = true;
+    m_lastRaw = deviceTime;
+    return deviceTime + m_wrapOffset;
+}
+
+void DeviceTimebase::restart(qint64 deviceTime, double arrivalTime)
+{
+    if (m_samples > 0) {
+        m_resyncCount++;
+    }
+
+    m_deviceOrigin = deviceTime;
+    // Новая шкала не должна уходить назад относительно уже выданных меток
+    m_hostOrigin = qMax(arrivalTime, m_lastMapped);
+    m_sumW = 1.0;
+    m_sumX = m_sumY = m_sumXX = m_sumXY = 0.0;
+    m_samples = 1;
+    m_offset = 0.0;
+    m_rate = 1.0;
+    m_consecutiveLate = 0;
+}
+
+void DeviceTimebase::updateFit()
+{
+    const double denominator = m_sumW * m_sumXX - m_sumX * m_sumX;
+
+    if (m_samples >= kMinSamplesForRate && denominator > 1e-6 * m_sumW * m_sumW) {
+        const double rate = (m_sumW * m_sumXY - m_sumX * m_sumY) / denominator;
+        m_rate = qBound(1.0 - kMaxRateError, rate, 1.0 + kMaxRateError);
+    }
+
+    m_offset = (m_sumY - m_rate * m_sumX) / m_sumW;
+}
+
+double DeviceTimebase::map(qint64 deviceTime, double arrivalTime, bool *late)
+{
+    if (late) {
+        *late = false;
+    }
+
+    // Шаг счётчика относительно предыдущего кадра с учётом переполнения
+    qint64 step = m_hasLastRaw ? deviceTime - m_lastRaw : 0;
+    if (step > kCounterPeriod / 2) {
+        step -= kCounterPeriod;
+    } else if (step < -kCounterPeriod / 2) {
+        step += kCounterPeriod;
+    }
+
+    if (step < 0 && -step <= kMaxReorderMs && m_samples > 0) {
+        // Кадр из прошлого: либо датаграмма обогнана следующими, либо устройство
+        // перезапустилось и считает заново. Обогнанный кадр по модели отправлен
+        // недавно и шёл не дольше kMaxReorderMs. После перезапуска счётчик отстаёт
+        // от модели ещё и на время загрузки, и такой кадр сбрасывает модель сразу
+        const double x = static_cast<double>(m_lastRaw + m_wrapOffset + step - m_deviceOrigin);
+        const double modelTime = m_hostOrigin + m_offset + m_rate * x;
+        const double delay = arrivalTime - modelTime;
+        if (delay <= kMaxReorderMs + kLateJitterFactor * m_jitter &&
+            ++m_consecutiveBackward < kRebootBackwardFrames) {
+            // Модель и развёртку счётчика не трогаем, время кадра - по текущей модели
+            if (late) {
+                *late = true;
+            }
+            return modelTime;
+        }
+    }
+
+    // Счётчик ушёл назад далеко, кадр пришёл слишком поздно для обогнанного
+    // или таких кадров несколько подряд - устройство перезапустилось
+    if (step < 0) {
+        m_consecutiveBackward = 0;
+        m_hasLastRaw = false;
+        m_wrapOffset = 0;
+        const qint64 device = unwrap(deviceTime);
+        restart(device, arrivalTime);
+        m_lastMapped = m_hostOrigin;
+        return m_lastMapped;
+    }
+
+    m_consecutiveBackward = 0;
+    const qint64 device = unwrap(deviceTime);
+
+    if (m_samples == 0) {
+        restart(device, arrivalTime);
+        m_lastMapped = m_hostOrigin;
+        return m_lastMapped;
+    }
+
+    double x = static_cast<double>(device - m_deviceOrigin);
+    double y = arrivalTime - m_hostOrigin;
+    const double residual = y - (m_offset + m_rate * x);
+
+    if (residual < -kResyncMs) {
+        // Время устройства убежало вперёд сильнее, чем прошло на компьютере
+        restart(device, arrivalTime);
+        m_lastMapped = m_hostOrigin;
+        return m_lastMapped;
+    }
+
+    if (residual > qMax(kMinLateSampleMs, kLateJitterFactor * m_jitter)) {
+        // Задержанный кадр (пачка после паузы в сети) не должен сдвигать модель,
+        // его время как раз и восстанавливается по часам устройства
+        if (++m_consecutiveLate > kMaxConsecutiveLate) {
+            restart(device, arrivalTime);
+            m_lastMapped = m_hostOrigin;
+            return m_lastMapped;
+        }
+    } else {
+        m_consecutiveLate = 0;
+
+        m_sumW = m_sumW * kForgetting + 1.0;
+        m_sumX = m_sumX * kForgetting + x;
+        m_sumY = m_sumY * kForgetting + y;
+        m_sumXX = m_sumXX * kForgetting + x * x;
+        m_sumXY = m_sumXY * kForgetting + x * y;
+        m_samples++;
+
+        updateFit();
+        m_jitter += kJitterAlpha * (qAbs(residual) - m_jitter);
+
+        // Переносим начало отсчёта, чтобы суммы квадратов не теряли точность
+        if (x > kRebaseIntervalMs) {
+            const double shiftX = x;
+            const double shiftY = m_offset + m_rate * x;
+            m_sumXX += -2.0 * shiftX * m_sumX + m_sumW * shiftX * shiftX;
+            m_sumXY += -shiftX * m_sumY - shiftY * m_sumX + m_sumW * shiftX * shiftY;
+            m_sumX -= m_sumW * shiftX;
+            m_sumY -= m_sumW * shiftY;
+            m_deviceOrigin = device;
+            m_hostOrigin += shiftY;
+            x = 0.0;
+            updateFit();
+        }
+    }
+
+    double mapped = m_hostOrigin + m_offset + m_rate * x;
+    if (mapped < m_lastMapped) {
+        mapped = m_lastMapped;
+    }
+
+    m_lastMapped = mapped;
+    return mapped;
+}
@@ -0,0 +1,67 @@
+#ifndef DEVICE_TIMEBASE_H
+#define DEVICE_TIMEBASE_H
+
+#include <QtCore/QtGlobal>
+
+// Пересчёт времени устройства во время компьютера.
+// Счётчик миллисекунд устройства точен относительно соседних кадров, но его
+// начало и скорость хода не совпадают с часами компьютера. Время прихода кадров,
+// наоборот, искажено задержками TCP, Nagle и паузами потоков. Поэтому по парам
+// (время устройства, время прихода) ведётся скользящая линейная регрессия
+// с экспоненциальным забыванием: host = offset + rate * device.
+// Наклон rate даёт дрейф часов устройства, разброс остатков - джиттер доставки.
+class DeviceTimebase
+{
+public:
+    DeviceTimebase();
+
+    void reset();
+
+    // Добавляет наблюдение и возвращает время кадра в шкале компьютера (мс).
+    // Кадр, время устройства которого немного раньше предыдущего и который по модели
+    // был в пути недолго, пришёл не по порядку (датаграммы UDP): модель он не меняет,
+    // *late = true, возвращается его время по модели. Иначе шаг счётчика назад -
+    // перезапуск устройства, модель начинается заново с этого кадра
+    double map(qint64 deviceTime, double arrivalTime, bool *late = nullptr);
+
+    // Оценка среднего отклонения времени прихода от модели, мс
+    double jitterMs() const { return m_jitter; }
+
+    // Дрейф часов устройства относительно компьютера, ppm (> 0 - устройство спешит)
+    double driftPpm() const { return (1.0 / m_rate - 1.0) * 1e6; }
+
+    // Количество перезапусков модели (сброс или скачок счётчика устройства)
+    int resyncCount() const { return m_resyncCount; }
+
+private:
+    qint64 unwrap(qint64 deviceTime);
+    void restart(qint64 deviceTime, double arrivalTime);
+    void updateFit();
+
+    // Развёртка переполнения счётчика
+    bool m_hasLastRaw = false;
+    qint64 m_lastRaw = 0;
+    qint64 m_wrapOffset = 0;
+
+    // Начало отсчёта модели (для численной устойчивости суммы ведутся от него)
+    qint64 m_deviceOrigin = 0;
+    double m_hostOrigin = 0.0;
+
+    // Взвешенные суммы регрессии
+    double m_sumW = 0.0;
+    double m_sumX = 0.0;
+    double m_sumY = 0.0;
+    double m_sumXX = 0.0;
+    double m_sumXY = 0.0;
+    int m_samples = 0;
+
+    double m_offset = 0.0;   // host - hostOrigin при x = 0
+    double m_rate = 1.0;     // скорость хода часов компьютера относительно устройства
+    double m_jitter = 0.0;
+    double m_lastMapped = 0.0;
+    int m_consecutiveLate = 0;
+    int m_consecutiveBackward = 0;  // Кадров подряд с временем раньше последнего
+    int m_resyncCount = 0;
+};
+
+#endif // DEVICE_TIMEBASE_H
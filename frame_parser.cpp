@@ -0,0 +1,220 @@
+#include "frame_parser.h"
+
+namespace {
+
+// Степени десяти для дробной части (до 9 знаков после запятой)
+const double kPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+const int kMaxFractionDigits = 9;
+// Больше 18 цифр не помещается в qint64 без переполнения - строка испорчена
+const int kMaxIntegerDigits = 18;
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline quint16 readUInt16(const char *p)
+{
+    return static_cast<quint16>(static_cast<quint8>(p[0]) |
+                                (static_cast<quint8>(p[1]) << 8));
+}
+
+inline quint32 readUInt32(const char *p)
+{
+    return static_cast<quint32>(static_cast<quint8>(p[0])) |
+           (static_cast<quint32>(static_cast<quint8>(p[1])) << 8) |
+           (static_cast<quint32>(static_cast<quint8>(p[2])) << 16) |
+           (static_cast<quint32>(static_cast<quint8>(p[3])) << 24);
+}
+
+// Таблица CRC-16/CCITT-FALSE (полином 0x1021)
+struct Crc16Table {
+    quint16 values[256];
+
+    Crc16Table()
+    {
+        for (int i = 0; i < 256; ++i) {
+            quint16 crc = static_cast<quint16>(i << 8);
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x8000) ? static_cast<quint16>((crc << 1) ^ 0x1021)
+                                     : static_cast<quint16>(crc << 1);
+            }
+            values[i] = crc;
+        }
+    }
+};
+
+const Crc16Table kCrc16Table;
+
+} // namespace
+
+bool FrameParser::parseInteger(const char *&pos, const char *end, qint64 &value)
+{
+    bool negative = false;
+    bool hasDigits = false;
+    int digits = 0;
+    qint64 result = 0;
+
+    for (; pos < end && *pos != ';'; ++pos) {
+        const char c = *pos;
+        if (isDigit(c)) {
+            if (++digits > kMaxIntegerDigits) {
+                return false;
+            }
+            result = result * 10 + (c - '0');
+            hasDigits = true;
+        } else if (c == '-') {
+            // Минус допустим только перед первой цифрой
+            if (hasDigits || negative) {
+                return false;
+            }
+            negative = true;
+        } else if (c == '.' || c == ',') {
+            return false;
+        }
+        // Прочие символы (пробелы, '\r', мусор на линии) пропускаем
+    }
+
+    if (!hasDigits) {
+        return false;
+    }
+
+    value = negative ? -result : result;
+    return true;
+}
+
+bool FrameParser::parseDecimal(const char *&pos, const char *end, float &value)
+{
+    bool negative = false;
+    bool hasDigits = false;
+    bool inFraction = false;
+    qint64 integerPart = 0;
+    int integerDigits = 0;
+    qint64 fractionPart = 0;
+    int fractionDigits = 0;
+
+    for (; pos < end && *pos != ';'; ++pos) {
+        const char c = *pos;
+        if (isDigit(c)) {
+            hasDigits = true;
+            if (!inFraction) {
+                if (++integerDigits > kMaxIntegerDigits) {
+                    return false;
+                }
+                integerPart = integerPart * 10 + (c - '0');
+            } else if (fractionDigits < kMaxFractionDigits) {
+                fractionPart = fractionPart * 10 + (c - '0');
+                fractionDigits++;
+            }
+        } else if (c == '.' || c == ',') {
+            if (inFraction) {
+                return false;
+            }
+            inFraction = true;
+        } else if (c == '-') {
+            if (hasDigits || negative || inFraction) {
+                return false;
+            }
+            negative = true;
+        }
+    }
+
+    if (!hasDigits) {
+        return false;
+    }
+
+    double result = static_cast<double>(integerPart) + fractionPart / kPow10[fractionDigits];
+    value = static_cast<float>(negative ? -result : result);
+    return true;
+}
+
+bool FrameParser::parseLine(const char *begin, const char *end, RawFrame &frame)
+{
+    const char *pos = begin;
+    qint64 patientButton = 0;
+    qint64 doctorButton = 0;
+
+    // Поля: время;pitch;roll;yaw;пациент;врач
+    if (!parseInteger(pos, end, frame.deviceTime) || pos == end) return false;
+    ++pos;
+    if (!parseDecimal(pos, end, frame.pitch) || pos == end) return false;
+    ++pos;
+    if (!parseDecimal(pos, end, frame.roll) || pos == end) return false;
+    ++pos;
+    if (!parseDecimal(pos, end, frame.yaw) || pos == end) return false;
+    ++pos;
+    if (!parseInteger(pos, end, patientButton) || pos == end) return false;
+    ++pos;
+    if (!parseInteger(pos, end, doctorButton)) return false;
+
+    // Лишние поля после шестого игнорируются
+    frame.patientDizziness = (patientButton == 1);
+    frame.doctorDizziness = (doctorButton == 1);
+    return true;
+}
+
+quint16 FrameParser::crc16(const char *data, int size)
+{
+    quint16 crc = 0xFFFF;
+    for (int i = 0; i < size; ++i) {
+        const quint8 index = static_cast<quint8>((crc >> 8) ^ static_cast<quint8>(data[i]));
+        crc = static_cast<quint16>((crc << 8) ^ kCrc16Table.values[index]);
+    }
+    return crc;
+}
+
+bool FrameParser::parsePacket(const char *packet, RawFrame &frame)
+{
+    // CRC считается по полезной нагрузке без синхрослова
+    const quint16 expectedCrc = readUInt16(packet + BinaryPacket::CrcOffset);
+    if (crc16(packet + 2, BinaryPacket::CrcOffset - 2) != expectedCrc) {
+        return false;
+    }
+
+    frame.sequence = readUInt16(packet + 2);
+    frame.hasSequence = true;
+    frame.deviceTime = readUInt32(packet + 4);
+    frame.pitch = static_cast<qint16>(readUInt16(packet + 8)) / 100.0f;
+    frame.roll = static_cast<qint16>(readUInt16(packet + 10)) / 100.0f;
+    frame.yaw = static_cast<qint16>(readUInt16(packet + 12)) / 100.0f;
+
+    const quint8 buttons = static_cast<quint8>(packet[14]);
+    frame.patientDizziness = (buttons & BinaryPacket::PatientButton) != 0;
+    frame.doctorDizziness = (buttons & BinaryPacket::DoctorButton) != 0;
+    return true;
+}
+
+bool FrameParser::isBlank(const char *begin, const char *end)
+{
+    for (const char *p = begin; p < end; ++p) {
+        if (*p != ' ' && *p != '\r' && *p != '\t' && *p != '\0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FrameParser::trackSequence(quint16 sequence)
+{
+    // Разрыв в нумерации - потерянные пакеты. Счётчик 16-битный, переполнение учитывается
+    if (m_hasSequence) {
+        const quint16 gap = static_cast<quint16>(sequence - m_expectedSequence);
+        // Большой "разрыв" назад - это повтор или перезапуск устройства, а не потеря
+        if (gap != 0 && gap < 0x8000) {
+            m_lostPackets += gap;
+        }
+    }
+
+    m_expectedSequence = static_cast<quint16>(sequence + 1);
+    m_hasSequence = true;
+}
+
+void FrameParser::reset()
+{
+    m_lastFormat = UnknownFormat;
+    m_hasSequence = false;
+    m_expectedSequence = 0;
+    m_lostPackets = 0;
+    m_rejectedPackets = 0;
+    m_rejectedLines = 0;
+}
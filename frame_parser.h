@@ -0,0 +1,167 @@
+#ifndef FRAME_PARSER_H
+#define FRAME_PARSER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QtGlobal>
+#include <cstring>
+
+// Кадр в том виде, в котором он пришёл от устройства (без калибровки и нормализации)
+struct RawFrame {
+    qint64 deviceTime;       // Счётчик миллисекунд устройства
+    float pitch;
+    float roll;
+    float yaw;
+    bool patientDizziness;
+    bool doctorDizziness;
+    quint16 sequence;        // Номер пакета (только в бинарном формате)
+    bool hasSequence;
+
+    RawFrame() : deviceTime(0), pitch(0), roll(0), yaw(0),
+        patientDizziness(false), doctorDizziness(false),
+        sequence(0), hasSequence(false) {}
+};
+
+// Бинарный пакет устройства (little-endian, 17 байт):
+//   0..1   синхрослово 0xA5 0x5A
+//   2..3   quint16 номер пакета
+//   4..7   quint32 время устройства, мс
+//   8..13  qint16 pitch, roll, yaw в сотых долях градуса
+//   14     кнопки: бит 0 - пациент, бит 1 - врач
+//   15..16 CRC-16/CCITT-FALSE по байтам 2..14
+namespace BinaryPacket {
+const quint8 Sync0 = 0xA5;
+const quint8 Sync1 = 0x5A;
+const int Size = 17;
+const int CrcOffset = 15;
+const quint8 PatientButton = 0x01;
+const quint8 DoctorButton = 0x02;
+}
+
+// Потоковый разбор данных устройства. Поддерживаются два формата, которые
+// определяются автоматически для каждого кадра:
+//  - текстовые строки "0000000009;-111,80;12.5;0.75;0;1";
+//  - бинарные пакеты BinaryPacket с номером и CRC.
+// Данные разбираются прямо в приёмном буфере, без промежуточных QByteArray/QString,
+// поэтому на один кадр не приходится ни одного выделения памяти.
+class FrameParser
+{
+public:
+    enum StreamFormat {
+        UnknownFormat,
+        AsciiFormat,
+        BinaryFormat
+    };
+
+    // Разбирает одну строку [begin, end). Десятичный разделитель - '.' или ','.
+    // Посторонние символы внутри полей игнорируются (как раньше делала очистка регуляркой)
+    static bool parseLine(const char *begin, const char *end, RawFrame &frame);
+
+    // Разбирает бинарный пакет длиной BinaryPacket::Size (синхрослово уже проверено)
+    static bool parsePacket(const char *packet, RawFrame &frame);
+
+    static quint16 crc16(const char *data, int size);
+
+    // Разбирает все завершённые кадры буфера (не более maxFrames) и для каждого
+    // корректного кадра вызывает onFrame(const RawFrame &).
+    // Обработанные байты удаляются из начала буфера одним вызовом remove().
+    // Возвращает количество обработанных кадров (включая отброшенные)
+    template <typename Callback>
+    int consume(QByteArray &buffer, int maxFrames, Callback &&onFrame);
+
+    // Сброс состояния при новом подключении
+    void reset();
+
+    StreamFormat lastFormat() const { return m_lastFormat; }
+    quint64 lostPackets() const { return m_lostPackets; }
+    quint64 rejectedFrames() const { return m_rejectedPackets + m_rejectedLines; }
+    // Бинарные пакеты с неверной CRC и ложные синхрослова
+    quint64 rejectedPackets() const { return m_rejectedPackets; }
+    // Текстовые строки, которые не удалось разобрать, и обрывки строк перед синхрословом
+    quint64 rejectedLines() const { return m_rejectedLines; }
+
+private:
+    static bool parseInteger(const char *&pos, const char *end, qint64 &value);
+    static bool parseDecimal(const char *&pos, const char *end, float &value);
+    static bool isBlank(const char *begin, const char *end);
+
+    void trackSequence(quint16 sequence);
+
+    StreamFormat m_lastFormat = UnknownFormat;
+    bool m_hasSequence = false;
+    quint16 m_expectedSequence = 0;
+    quint64 m_lostPackets = 0;
+    quint64 m_rejectedPackets = 0;
+    quint64 m_rejectedLines = 0;
+};
+
+template <typename Callback>
+int FrameParser::consume(QByteArray &buffer, int maxFrames, Callback &&onFrame)
+{
+    const char *data = buffer.constData();
+    const qsizetype size = buffer.size();
+    qsizetype pos = 0;
+    int processedFrames = 0;
+
+    while (processedFrames < maxFrames && pos < size) {
+        const char *begin = data + pos;
+
+        if (static_cast<quint8>(*begin) == BinaryPacket::Sync0) {
+            if (size - pos < BinaryPacket::Size) {
+                break; // Пакет пришёл не целиком
+            }
+
+            RawFrame frame;
+            if (static_cast<quint8>(begin[1]) == BinaryPacket::Sync1 && parsePacket(begin, frame)) {
+                pos += BinaryPacket::Size;
+                processedFrames++;
+                m_lastFormat = BinaryFormat;
+                trackSequence(frame.sequence);
+                onFrame(frame);
+            } else {
+                // Ложное синхрослово или повреждённый пакет: сдвигаемся на байт и ищем дальше
+                pos++;
+                processedFrames++;
+                m_rejectedPackets++;
+            }
+            continue;
+        }
+
+        // Текстовая строка заканчивается переводом строки. Если раньше встретилось
+        // синхрослово, значит это обрывок, а дальше идёт бинарный пакет
+        const char *newline = static_cast<const char *>(std::memchr(begin, '\n', size - pos));
+        const qsizetype searchLength = newline ? (newline - begin) : (size - pos);
+        const char *sync = static_cast<const char *>(std::memchr(begin, BinaryPacket::Sync0, searchLength));
+
+        if (sync) {
+            pos = sync - data;
+            processedFrames++;
+            if (!isBlank(begin, sync)) {
+                m_rejectedLines++;
+            }
+            continue;
+        }
+
+        if (!newline) {
+            break; // Строка пришла не целиком
+        }
+
+        pos = (newline - data) + 1;
+        processedFrames++;
+
+        RawFrame frame;
+        if (parseLine(begin, newline, frame)) {
+            m_lastFormat = AsciiFormat;
+            onFrame(frame);
+        } else if (!isBlank(begin, newline)) {
+            m_rejectedLines++;
+        }
+    }
+
+    if (pos > 0) {
+        buffer.remove(0, pos);
+    }
+
+    return processedFrames;
+}
+
+#endif // FRAME_PARSER_H
@@ -0,0 +1,528 @@
+// Эмулятор шлема MonitorHead.
+// Отдаёт поток кадров в том же виде, что и ESP32: текстовые строки
+// "0000000009;-111.80;12.50;0.75;0;1" или бинарные пакеты BinaryPacket.
+// Источник - файлы исследований Research_*.txt или синтетическое движение головы.
+// Транспорт - TCP-сервер (порт 8080 как у m_wifiPort), UDP и псевдотерминал Linux,
+// который открывается программой как обычный COM-порт.
+//
+// Пример: MonitorHeadEmulator --tcp --pty --rate 500 --burst 10 --jitter 20 --loss 1
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+#include <QtCore/QtMath>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "frame_parser.h"
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace {
+
+struct Sample {
+    float pitch = 0;
+    float roll = 0;
+    float yaw = 0;
+    bool patientDizziness = false;
+    bool doctorDizziness = false;
+};
+
+// Загрузка углов из файла исследования (время файла не используется - темп задаёт --rate)
+bool loadResearchFile(const QString &fileName, QVector<Sample> &samples)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        fprintf(stderr, "Cannot open %s\n", qPrintable(fileName));
+        return false;
+    }
+
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        const QByteArray bytes = line.toLatin1();
+        RawFrame frame;
+        if (!FrameParser::parseLine(bytes.constData(), bytes.constData() + bytes.size(), frame)) {
+            continue;
+        }
+
+        Sample sample;
+        sample.pitch = frame.pitch;
+        sample.roll = frame.roll;
+        sample.yaw = frame.yaw;
+        sample.patientDizziness = frame.patientDizziness;
+        sample.doctorDizziness = frame.doctorDizziness;
+        samples.append(sample);
+    }
+
+    return true;
+}
+
+// Синтетическое движение: медленные повороты головы с мелкой дрожью
+// и редкими нажатиями кнопок головокружения
+Sample syntheticSample(double seconds)
+{
+    Sample sample;
+    sample.pitch = static_cast<float>(25.0 * qSin(2.0 * M_PI * 0.11 * seconds) + 0.3 * qSin(2.0 * M_PI * 7.0 * seconds));
+    sample.roll = static_cast<float>(15.0 * qSin(2.0 * M_PI * 0.07 * seconds + 1.0));
+    sample.yaw = static_cast<float>(60.0 * qSin(2.0 * M_PI * 0.05 * seconds + 2.0));
+    sample.patientDizziness = std::fmod(seconds, 40.0) > 30.0;
+    sample.doctorDizziness = std::fmod(seconds, 60.0) > 55.0;
+    return sample;
+}
+
+void appendUInt16(QByteArray &out, quint16 value)
+{
+    out.append(static_cast<char>(value & 0xFF));
+    out.append(static_cast<char>(value >> 8));
+}
+
+void appendUInt32(QByteArray &out, quint32 value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out.append(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+} // namespace
+
+class HeadsetEmulator : public QObject
+{
+public:
+    struct Options {
+        QVector<Sample> samples;        // Пусто - синтетическое движение
+        bool loop = true;
+        bool binary = false;
+        double rate = 100.0;            // Кадров в секунду
+        int burst = 1;                  // Кадров в одной записи/датаграмме
+        double jitterMs = 0.0;          // Случайная задержка отправки пачки
+        double lossPercent = 0.0;       // Пропуск кадра (номер пакета при этом растёт)
+        double corruptPercent = 0.0;    // Порча одного байта кадра
+        double durationSec = 0.0;       // 0 - без ограничения
+    };
+
+    explicit HeadsetEmulator(const Options &options, QObject *parent = nullptr)
+        : QObject(parent), m_options(options)
+    {
+        m_tickTimer.setTimerType(Qt::PreciseTimer);
+        m_tickTimer.setInterval(1);
+        connect(&m_tickTimer, &QTimer::timeout, this, [this]() { tick(); });
+
+        m_reportTimer.setInterval(1000);
+        connect(&m_reportTimer, &QTimer::timeout, this, [this]() { report(); });
+    }
+
+    bool listenTcp(quint16 port)
+    {
+        m_tcpServer = new QTcpServer(this);
+        connect(m_tcpServer, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket *client = m_tcpServer->nextPendingConnection()) {
+                client->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+                m_tcpClients.append(client);
+                connect(client, &QTcpSocket::disconnected, this, [this, client]() {
+                    m_tcpClients.removeAll(client);
+                    client->deleteLater();
+                });
+                fprintf(stderr, "TCP client connected: %s\n", qPrintable(client->peerAddress().toString()));
+            }
+        });
+
+        if (!m_tcpServer->listen(QHostAddress::Any, port)) {
+            fprintf(stderr, "TCP listen on %u failed: %s\n", port, qPrintable(m_tcpServer->errorString()));
+            return false;
+        }
+
+        fprintf(stderr, "TCP: listening on port %u\n", port);
+        return true;
+    }
+
+    // Датаграммы уходят на target (если задан) и на каждого, кто прислал приветствие
+    bool openUdp(quint16 localPort, const QHostAddress &target, quint16 targetPort)
+    {
+        m_udpSocket = new QUdpSocket(this);
+        if (!m_udpSocket->bind(QHostAddress::AnyIPv4, localPort)) {
+            fprintf(stderr, "UDP bind on %u failed: %s\n", localPort, qPrintable(m_udpSocket->errorString()));
+            return false;
+        }
+
+        if (!target.isNull()) {
+            m_udpTargets.append(qMakePair(target, targetPort));
+        }
+
+        connect(m_udpSocket, &QUdpSocket::readyRead, this, [this]() {
+            while (m_udpSocket->hasPendingDatagrams()) {
+                QHostAddress sender;
+                quint16 senderPort = 0;
+                char buffer[64];
+                m_udpSocket->readDatagram(buffer, sizeof(buffer), &sender, &senderPort);
+                const auto peer = qMakePair(sender, senderPort);
+                if (!m_udpTargets.contains(peer)) {
+                    m_udpTargets.append(peer);
+                    fprintf(stderr, "UDP subscriber: %s:%u\n", qPrintable(sender.toString()), senderPort);
+                }
+            }
+        });
+
+        fprintf(stderr, "UDP: bound to port %u\n", m_udpSocket->localPort());
+        return true;
+    }
+
+    bool openPty()
+    {
+#ifdef Q_OS_LINUX
+        m_ptyMaster = ::posix_openpt(O_RDWR | O_NOCTTY);
+        if (m_ptyMaster < 0 || ::grantpt(m_ptyMaster) != 0 || ::unlockpt(m_ptyMaster) != 0) {
+            perror("pty");
+            return false;
+        }
+
+        // Без эха и преобразования перевода строки - байты идут как есть
+        termios settings;
+        if (::tcgetattr(m_ptyMaster, &settings) == 0) {
+            ::cfmakeraw(&settings);
+            ::tcsetattr(m_ptyMaster, TCSANOW, &settings);
+        }
+
+        // Пока программа не открыла порт, запись не должна блокировать эмулятор
+        ::fcntl(m_ptyMaster, F_SETFL, ::fcntl(m_ptyMaster, F_GETFL) | O_NONBLOCK);
+
+        fprintf(stderr, "PTY: %s (open it as a COM port)\n", ::ptsname(m_ptyMaster));
+        return true;
+#else
+        fprintf(stderr, "PTY is only supported on Linux\n");
+        return false;
+#endif
+    }
+
+    void start()
+    {
+        m_clock.start();
+        m_tickTimer.start();
+        m_reportTimer.start();
+    }
+
+private:
+    struct PendingBurst {
+        double releaseMs;
+        QByteArray data;
+    };
+
+    void tick()
+    {
+        if (m_finished) {
+            return;
+        }
+
+        const double nowMs = m_clock.nsecsElapsed() / 1e6;
+
+        if (m_options.durationSec > 0 && nowMs >= m_options.durationSec * 1000.0) {
+            finish();
+            return;
+        }
+
+        // Кадры набираются строго по расписанию --rate, независимо от точности таймера
+        const qint64 due = static_cast<qint64>(nowMs * m_options.rate / 1000.0);
+        while (m_generated < due && !m_finished) {
+            const double frameTimeMs = m_generated * 1000.0 / m_options.rate;
+            appendFrame(frameTimeMs);
+            m_generated++;
+
+            if (m_burstFrames >= m_options.burst) {
+                queueBurst(frameTimeMs);
+            }
+        }
+
+        // Отправляем пачки, чьё время (с учётом джиттера) подошло
+        while (!m_pending.isEmpty() && m_pending.first().releaseMs <= nowMs) {
+            sendStream(m_pending.first().data);
+            m_pending.removeFirst();
+        }
+        while (!m_pendingDatagrams.isEmpty() && m_pendingDatagrams.first().releaseMs <= nowMs) {
+            sendDatagram(m_pendingDatagrams.first().data);
+            m_pendingDatagrams.removeFirst();
+        }
+    }
+
+    void appendFrame(double frameTimeMs)
+    {
+        Sample sample;
+        if (m_options.samples.isEmpty()) {
+            sample = syntheticSample(frameTimeMs / 1000.0);
+        } else {
+            if (m_sampleIndex >= m_options.samples.size()) {
+                if (!m_options.loop) {
+                    finish();
+                    return;
+                }
+                m_sampleIndex = 0;
+            }
+            sample = m_options.samples.at(m_sampleIndex++);
+        }
+
+        const quint16 sequence = m_sequence++;
+        if (chance(m_options.lossPercent)) {
+            m_dropped++;
+            return;
+        }
+
+        const quint32 deviceTime = static_cast<quint32>(frameTimeMs);
+        const qsizetype frameStart = m_burstData.size();
+
+        if (m_options.binary) {
+            m_burstData.append(static_cast<char>(BinaryPacket::Sync0));
+            m_burstData.append(static_cast<char>(BinaryPacket::Sync1));
+            appendUInt16(m_burstData, sequence);
+            appendUInt32(m_burstData, deviceTime);
+            appendUInt16(m_burstData, static_cast<quint16>(qRound(sample.pitch * 100.0f)));
+            appendUInt16(m_burstData, static_cast<quint16>(qRound(sample.roll * 100.0f)));
+            appendUInt16(m_burstData, static_cast<quint16>(qRound(sample.yaw * 100.0f)));
+            quint8 buttons = 0;
+            if (sample.patientDizziness) buttons |= BinaryPacket::PatientButton;
+            if (sample.doctorDizziness) buttons |= BinaryPacket::DoctorButton;
+            m_burstData.append(static_cast<char>(buttons));
+            appendUInt16(m_burstData, FrameParser::crc16(m_burstData.constData() + frameStart + 2,
+                                                         BinaryPacket::CrcOffset - 2));
+        } else {
+            // Формат прошивки: время с ведущими нулями, углы с двумя знаками
+            char line[96];
+            const int length = std::snprintf(line, sizeof(line), "%010u;%.2f;%.2f;%.2f;%d;%d\n",
+                                             deviceTime, sample.pitch, sample.roll, sample.yaw,
+                                             sample.patientDizziness ? 1 : 0, sample.doctorDizziness ? 1 : 0);
+            m_burstData.append(line, length);
+        }
+
+        if (chance(m_options.corruptPercent)) {
+            // Портим один байт кадра, кроме перевода строки, чтобы не склеить соседние строки
+            const qsizetype frameSize = m_burstData.size() - frameStart - (m_options.binary ? 0 : 1);
+            const qsizetype offset = frameStart + QRandomGenerator::global()->bounded(static_cast<int>(frameSize));
+            m_burstData[offset] = static_cast<char>(m_burstData.at(offset) ^ 0x5A);
+            m_corrupted++;
+        }
+
+        m_burstFrames++;
+        m_sent++;
+    }
+
+    double jitteredTime(double frameTimeMs) const
+    {
+        if (m_options.jitterMs <= 0) {
+            return frameTimeMs;
+        }
+        return frameTimeMs + QRandomGenerator::global()->generateDouble() * m_options.jitterMs;
+    }
+
+    void queueBurst(double frameTimeMs)
+    {
+        m_bytes += m_burstData.size();
+
+        if (m_tcpServer || m_ptyMaster >= 0) {
+            // В потоке байтов задержанная пачка задерживает и следующие (как при повторе в TCP)
+            double releaseMs = jitteredTime(frameTimeMs);
+            if (!m_pending.isEmpty()) {
+                releaseMs = qMax(releaseMs, m_pending.last().releaseMs);
+            }
+            m_pending.append({releaseMs, m_burstData});
+        }
+
+        if (m_udpSocket) {
+            // Датаграммы задерживаются независимо и могут обогнать друг друга -
+            // так проверяется окно перестановки пакетов в программе
+            const PendingBurst datagram{jitteredTime(frameTimeMs), m_burstData};
+            const auto position = std::upper_bound(m_pendingDatagrams.begin(), m_pendingDatagrams.end(), datagram,
+                                                   [](const PendingBurst &a, const PendingBurst &b) {
+                                                       return a.releaseMs < b.releaseMs;
+                                                   });
+            m_pendingDatagrams.insert(position, datagram);
+        }
+
+        m_burstData.clear();
+        m_burstFrames = 0;
+    }
+
+    void sendDatagram(const QByteArray &data)
+    {
+        for (const auto &target : std::as_const(m_udpTargets)) {
+            m_udpSocket->writeDatagram(data, target.first, target.second);
+        }
+    }
+
+    void sendStream(const QByteArray &data)
+    {
+        for (QTcpSocket *client : std::as_const(m_tcpClients)) {
+            client->write(data);
+        }
+
+#ifdef Q_OS_LINUX
+        if (m_ptyMaster >= 0) {
+            // Порт ещё не открыт или не читается - данные теряются, как на настоящем UART
+            if (::write(m_ptyMaster, data.constData(), data.size()) < 0 && errno != EAGAIN) {
+                perror("pty write");
+            }
+        }
+#endif
+    }
+
+    void finish()
+    {
+        m_finished = true;
+        report();
+        // Даём сокетам дописать буферы
+        QTimer::singleShot(200, QCoreApplication::instance(), &QCoreApplication::quit);
+    }
+
+    void report()
+    {
+        const double seconds = m_clock.elapsed() / 1000.0;
+        fprintf(stderr, "%.1f s: sent %lld frames (%.0f/s), dropped %lld, corrupted %lld, %lld bytes, tcp clients %lld\n",
+                seconds, m_sent, seconds > 0 ? m_sent / seconds : 0.0,
+                m_dropped, m_corrupted, m_bytes, static_cast<long long>(m_tcpClients.size()));
+    }
+
+    static bool chance(double percent)
+    {
+        return percent > 0 && QRandomGenerator::global()->generateDouble() * 100.0 < percent;
+    }
+
+    Options m_options;
+    QTimer m_tickTimer;
+    QTimer m_reportTimer;
+    QElapsedTimer m_clock;
+
+    QTcpServer *m_tcpServer = nullptr;
+    QList<QTcpSocket *> m_tcpClients;
+    QUdpSocket *m_udpSocket = nullptr;
+    QList<QPair<QHostAddress, quint16>> m_udpTargets;
+    int m_ptyMaster = -1;
+
+    bool m_finished = false;
+    qint64 m_generated = 0;
+    int m_sampleIndex = 0;
+    quint16 m_sequence = 0;
+    QByteArray m_burstData;
+    int m_burstFrames = 0;
+    QList<PendingBurst> m_pending;              // TCP и псевдотерминал, по порядку
+    QList<PendingBurst> m_pendingDatagrams;     // UDP, по времени отправки
+
+    long long m_sent = 0;
+    long long m_dropped = 0;
+    long long m_corrupted = 0;
+    long long m_bytes = 0;
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("MonitorHeadEmulator");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Эмулятор шлема MonitorHead для нагрузочных тестов");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption fileOption("file", "Файл исследования Research_*.txt (можно несколько).", "path");
+    QCommandLineOption onceOption("once", "Не повторять файлы по кругу.");
+    QCommandLineOption binaryOption("binary", "Бинарные пакеты вместо текстовых строк.");
+    QCommandLineOption rateOption("rate", "Кадров в секунду (60-1000).", "hz", "100");
+    QCommandLineOption burstOption("burst", "Кадров в одной записи или датаграмме.", "n", "1");
+    QCommandLineOption jitterOption("jitter", "Случайная задержка пачки, мс (датаграммы UDP - каждая своя).", "ms", "0");
+    QCommandLineOption lossOption("loss", "Процент потерянных кадров.", "percent", "0");
+    QCommandLineOption corruptOption("corrupt", "Процент испорченных кадров.", "percent", "0");
+    QCommandLineOption durationOption("duration", "Длительность работы, с (0 - без ограничения).", "sec", "0");
+    QCommandLineOption tcpOption("tcp", "TCP-сервер (по умолчанию, если не выбран другой транспорт).");
+    QCommandLineOption tcpPortOption("tcp-port", "Порт TCP-сервера.", "port", "8080");
+    QCommandLineOption udpOption("udp", "UDP: локальный порт.", "port");
+    QCommandLineOption udpTargetOption("udp-target", "UDP: адрес получателя host:port.", "address");
+    QCommandLineOption ptyOption("pty", "Псевдотерминал Linux вместо COM-порта.");
+    parser.addOptions({fileOption, onceOption, binaryOption, rateOption, burstOption, jitterOption,
+                       lossOption, corruptOption, durationOption, tcpOption, tcpPortOption, udpOption,
+                       udpTargetOption, ptyOption});
+    parser.process(app);
+
+    HeadsetEmulator::Options options;
+    for (const QString &fileName : parser.values(fileOption)) {
+        if (!loadResearchFile(fileName, options.samples)) {
+            return 1;
+        }
+    }
+    options.loop = !parser.isSet(onceOption);
+    options.binary = parser.isSet(binaryOption);
+    options.rate = qBound(60.0, parser.value(rateOption).toDouble(), 1000.0);
+    options.burst = qMax(1, parser.value(burstOption).toInt());
+    options.jitterMs = qMax(0.0, parser.value(jitterOption).toDouble());
+    options.lossPercent = qBound(0.0, parser.value(lossOption).toDouble(), 100.0);
+    options.corruptPercent = qBound(0.0, parser.value(corruptOption).toDouble(), 100.0);
+    options.durationSec = qMax(0.0, parser.value(durationOption).toDouble());
+
+    if (!parser.isSet(fileOption)) {
+        fprintf(stderr, "No research files given, generating synthetic motion\n");
+    } else {
+        fprintf(stderr, "Loaded %lld samples\n", static_cast<long long>(options.samples.size()));
+    }
+
+    HeadsetEmulator emulator(options);
+    bool hasTransport = false;
+
+    // Без явного выбора транспорта работаем как WiFi-модуль по умолчанию
+    const bool useTcp = parser.isSet(tcpOption) || parser.isSet(tcpPortOption) ||
+                        (!parser.isSet(udpOption) && !parser.isSet(ptyOption));
+    if (useTcp) {
+        bool portOk = false;
+        const uint port = parser.value(tcpPortOption).toUInt(&portOk);
+        if (!portOk || port == 0 || port > 65535) {
+            fprintf(stderr, "Invalid TCP port: %s\n", qPrintable(parser.value(tcpPortOption)));
+            return 1;
+        }
+        if (!emulator.listenTcp(static_cast<quint16>(port))) return 1;
+        hasTransport = true;
+    }
+
+    if (parser.isSet(udpOption) || parser.isSet(udpTargetOption)) {
+        QHostAddress target;
+        quint16 targetPort = 0;
+        if (parser.isSet(udpTargetOption)) {
+            const QString value = parser.value(udpTargetOption);
+            const int colon = value.lastIndexOf(':');
+            target = QHostAddress(value.left(colon));
+            targetPort = static_cast<quint16>(value.mid(colon + 1).toUInt());
+        }
+        const quint16 localPort = static_cast<quint16>(parser.isSet(udpOption) ? parser.value(udpOption).toUInt() : 0);
+        if (!emulator.openUdp(localPort, target, targetPort)) return 1;
+        hasTransport = true;
+    }
+
+    if (parser.isSet(ptyOption)) {
+        if (!emulator.openPty()) return 1;
+        hasTransport = true;
+    }
+
+    if (!hasTransport) {
+        parser.showHelp(1);
+    }
+
+    fprintf(stderr, "Streaming %s frames at %.0f Hz, burst %d, jitter %.1f ms, loss %.1f%%, corrupt %.1f%%\n",
+            options.binary ? "binary" : "ASCII", options.rate, options.burst, options.jitterMs,
+            options.lossPercent, options.corruptPercent);
+
+    emulator.start();
+    return app.exec();
+}
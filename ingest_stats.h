@@ -0,0 +1,60 @@
+#ifndef INGEST_STATS_H
+#define INGEST_STATS_H
+
+#include <QtCore/QtGlobal>
+#include <QtCore/QMetaType>
+
+// Счётчики приёма данных за сессию подключения.
+// Ведутся в потоке приёма и передаются контроллеру копией (сигнал IngestWorker::statsUpdated)
+struct IngestStats {
+    quint64 bytesReceived = 0;      // Прочитано из порта/сокета
+    quint64 framesParsed = 0;       // Разобранные кадры, прошедшие проверки и переданные в GUI-поток
+    quint64 bytesDiscarded = 0;     // Выброшено при переполнении буфера неполной строки
+
+    // Отброшенные кадры по причинам
+    quint64 rejectedPackets = 0;    // Бинарный пакет: неверная CRC или ложное синхрослово
+    quint64 rejectedLines = 0;      // Текстовая строка не разобрана
+    quint64 invalidValues = 0;      // NaN/бесконечность в углах
+    quint64 queueOverflow = 0;      // Очередь в GUI-поток заполнена
+    quint64 lateFrames = 0;         // UDP: опоздал за окно перестановки или время устройства раньше предыдущего кадра
+    quint64 duplicateFrames = 0;    // UDP: повтор пакета
+
+    quint64 framesRejected() const
+    {
+        return rejectedPackets + rejectedLines + invalidValues + queueOverflow +
+               lateFrames + duplicateFrames;
+    }
+
+    IngestStats &operator+=(const IngestStats &other)
+    {
+        bytesReceived += other.bytesReceived;
+        framesParsed += other.framesParsed;
+        bytesDiscarded += other.bytesDiscarded;
+        rejectedPackets += other.rejectedPackets;
+        rejectedLines += other.rejectedLines;
+        invalidValues += other.invalidValues;
+        queueOverflow += other.queueOverflow;
+        lateFrames += other.lateFrames;
+        duplicateFrames += other.duplicateFrames;
+        return *this;
+    }
+
+    IngestStats operator-(const IngestStats &other) const
+    {
+        IngestStats result;
+        result.bytesReceived = bytesReceived - other.bytesReceived;
+        result.framesParsed = framesParsed - other.framesParsed;
+        result.bytesDiscarded = bytesDiscarded - other.bytesDiscarded;
+        result.rejectedPackets = rejectedPackets - other.rejectedPackets;
+        result.rejectedLines = rejectedLines - other.rejectedLines;
+        result.invalidValues = invalidValues - other.invalidValues;
+        result.queueOverflow = queueOverflow - other.queueOverflow;
+        result.lateFrames = lateFrames - other.lateFrames;
+        result.duplicateFrames = duplicateFrames - other.duplicateFrames;
+        return result;
+    }
+};
+
+Q_DECLARE_METATYPE(IngestStats)
+
+#endif // INGEST_STATS_H
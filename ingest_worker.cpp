@@ -0,0 +1,497 @@
+#include "ingest_worker.h"
+#include "frame_parser.h"
+#include <QDebug>
+#include <QDateTime>
+#include <cmath>
+#include <QtMath>
+
+IngestWorker::IngestWorker(SpscRingBuffer<DataFrame> *queue, QObject *parent) : QObject(parent)
+    , m_queue(queue)
+{
+    // Таймер создаётся дочерним объектом и переезжает в поток приёма вместе с воркером
+    m_safetyTimer = new QTimer(this);
+    m_safetyTimer->setInterval(2000);
+    connect(m_safetyTimer, &QTimer::timeout, this, [this]() {
+        if (m_serialPort && m_serialPort->isOpen()) {
+            if (m_serialPort->error() == QSerialPort::ResourceError) {
+                qDebug() << "Safety timer detected port error, cleaning up...";
+                emit serialPortError(QSerialPort::ResourceError, m_serialPort->errorString());
+            }
+        }
+
+        // UDP без соединения: если устройство замолчало (например, перезагрузилось),
+        // повторно сообщаем ему, куда слать данные
+        if (m_udpSocket && m_sessionClock.elapsed() - m_lastDatagramTime >= 2000) {
+            sendUdpHello();
+        }
+    });
+
+    // Пока в окне перестановки есть придержанные пакеты, окно проверяется и без новых датаграмм
+    m_reorderTimer = new QTimer(this);
+    m_reorderTimer->setSingleShot(true);
+    m_reorderTimer->setInterval(ReorderWindow::MaxHoldMs);
+    connect(m_reorderTimer, &QTimer::timeout, this, &IngestWorker::flushReorderWindow);
+
+    m_connectTimer = new QTimer(this);
+    m_connectTimer->setSingleShot(true);
+    m_connectTimer->setInterval(5000);
+    connect(m_connectTimer, &QTimer::timeout, this, [this]() {
+        finishTcpConnect(false, "Превышено время ожидания подключения");
+    });
+}
+
+IngestWorker::~IngestWorker()
+{
+    closeTransport();
+}
+
+bool IngestWorker::openSerialPort(const QString &portName, qint64 sessionStartTime, QString *errorString)
+{
+    closeTransport();
+
+    m_incompleteData.clear();
+    resetSessionState(sessionStartTime);
+
+    m_serialPort = new QSerialPort(this);
+    m_serialPort->setPortName(portName);
+    m_serialPort->setBaudRate(QSerialPort::Baud115200);
+    m_serialPort->setDataBits(QSerialPort::Data8);
+    m_serialPort->setParity(QSerialPort::NoParity);
+    m_serialPort->setStopBits(QSerialPort::OneStop);
+    m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
+
+    // ОПТИМИЗАЦИЯ: Настраиваем размеры буферов
+    m_serialPort->setReadBufferSize(2048);
+
+    connect(m_serialPort, &QSerialPort::readyRead, this, &IngestWorker::readSerialData);
+    connect(m_serialPort, &QSerialPort::errorOccurred, this, &IngestWorker::handleSerialError);
+
+    if (!m_serialPort->open(QIODevice::ReadOnly)) {
+        if (errorString) {
+            *errorString = m_serialPort->errorString();
+        }
+        closeTransport();
+        return false;
+    }
+
+    m_safetyTimer->start();
+    return true;
+}
+
+bool IngestWorker::openUdpSocket(const QString &deviceAddress, int port, qint64 sessionStartTime, QString *errorString)
+{
+    closeTransport();
+
+    m_datagram.clear();
+    resetSessionState(sessionStartTime);
+
+    m_udpDeviceAddress = QHostAddress(deviceAddress);
+    if (m_udpDeviceAddress == QHostAddress::AnyIPv4 || m_udpDeviceAddress == QHostAddress::Any) {
+        m_udpDeviceAddress.clear();
+    }
+    m_udpDevicePort = static_cast<quint16>(port);
+
+    m_udpSocket = new QUdpSocket(this);
+    // ОПТИМИЗАЦИЯ: Системный буфер побольше, чтобы пачка датаграмм не терялась,
+    // пока поток приёма занят
+    m_udpSocket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 256 * 1024);
+
+    // Известному устройству порт сообщает приветствие, поэтому свой порт - любой свободный:
+    // порт устройства остаётся за ним, даже если оно (или эмулятор) на этом же компьютере.
+    // Без адреса приветствие слать некуда - слушаем порт, на который шлёт устройство
+    const quint16 localPort = m_udpDeviceAddress.isNull() ? m_udpDevicePort : 0;
+    if (!m_udpSocket->bind(QHostAddress::AnyIPv4, localPort,
+                           QAbstractSocket::ShareAddress | QAbstractSocket::ReuseAddressHint)) {
+        if (errorString) {
+            *errorString = m_udpSocket->errorString();
+        }
+        closeTransport();
+        return false;
+    }
+
+    connect(m_udpSocket, &QUdpSocket::readyRead, this, &IngestWorker::readUdpDatagrams);
+
+    m_lastDatagramTime = m_sessionClock.elapsed();
+    sendUdpHello();
+    m_safetyTimer->start();
+    return true;
+}
+
+void IngestWorker::connectToHost(const QString &address, int port, qint64 sessionStartTime)
+{
+    closeTransport();
+
+    m_incompleteData.clear();
+    resetSessionState(sessionStartTime);
+
+    m_tcpSocket = new QTcpSocket(this);
+    connect(m_tcpSocket, &QTcpSocket::connected, this, &IngestWorker::handleTcpConnected);
+    connect(m_tcpSocket, &QTcpSocket::readyRead, this, &IngestWorker::readTcpData);
+    connect(m_tcpSocket, &QTcpSocket::errorOccurred, this, &IngestWorker::handleTcpError);
+    connect(m_tcpSocket, &QTcpSocket::stateChanged, this, &IngestWorker::handleTcpStateChanged);
+
+    // Поток приёма не блокируется ожиданием: результат придёт через connected/errorOccurred
+    // или по таймауту, а тем временем можно закрыть транспорт
+    m_tcpConnecting = true;
+    m_connectTimer->start();
+    m_tcpSocket->connectToHost(address, port);
+}
+
+void IngestWorker::handleTcpConnected()
+{
+    if (!m_tcpConnecting) {
+        return;
+    }
+
+    // Отсчёты идут по 40 байт, задержка Nagle для них не нужна
+    m_tcpSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    m_tcpConnected = true;
+    finishTcpConnect(true, QString());
+}
+
+void IngestWorker::finishTcpConnect(bool ok, const QString &errorString)
+{
+    if (!m_tcpConnecting) {
+        return;
+    }
+
+    m_tcpConnecting = false;
+    m_connectTimer->stop();
+
+    if (!ok) {
+        closeTransport();
+    }
+
+    emit tcpConnectFinished(ok, errorString);
+}
+
+void IngestWorker::closeTransport()
+{
+    m_safetyTimer->stop();
+    m_connectTimer->stop();
+    m_reorderTimer->stop();
+    m_tcpConnecting = false;
+
+    if (m_serialPort) {
+        disconnect(m_serialPort, nullptr, this, nullptr);
+
+        if (m_serialPort->isOpen()) {
+            m_serialPort->close();
+        }
+
+        m_serialPort->deleteLater();
+        m_serialPort = nullptr;
+    }
+
+    if (m_tcpSocket) {
+        disconnect(m_tcpSocket, nullptr, this, nullptr);
+
+        if (m_tcpSocket->state() == QAbstractSocket::ConnectedState) {
+            m_tcpSocket->disconnectFromHost();
+        }
+        m_tcpSocket->close();
+
+        m_tcpSocket->deleteLater();
+        m_tcpSocket = nullptr;
+    }
+
+    if (m_udpSocket) {
+        disconnect(m_udpSocket, nullptr, this, nullptr);
+        m_udpSocket->close();
+
+        m_udpSocket->deleteLater();
+        m_udpSocket = nullptr;
+    }
+
+    m_tcpConnected = false;
+    m_incompleteData.clear();
+    m_datagram.clear();
+}
+
+void IngestWorker::readSerialData()
+{
+    if (!m_serialPort || !m_serialPort->isOpen()) {
+        return;
+    }
+
+    appendAndParse(m_serialPort);
+}
+
+void IngestWorker::readTcpData()
+{
+    if (!m_tcpSocket || m_tcpSocket->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+
+    // Обрабатываем данные так же, как и с COM-порта
+    appendAndParse(m_tcpSocket);
+}
+
+void IngestWorker::readUdpDatagrams()
+{
+    if (!m_udpSocket) {
+        return;
+    }
+
+    while (m_udpSocket->hasPendingDatagrams()) {
+        const qint64 size = m_udpSocket->pendingDatagramSize();
+        QHostAddress sender;
+
+        // Датаграмма читается в переиспользуемый буфер - без выделений на каждый пакет
+        m_datagram.resize(qMax<qint64>(0, size));
+        const qint64 bytesRead = m_udpSocket->readDatagram(m_datagram.data(), m_datagram.size(), &sender);
+        if (bytesRead <= 0) {
+            continue;
+        }
+        m_datagram.resize(bytesRead);
+
+        if (!m_udpDeviceAddress.isNull() && !sender.isEqual(m_udpDeviceAddress, QHostAddress::TolerantConversion)) {
+            continue; // Чужой отправитель в той же сети
+        }
+
+        m_lastDatagramTime = m_sessionClock.elapsed();
+        m_stats.bytesReceived += bytesRead;
+        processDatagram(sessionTime());
+    }
+
+    if (m_reorder.buffered() > 0 && !m_reorderTimer->isActive()) {
+        m_reorderTimer->start();
+    }
+
+    reportStreamState();
+}
+
+void IngestWorker::flushReorderWindow()
+{
+    if (!m_udpSocket) {
+        return;
+    }
+
+    m_reorder.flushStale(sessionTime(), [this](const RawFrame &raw, double frameArrival) {
+        pushFrame(raw, frameArrival);
+    });
+
+    // Пропуск перед придержанными ещё не выждан - проверяем снова
+    if (m_reorder.buffered() > 0) {
+        m_reorderTimer->start();
+    }
+
+    reportStreamState();
+}
+
+void IngestWorker::processDatagram(double arrivalTime)
+{
+    const int MAX_FRAMES_PER_DATAGRAM = 100;
+
+    // Придержанные пакеты, которые ждут дольше допустимого, отдаём с пропуском
+    auto emitOrdered = [this](const RawFrame &raw, double frameArrival) {
+        pushFrame(raw, frameArrival);
+    };
+    m_reorder.flushStale(arrivalTime, emitOrdered);
+
+    // Границы датаграммы - границы кадров: последняя строка может прийти без перевода строки
+    if (!m_datagram.isEmpty() && m_datagram.at(m_datagram.size() - 1) != '\n') {
+        m_datagram.append('\n');
+    }
+
+    m_parser.consume(m_datagram, MAX_FRAMES_PER_DATAGRAM, [&](const RawFrame &raw) {
+        if (raw.hasSequence) {
+            m_reorder.insert(raw, arrivalTime, emitOrdered);
+        } else {
+            pushFrame(raw, arrivalTime); // Текстовые строки без номера - как есть
+        }
+    });
+
+    // Обрывок не переносится в следующую датаграмму
+    m_datagram.clear();
+}
+
+void IngestWorker::sendUdpHello()
+{
+    if (!m_udpSocket || m_udpDeviceAddress.isNull()) {
+        return;
+    }
+
+    // Приветствие на собственный порт вернулось бы к нам же как мусорная строка
+    if (m_udpDevicePort == m_udpSocket->localPort() && m_udpDeviceAddress.isLoopback()) {
+        return;
+    }
+
+    // Устройство отвечает на адрес и порт отправителя приветствия
+    static const char hello[] = "MH\n";
+    m_udpSocket->writeDatagram(hello, sizeof(hello) - 1, m_udpDeviceAddress, m_udpDevicePort);
+}
+
+void IngestWorker::appendAndParse(QIODevice *device)
+{
+    const qint64 available = device->bytesAvailable();
+    if (available <= 0) {
+        return;
+    }
+
+    // Читаем прямо в хвост приёмного буфера, без промежуточного QByteArray
+    const qsizetype oldSize = m_incompleteData.size();
+    m_incompleteData.resize(oldSize + available);
+    const qint64 bytesRead = device->read(m_incompleteData.data() + oldSize, available);
+    m_incompleteData.resize(oldSize + qMax<qint64>(0, bytesRead));
+    m_stats.bytesReceived += qMax<qint64>(0, bytesRead);
+
+    processIncomingData();
+}
+
+void IngestWorker::processIncomingData()
+{
+    const int MAX_LINES_PER_CYCLE = 100; // Строки разбираются порциями
+
+    // Время прихода фиксируется здесь, в потоке приёма, а не при обработке в GUI
+    const double arrivalTime = sessionTime();
+
+    // В потоке приёма можно разобрать всю пачку целиком: GUI от этого не зависит
+    while (m_parser.consume(m_incompleteData, MAX_LINES_PER_CYCLE, [&](const RawFrame &raw) {
+               pushFrame(raw, arrivalTime);
+           }) == MAX_LINES_PER_CYCLE) {
+    }
+
+    reportStreamState();
+
+    // Ограничиваем размер буфера неполных данных (остаток без перевода строки)
+    if (m_incompleteData.size() > 2048) {
+        const qsizetype discarded = m_incompleteData.size() - 1024;
+        m_incompleteData.remove(0, discarded); // Оставляем последние данные
+        m_stats.bytesDiscarded += discarded;
+    }
+}
+
+void IngestWorker::pushFrame(const RawFrame &raw, double arrivalTime)
+{
+    if (qIsNaN(raw.pitch) || qIsNaN(raw.roll) || qIsNaN(raw.yaw) ||
+        qIsInf(raw.pitch) || qIsInf(raw.roll) || qIsInf(raw.yaw)) {
+        m_stats.invalidValues++;
+        return;
+    }
+
+    // Калибровка и нормализация углов выполняются в GUI-потоке при выборке из очереди
+    DataFrame frame;
+    // Время кадра берётся по часам устройства: задержки сети и пачки
+    // при доставке не превращаются в дрожание меток
+    bool late = false;
+    const double frameTime = m_useDeviceTime ? m_timebase.map(raw.deviceTime, arrivalTime, &late)
+                                             : arrivalTime;
+
+    // Текстовые датаграммы UDP без номера приходят как есть, в том числе не по порядку.
+    // Кадр, обогнанный более новыми, уже не показать и не записать по порядку
+    if (late) {
+        m_stats.lateFrames++;
+        return;
+    }
+    frame.timestamp = std::llround(frameTime);
+    frame.pitch = raw.pitch;
+    frame.roll = raw.roll;
+    frame.yaw = raw.yaw;
+    frame.patientDizziness = raw.patientDizziness;
+    frame.doctorDizziness = raw.doctorDizziness;
+
+    // Переполнение очереди не выводится на каждый кадр: при задержке GUI-потока
+    // это тысячи строк в секунду. Счётчик попадает в статистику приёма и итоги записи
+    if (!m_queue->push(frame)) {
+        m_stats.queueOverflow++;
+        return;
+    }
+
+    // Разобранным считается только принятый кадр: каждый кадр попадает ровно в один счётчик
+    m_stats.framesParsed++;
+}
+
+void IngestWorker::reportStreamState()
+{
+    // Сообщаем контроллеру только об изменениях формата и числа потерянных пакетов
+    const int format = m_parser.lastFormat();
+    if (format != m_reportedFormat) {
+        m_reportedFormat = format;
+        emit streamFormatDetected(format);
+    }
+
+    // По UDP пакеты приходят не по порядку, поэтому потери считает окно перестановки,
+    // а не разбор потока
+    const quint64 lostPackets = m_udpSocket ? m_reorder.lostPackets() : m_parser.lostPackets();
+    if (lostPackets != m_reportedLostPackets) {
+        m_reportedLostPackets = lostPackets;
+        emit lostPacketsChanged(m_reportedLostPackets);
+    }
+
+    // Оценки джиттера и дрейфа отправляем не чаще раза в секунду
+    const qint64 now = m_sessionClock.elapsed();
+    if (m_useDeviceTime && now - m_lastTimebaseReport >= 1000) {
+        m_lastTimebaseReport = now;
+        emit timebaseUpdated(m_timebase.jitterMs(), m_timebase.driftPpm());
+    }
+
+    if (now - m_lastStatsReport >= 1000) {
+        m_lastStatsReport = now;
+        emit statsUpdated(stats());
+    }
+}
+
+IngestStats IngestWorker::stats() const
+{
+    IngestStats result = m_stats;
+    result.rejectedPackets = m_parser.rejectedPackets();
+    result.rejectedLines = m_parser.rejectedLines();
+    result.lateFrames = m_stats.lateFrames + m_reorder.lateFrames();
+    result.duplicateFrames = m_reorder.duplicateFrames();
+    return result;
+}
+
+void IngestWorker::resetSessionState(qint64 sessionStartTime)
+{
+    // Монотонные часы привязываются к началу сессии контроллера (m_startTime),
+    // чтобы метки кадров оставались в той же шкале, что и раньше
+    m_sessionClock.start();
+    m_sessionClockOffset = static_cast<double>(QDateTime::currentMSecsSinceEpoch() - sessionStartTime);
+    m_lastTimebaseReport = 0;
+    m_lastStatsReport = 0;
+    m_stats = IngestStats();
+    m_timebase.reset();
+
+    m_parser.reset();
+    m_reorder.reset();
+    m_reportedFormat = FrameParser::UnknownFormat;
+    m_reportedLostPackets = 0;
+}
+
+double IngestWorker::sessionTime() const
+{
+    return m_sessionClockOffset + m_sessionClock.nsecsElapsed() / 1e6;
+}
+
+void IngestWorker::handleSerialError(QSerialPort::SerialPortError error)
+{
+    if (error == QSerialPort::NoError) {
+        return;
+    }
+
+    emit serialPortError(error, m_serialPort ? m_serialPort->errorString() : QString());
+}
+
+void IngestWorker::handleTcpError(QAbstractSocket::SocketError error)
+{
+    Q_UNUSED(error)
+
+    if (m_tcpConnecting) {
+        finishTcpConnect(false, m_tcpSocket ? m_tcpSocket->errorString() : QString());
+        return;
+    }
+
+    if (m_tcpConnected) {
+        m_tcpConnected = false;
+        emit tcpError(m_tcpSocket ? m_tcpSocket->errorString() : QString());
+    }
+}
+
+void IngestWorker::handleTcpStateChanged(QAbstractSocket::SocketState state)
+{
+    if (state == QAbstractSocket::UnconnectedState && m_tcpConnected) {
+        m_tcpConnected = false;
+        emit tcpDisconnected();
+    }
+}
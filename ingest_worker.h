@@ -0,0 +1,111 @@
+#ifndef INGEST_WORKER_H
+#define INGEST_WORKER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtSerialPort/QSerialPort>
+#include <QTcpSocket>
+#include <QUdpSocket>
+#include <QHostAddress>
+#include "data_frame.h"
+#include "spsc_ring_buffer.h"
+#include "frame_parser.h"
+#include "device_timebase.h"
+#include "reorder_window.h"
+#include "ingest_stats.h"
+
+// Приём и разбор данных устройства в отдельном потоке.
+// Объект переносится в поток приёма (moveToThread), все его слоты вызываются
+// через очередь событий. Разобранные кадры складываются в SPSC-буфер, который
+// GUI-поток опустошает один раз за кадр отрисовки.
+class IngestWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IngestWorker(SpscRingBuffer<DataFrame> *queue, QObject *parent = nullptr);
+    ~IngestWorker();
+
+    // Открывает COM-порт. Вызывается блокирующе из GUI-потока, поэтому возвращает результат
+    bool openSerialPort(const QString &portName, qint64 sessionStartTime, QString *errorString);
+
+    // Приём датаграмм UDP. Вызывается блокирующе, как и openSerialPort.
+    // Если адрес устройства задан, сокет привязывается к свободному порту, port - порт
+    // устройства: на него уходит приветствие, и устройство отвечает на наш порт.
+    // Если адрес не задан, port - локальный порт, на который устройство шлёт само
+    bool openUdpSocket(const QString &deviceAddress, int port, qint64 sessionStartTime, QString *errorString);
+    // Порт, к которому привязан сокет UDP (0 - сокет закрыт)
+    quint16 udpLocalPort() const { return m_udpSocket ? m_udpSocket->localPort() : 0; }
+
+    // Счётчики текущей сессии приёма. Вызывается блокирующе из GUI-потока
+    IngestStats stats() const;
+
+public slots:
+    // Подключение по TCP без ожидания. Результат приходит сигналом tcpConnectFinished
+    void connectToHost(const QString &address, int port, qint64 sessionStartTime);
+    void closeTransport();
+
+signals:
+    void serialPortError(QSerialPort::SerialPortError error, const QString &errorString);
+    void tcpConnectFinished(bool ok, const QString &errorString);
+    void tcpError(const QString &errorString);
+    void tcpDisconnected();
+    void streamFormatDetected(int format);          // FrameParser::StreamFormat
+    void lostPacketsChanged(quint64 lostPackets);   // По номерам бинарных пакетов
+    void timebaseUpdated(double jitterMs, double driftPpm);
+    void statsUpdated(const IngestStats &stats);    // Не чаще раза в секунду
+
+private slots:
+    void readSerialData();
+    void readTcpData();
+    void readUdpDatagrams();
+    void handleSerialError(QSerialPort::SerialPortError error);
+    void handleTcpConnected();
+    void handleTcpError(QAbstractSocket::SocketError error);
+    void handleTcpStateChanged(QAbstractSocket::SocketState state);
+
+private:
+    void finishTcpConnect(bool ok, const QString &errorString);
+    void appendAndParse(QIODevice *device);
+    void processIncomingData();
+    void processDatagram(double arrivalTime);
+    void flushReorderWindow();
+    void pushFrame(const RawFrame &raw, double arrivalTime);
+    void reportStreamState();
+    void sendUdpHello();
+    void resetSessionState(qint64 sessionStartTime);
+    double sessionTime() const;
+
+    SpscRingBuffer<DataFrame> *m_queue;
+
+    QSerialPort *m_serialPort = nullptr;
+    QTcpSocket *m_tcpSocket = nullptr;
+    bool m_tcpConnected = false;
+    bool m_tcpConnecting = false;
+    QTimer *m_connectTimer = nullptr;   // Таймаут подключения TCP
+    QUdpSocket *m_udpSocket = nullptr;
+    QHostAddress m_udpDeviceAddress;    // Пустой - принимаем от любого отправителя
+    quint16 m_udpDevicePort = 0;        // Порт устройства (адресат приветствия), не наш
+    qint64 m_lastDatagramTime = 0;      // По m_sessionClock, для повторного приветствия
+    QTimer *m_safetyTimer = nullptr;
+
+    QByteArray m_incompleteData;
+    FrameParser m_parser;
+    QByteArray m_datagram;          // Одна датаграмма UDP - один или несколько целых кадров
+    ReorderWindow m_reorder;        // Порядок пакетов UDP восстанавливается по номерам
+    QTimer *m_reorderTimer = nullptr;   // Выдача придержанных пакетов, если датаграммы перестали приходить
+    int m_reportedFormat = FrameParser::UnknownFormat;
+    quint64 m_reportedLostPackets = 0;
+    // Метки времени: часы устройства, пересчитанные в шкалу сессии контроллера
+    DeviceTimebase m_timebase;
+    QElapsedTimer m_sessionClock;   // Монотонные часы для времени прихода
+    double m_sessionClockOffset = 0.0;
+    qint64 m_lastTimebaseReport = 0;
+    qint64 m_lastStatsReport = 0;
+    IngestStats m_stats;            // Без счётчиков разбора - они берутся из m_parser и m_reorder
+    bool m_useDeviceTime = true;    // false - метка по времени прихода, как раньше
+};
+
+#endif // INGEST_WORKER_H
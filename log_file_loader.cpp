@@ -0,0 +1,287 @@
+#include "log_file_loader.h"
+#include "frame_parser.h"
+#include "session_file.h"
+#include "paged_log_file.h"
+#include "research_archive.h"
+#include <QFile>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Куски меньше этого размера не делим: накладные расходы потоков больше выигрыша
+const qint64 kMinChunkBytes = 256 * 1024;
+// Комментарии исследования ищутся только в первых строках файла
+const int kHeaderLines = 5;
+// Как часто кусок отчитывается о ходе разбора и проверяет отмену
+const int kProgressLines = 4096;
+// Оценка памяти под записи по размеру текста: строка "0000000016;-39.10;0.80;19.75;1;0"
+// занимает ~34 байта, запись в колонках - 21 байт
+const qint64 kTextBytesPerSample = 34;
+const qint64 kSampleBytes = sizeof(qint64) + 3 * sizeof(float) + sizeof(quint8);
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\0';
+}
+
+// Перенос записей куска [from, from + count) в позицию to (to < from)
+template <typename T>
+inline void compact(T *column, qint64 from, qint64 count, qint64 to)
+{
+    std::move(column + from, column + from + count, column + to);
+}
+
+inline const char *lineEnd(const char *pos, const char *end)
+{
+    const char *newline = static_cast<const char *>(std::memchr(pos, '\n', end - pos));
+    return newline ? newline : end;
+}
+
+} // namespace
+
+bool LogFileLoader::load(const QString &fileName, LogFileContents &contents, LogLoadControl *control)
+{
+    // Бинарный файл сессии открывается без разбора
+    if (SessionFile::isSessionFile(fileName)) {
+        return SessionFile::load(fileName, contents);
+    }
+    // Сжатый архив декодируется потоком по блокам
+    if (ResearchArchive::isArchiveFile(fileName)) {
+        return ResearchArchive::load(fileName, contents, control);
+    }
+
+    contents = LogFileContents();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        contents.errorString = file.errorString();
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (control) {
+        control->bytesTotal = size;
+    }
+    if (size == 0) {
+        return true;
+    }
+
+    // Запись не помещается в бюджет памяти - только индекс, записи подкачиваются страницами
+    if (control && control->memoryBudget > 0 &&
+        size / kTextBytesPerSample * kSampleBytes > control->memoryBudget) {
+        file.close();
+        return PagedLogFile::open(fileName, control->memoryBudget, contents, control);
+    }
+
+    // ОПТИМИЗАЦИЯ: файл не копируется в память процесса, страницы подгружает ОС
+    uchar *mapped = file.map(0, size);
+    if (mapped) {
+        parse(reinterpret_cast<const char *>(mapped), size, contents, control);
+        file.unmap(mapped);
+    } else {
+        // Отображение недоступно (например, сетевой диск) - читаем целиком
+        const QByteArray data = file.readAll();
+        parse(data.constData(), data.size(), contents, control);
+    }
+
+    if (contents.cancelled) {
+        contents.samples = SampleStore();
+        contents.errorString = "загрузка отменена";
+        return false;
+    }
+
+    return true;
+}
+
+void LogFileLoader::parse(const char *data, qint64 size, LogFileContents &contents, LogLoadControl *control)
+{
+    contents.headerLines = readHeader(data, size);
+
+    const int threads = qMax(1, QThread::idealThreadCount());
+    const int chunkCount = static_cast<int>(qBound<qint64>(1, size / kMinChunkBytes, threads * 4));
+
+    // Границы кусков сдвигаются на начало следующей строки. Первый кусок маленький:
+    // по нему строится предварительный просмотр, пока разбирается остальное
+    const qint64 firstChunkBytes = qMin(kMinChunkBytes, size / chunkCount);
+    QVector<Chunk> chunks(chunkCount);
+    qint64 begin = 0;
+    for (int i = 0; i < chunkCount; ++i) {
+        qint64 end = size;
+        if (i + 1 < chunkCount) {
+            const qint64 nominal = qMax(begin, firstChunkBytes + (size - firstChunkBytes) * i / (chunkCount - 1));
+            end = (lineEnd(data + nominal, data + size) - data) + 1;
+            end = qMin(end, size);
+        }
+        chunks[i].begin = begin;
+        chunks[i].end = end;
+        begin = end;
+    }
+
+    // Собственный пул: загрузка сама может выполняться в потоке глобального пула
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    // Проход 1: число строк в каждом куске, чтобы выделить память под весь файл сразу
+    for (Chunk &chunk : chunks) {
+        pool.start([data, &chunk]() {
+            const char *pos = data + chunk.begin;
+            const char *end = data + chunk.end;
+            chunk.lineCount = std::count(pos, end, '\n');
+            if (end > pos && end[-1] != '\n') {
+                chunk.lineCount++; // Последняя строка без перевода строки
+            }
+        });
+    }
+    pool.waitForDone();
+
+    qint64 totalLines = 0;
+    for (Chunk &chunk : chunks) {
+        chunk.firstLine = totalLines;
+        chunk.firstSlot = totalLines;
+        totalLines += chunk.lineCount;
+    }
+    contents.totalLines = totalLines;
+
+    // Одна ячейка на строку; комментарии и ошибки оставляют пропуски
+    SampleColumns columns;
+    columns.resize(totalLines);
+
+    // Проход 2: разбор кусков прямо в общие колонки (первый кусок ставится в очередь первым)
+    for (int i = 0; i < chunkCount; ++i) {
+        Chunk &chunk = chunks[i];
+        const bool preview = (i == 0 && chunkCount > 1 && control && control->onPreview);
+        pool.start([data, &chunk, &columns, &contents, control, preview]() {
+            parseChunk(data, chunk, columns, control);
+            if (preview && !control->isCancelled()) {
+                control->onPreview(contents.headerLines, copyPrefix(columns, chunk.parsedCount));
+            }
+        });
+    }
+    pool.waitForDone();
+
+    if (control && control->isCancelled()) {
+        contents.cancelled = true;
+        return;
+    }
+
+    // Склейка: сдвигаем разобранные записи кусков вплотную друг к другу
+    qint64 written = 0;
+    for (const Chunk &chunk : chunks) {
+        if (chunk.firstSlot != written && chunk.parsedCount > 0) {
+            compact(columns.time.data(), chunk.firstSlot, chunk.parsedCount, written);
+            compact(columns.pitch.data(), chunk.firstSlot, chunk.parsedCount, written);
+            compact(columns.roll.data(), chunk.firstSlot, chunk.parsedCount, written);
+            compact(columns.yaw.data(), chunk.firstSlot, chunk.parsedCount, written);
+            compact(columns.buttons.data(), chunk.firstSlot, chunk.parsedCount, written);
+        }
+        written += chunk.parsedCount;
+
+        contents.failedLineCount += chunk.failedCount;
+        for (qint64 line : chunk.failedLines) {
+            if (contents.failedLines.size() >= MaxReportedLines) {
+                break;
+            }
+            contents.failedLines.append(line);
+        }
+    }
+
+    columns.resize(written);
+
+    // Много пропусков (файл с мусором) - возвращаем лишнюю память
+    if (totalLines - written > totalLines / 8) {
+        columns.squeeze();
+    }
+
+    contents.samples = SampleStore(std::move(columns));
+}
+
+SampleStore LogFileLoader::copyPrefix(const SampleColumns &columns, qint64 count)
+{
+    // Глубокая копия: общие колонки в это время заполняют другие потоки,
+    // и разделять с ними буфер (mid() может не копировать) нельзя
+    SampleColumns prefix;
+    prefix.time = QVector<qint64>(columns.time.constBegin(), columns.time.constBegin() + count);
+    prefix.pitch = QVector<float>(columns.pitch.constBegin(), columns.pitch.constBegin() + count);
+    prefix.roll = QVector<float>(columns.roll.constBegin(), columns.roll.constBegin() + count);
+    prefix.yaw = QVector<float>(columns.yaw.constBegin(), columns.yaw.constBegin() + count);
+    prefix.buttons = QVector<quint8>(columns.buttons.constBegin(), columns.buttons.constBegin() + count);
+    return SampleStore(std::move(prefix));
+}
+
+void LogFileLoader::parseChunk(const char *data, Chunk &chunk, SampleColumns &columns, LogLoadControl *control)
+{
+    const char *pos = data + chunk.begin;
+    const char *end = data + chunk.end;
+
+    // Каждый кусок пишет только в свои ячейки, поэтому синхронизация не нужна
+    qint64 *time = columns.time.data() + chunk.firstSlot;
+    float *pitch = columns.pitch.data() + chunk.firstSlot;
+    float *roll = columns.roll.data() + chunk.firstSlot;
+    float *yaw = columns.yaw.data() + chunk.firstSlot;
+    quint8 *buttons = columns.buttons.data() + chunk.firstSlot;
+    qint64 lineIndex = chunk.firstLine;
+    const char *reported = pos;
+
+    while (pos < end) {
+        if (control && (lineIndex - chunk.firstLine) % kProgressLines == 0) {
+            control->bytesParsed.fetch_add(pos - reported, std::memory_order_relaxed);
+            reported = pos;
+            if (control->isCancelled()) {
+                return;
+            }
+        }
+
+        const char *eol = lineEnd(pos, end);
+        const char *first = pos;
+        while (first < eol && isSpace(*first)) {
+            ++first;
+        }
+
+        // Пустые строки и комментарии (заголовок и итоги приёма) пропускаем
+        if (first < eol && *first != '#') {
+            RawFrame frame;
+            if (FrameParser::parseLine(first, eol, frame)) {
+                const qint64 slot = chunk.parsedCount++;
+                time[slot] = frame.deviceTime;
+                pitch[slot] = frame.pitch;
+                roll[slot] = frame.roll;
+                yaw[slot] = frame.yaw;
+                buttons[slot] = (frame.patientDizziness ? SampleStore::PatientButton : 0) |
+                                (frame.doctorDizziness ? SampleStore::DoctorButton : 0);
+            } else {
+                chunk.failedCount++;
+                if (chunk.failedLines.size() < MaxReportedLines) {
+                    chunk.failedLines.append(lineIndex + 1);
+                }
+            }
+        }
+
+        pos = eol + 1;
+        lineIndex++;
+    }
+
+    if (control) {
+        control->bytesParsed.fetch_add(end - reported, std::memory_order_relaxed);
+    }
+}
+
+QStringList LogFileLoader::readHeader(const char *data, qint64 size)
+{
+    QStringList header;
+    const char *pos = data;
+    const char *end = data + size;
+
+    for (int line = 0; line < kHeaderLines && pos < end; ++line) {
+        const char *eol = lineEnd(pos, end);
+        const QString text = QString::fromUtf8(pos, eol - pos).trimmed();
+        if (text.startsWith('#')) {
+            header << text.mid(1).trimmed();
+        }
+        pos = eol + 1;
+    }
+
+    return header;
+}
@@ -0,0 +1,77 @@
+#ifndef LOG_FILE_LOADER_H
+#define LOG_FILE_LOADER_H
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+#include "sample_store.h"
+#include <atomic>
+#include <functional>
+
+// Содержимое файла исследования после разбора
+struct LogFileContents {
+    QStringList headerLines;        // Комментарии '#' из первых пяти строк (без '#')
+    SampleStore samples;            // Корректные строки данных в порядке файла
+    QVector<qint64> failedLines;    // Номера (с 1) строк, которые не удалось разобрать (в .mha - блоков)
+    qint64 failedLineCount = 0;     // Всего ошибок (номеров сохраняется не больше MaxReportedLines)
+    qint64 totalLines = 0;
+    bool cancelled = false;
+    QString errorString;            // При успешной загрузке .mha - сводка о пропущенных блоках
+};
+
+// Управление фоновой загрузкой: ход разбора и отмена читаются и пишутся из разных потоков
+struct LogLoadControl {
+    std::atomic<qint64> bytesTotal{0};
+    std::atomic<qint64> bytesParsed{0};
+    std::atomic<bool> cancelled{false};
+
+    // Бюджет памяти под записи, байт (0 - без ограничения). Если текстовый файл
+    // в него не помещается, он открывается постранично (PagedLogFile)
+    qint64 memoryBudget = 0;
+
+    // Вызывается в потоке загрузки, как только разобрано начало файла,
+    // чтобы первый экран графиков появился до окончания загрузки
+    std::function<void(const QStringList &headerLines, const SampleStore &preview)> onPreview;
+
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+};
+
+// Загрузка текстового файла исследования "время;pitch;roll;yaw;пациент;врач".
+// Файл отображается в память и делится на куски по границам строк, куски
+// разбираются параллельно (по потоку на ядро) прямо в заранее выделенные колонки,
+// после чего пропуски от комментариев и ошибочных строк убираются одним проходом.
+// Строки разбираются FrameParser::parseLine - без QString и split() на каждую строку.
+// Файлы сессии .mhs (SessionFile) распознаются по сигнатуре и открываются без разбора
+class LogFileLoader
+{
+public:
+    static const int MaxReportedLines = 100;
+
+    // control необязателен: без него загрузка идёт без отчёта о ходе и без отмены
+    static bool load(const QString &fileName, LogFileContents &contents,
+                     LogLoadControl *control = nullptr);
+
+    // Разбор уже прочитанного содержимого (используется и для файлов, которые не удалось отобразить)
+    static void parse(const char *data, qint64 size, LogFileContents &contents,
+                      LogLoadControl *control = nullptr);
+
+    // Строки '#' в начале файла (номер и дата исследования)
+    static QStringList readHeader(const char *data, qint64 size);
+
+private:
+    struct Chunk {
+        qint64 begin = 0;           // Смещение в файле
+        qint64 end = 0;
+        qint64 firstLine = 0;       // Номер первой строки куска (с 0)
+        qint64 lineCount = 0;
+        qint64 firstSlot = 0;       // Первая ячейка куска в общем массиве
+        qint64 parsedCount = 0;
+        qint64 failedCount = 0;
+        QVector<qint64> failedLines;
+    };
+
+    static void parseChunk(const char *data, Chunk &chunk, SampleColumns &columns, LogLoadControl *control);
+    static SampleStore copyPrefix(const SampleColumns &columns, qint64 count);
+};
+
+#endif // LOG_FILE_LOADER_H
@@ -1,7 +1,6 @@
 #include "log_reader.h"
 #include <QtMath>
 #include <algorithm>
-#include <QDebug>
 
 LogReader::LogReader(QObject *parent) : QObject(parent)
     , m_updateFrequency(4.0f) // default 4 Hz
@@ -9,9 +8,10 @@ LogReader::LogReader(QObject *parent) : QObject(parent)
 {
 }
 
-void LogReader::setData(const QVector<LogDataEntry> &data)
+void LogReader::setData(const SampleStore &samples)
 {
-    m_logData = data;
+    m_samples = samples;
+    m_speedChannels = AngularSpeedChannels();
 }
 
 void LogReader::setUpdateFrequency(float frequencyHz)
@@ -21,20 +21,15 @@ void LogReader::setUpdateFrequency(float frequencyHz)
     m_windowDuration = 1.0f / m_updateFrequency;
 }
 
-float LogReader::calculateAngularSpeed(qint64 currentTime, const QString &angleType, bool isPlaying)
+float LogReader::angularSpeedAt(qint64 currentTime, SampleStore::Axis axis) const
 {
-    if (m_logData.isEmpty()) {
-        qDebug() << "LogReader: No data available";
+    if (m_samples.isEmpty()) {
         return 0.0f;
     }
 
-    // Заменяем m_windowDuration на m_smoothingWindow
     qint64 windowMs = static_cast<qint64>(m_smoothingWindow * 1000);
-    // qint64 windowMs = static_cast<qint64>(m_windowDuration * 1000);
     qint64 halfWindowMs = windowMs / 2;
 
-    qDebug() << "LogReader: Calculating" << angleType << "speed at time" << currentTime << "ms, window:" << windowMs << "ms";
-
     qint64 startTime, endTime;
 
     // Determine time range based on conditions
@@ -49,85 +44,42 @@ float LogReader::calculateAngularSpeed(qint64 currentTime, const QString &angleT
     }
 
     // Ensure we don't go beyond file boundaries
-    qint64 fileDuration = m_logData.last().time;
+    qint64 fileDuration = m_samples.lastTime();
     startTime = qMax(0LL, startTime);
     endTime = qMin(fileDuration, endTime);
 
-    // Get angle data in the calculated range
-    QVector<LogDataEntry> entries = getAngleDataInRange(startTime, endTime, angleType);
+    // Окно задаётся индексами - записи не копируются
+    int startIndex = m_samples.findIndexByTime(startTime);
+    int endIndex = m_samples.findIndexByTime(endTime);
 
-    if (entries.size() < 2) return 0.0f;
+    if (startIndex == -1 || endIndex == -1 || endIndex - startIndex < 1) return 0.0f;
 
     // Use simple speed calculation (more reliable)
-    return calculateSimpleSpeed(entries, angleType);
+    return calculateSimpleSpeed(startIndex, endIndex, axis);
 }
 
-QVector<LogDataEntry> LogReader::getAngleDataInRange(qint64 startTime, qint64 endTime, const QString &angleType)
+float LogReader::angularSpeedAtIndex(int index, SampleStore::Axis axis) const
 {
-    QVector<LogDataEntry> entries;
-
-    int startIndex = findIndexByTime(startTime);
-    int endIndex = findIndexByTime(endTime);
-
-    if (startIndex == -1 || endIndex == -1) return entries;
-
-    // Get all entries in the time range
-    for (int i = startIndex; i <= endIndex; ++i) {
-        if (i < 0 || i >= m_logData.size()) continue;
-        entries.append(m_logData[i]);
+    if (Q_LIKELY(!m_speedChannels.isEmpty())) {
+        return m_speedChannels.speed(axis, index);
     }
-
-    return entries;
+    return angularSpeedAt(m_samples.time(index), axis);
 }
 
-int LogReader::findIndexByTime(qint64 time)
+void LogReader::setSpeedChannels(const AngularSpeedChannels &channels)
 {
-    if (m_logData.isEmpty()) return -1;
-
-    // Binary search for efficiency
-    int left = 0;
-    int right = m_logData.size() - 1;
-    int result = -1;
-
-    while (left <= right) {
-        int mid = left + (right - left) / 2;
-        qint64 midTime = m_logData[mid].time;
-
-        if (midTime == time) {
-            return mid;
-        } else if (midTime < time) {
-            result = mid;
-            left = mid + 1;
-        } else {
-            right = mid - 1;
-        }
+    if (channels.size() == m_samples.size() && qFuzzyCompare(channels.window(), m_smoothingWindow)) {
+        m_speedChannels = channels;
     }
-
-    return result;
 }
 
-float LogReader::calculateSimpleSpeed(const QVector<LogDataEntry> &entries, const QString &angleType)
+float LogReader::calculateSimpleSpeed(int firstIndex, int lastIndex, SampleStore::Axis axis) const
 {
-    if (entries.size() < 2) return 0.0f;
+    if (lastIndex - firstIndex < 1) return 0.0f;
 
     // Use first and last entries for speed calculation
-    const LogDataEntry &firstEntry = entries.first();
-    const LogDataEntry &lastEntry = entries.last();
-
-    // Get the appropriate angle value
-    float firstAngle, lastAngle;
-    if (angleType == "pitch") {
-        firstAngle = firstEntry.pitch;
-        lastAngle = lastEntry.pitch;
-    } else if (angleType == "roll") {
-        firstAngle = firstEntry.roll;
-        lastAngle = lastEntry.roll;
-    } else if (angleType == "yaw") {
-        firstAngle = firstEntry.yaw;
-        lastAngle = lastEntry.yaw;
-    } else {
-        return 0.0f;
-    }
+    float firstAngle = m_samples.angle(axis, firstIndex);
+    float lastAngle = m_samples.angle(axis, lastIndex);
 
     // Calculate angular change with proper wrapping
     float angularChange = lastAngle - firstAngle;
@@ -140,7 +92,7 @@ float LogReader::calculateSimpleSpeed(const QVector<LogDataEntry> &entries, cons
     }
 
     // Calculate time difference in seconds
-    qint64 timeDiff = lastEntry.time - firstEntry.time;
+    qint64 timeDiff = m_samples.time(lastIndex) - m_samples.time(firstIndex);
     float timeDiffSec = static_cast<float>(timeDiff) / 1000.0f;
 
     if (timeDiffSec <= 0) return 0.0f;
@@ -160,6 +112,7 @@ void LogReader::setSmoothingWindow(float windowSeconds)
     windowSeconds = qBound(0.1f, windowSeconds, 3.0f);
     if (!qFuzzyCompare(m_smoothingWindow, windowSeconds)) {
         m_smoothingWindow = windowSeconds;
+        m_speedChannels = AngularSpeedChannels();
         emit smoothingWindowChanged(m_smoothingWindow);
     }
 }
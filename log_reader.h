@@ -4,19 +4,8 @@
 #include <QtCore/QObject>
 #include <QtCore/QVector>
 #include <QtCore/QDateTime>
-
-// Общая структура данных для лог-файла
-struct LogDataEntry {
-    qint64 time;
-    float pitch;
-    float roll;
-    float yaw;
-    bool dizziness;
-    bool doctorDizziness;
-
-    LogDataEntry() : time(0), pitch(0), roll(0), yaw(0),
-        dizziness(false), doctorDizziness(false) {}
-};
+#include "sample_store.h"
+#include "angular_speed_channels.h"
 
 class LogReader : public QObject
 {
@@ -26,10 +15,20 @@ class LogReader : public QObject
 public:
     explicit LogReader(QObject *parent = nullptr);
 
-    void setData(const QVector<LogDataEntry> &data);
+    // Данные не копируются: SampleStore разделяется с контроллером
+    void setData(const SampleStore &samples);
     void setUpdateFrequency(float frequencyHz);
 
-    float calculateAngularSpeed(qint64 currentTime, const QString &angleType, bool isPlaying);
+    // Скорость по окну вокруг currentTime (два двоичных поиска)
+    float angularSpeedAt(qint64 currentTime, SampleStore::Axis axis) const;
+    // Скорость во время записи index: из заранее посчитанных каналов за O(1),
+    // пока их нет - по окну, как angularSpeedAt
+    float angularSpeedAtIndex(int index, SampleStore::Axis axis) const;
+
+    // Каналы принимаются, только если посчитаны для текущих данных и текущего окна.
+    // setData и смена окна сбрасывают их
+    void setSpeedChannels(const AngularSpeedChannels &channels);
+    bool hasSpeedChannels() const { return !m_speedChannels.isEmpty(); }
 
     float getUpdateFrequency() const { return m_updateFrequency; }
 
@@ -37,13 +36,12 @@ public:
     float smoothingWindow() const { return m_smoothingWindow; }
 
 private:
-    QVector<LogDataEntry> m_logData;
+    SampleStore m_samples;
+    AngularSpeedChannels m_speedChannels;
     float m_updateFrequency; // Hz (1-10 Hz)
     float m_windowDuration; // seconds (0.1 - 1.0 seconds)
 
-    int findIndexByTime(qint64 time);
-    QVector<LogDataEntry> getAngleDataInRange(qint64 startTime, qint64 endTime, const QString &angleType);
-    float calculateSimpleSpeed(const QVector<LogDataEntry> &entries, const QString &angleType);
+    float calculateSimpleSpeed(int firstIndex, int lastIndex, SampleStore::Axis axis) const;
 
     float m_smoothingWindow = 0.5f; // Окно сглаживания в секундах
 
@@ -4,6 +4,7 @@
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
 #include <QtGui/QIcon>
+#include <QtQuick/QQuickWindow>
 #include "tiltcontroller.h"
 
 int main(int argc, char *argv[])
@@ -43,6 +44,9 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    // Воспроизведение лога идёт по кадрам главного окна
+    controller->setFrameSource(qobject_cast<QQuickWindow *>(engine.rootObjects().first()));
+
     qDebug() << "✅ Main application started successfully";
 
     return app.exec();
@@ -0,0 +1,80 @@
+#include "orientation_interpolator.h"
+#include <QtMath>
+
+namespace {
+
+// Угол, равный angle по модулю 360° и ближайший к reference
+float nearestTurn(float angle, float reference)
+{
+    return angle + 360.0f * std::round((reference - angle) / 360.0f);
+}
+
+QVector3D nearestTurn(const QVector3D &angles, const QVector3D &reference)
+{
+    return QVector3D(nearestTurn(angles.x(), reference.x()),
+                     nearestTurn(angles.y(), reference.y()),
+                     nearestTurn(angles.z(), reference.z()));
+}
+
+} // namespace
+
+void OrientationInterpolator::append(qint64 time, const QVector3D &angles)
+{
+    m_head = (m_head + 1) & (HistorySize - 1);
+    m_samples[m_head] = {time, angles};
+    m_count = qMin(m_count + 1, HistorySize);
+}
+
+qint64 OrientationInterpolator::lastTime() const
+{
+    return m_count > 0 ? sample(0).time : 0;
+}
+
+QVector3D OrientationInterpolator::anglesAt(double time) const
+{
+    if (m_count == 0) {
+        return QVector3D();
+    }
+
+    // Время показа отстаёт от последнего кадра на бюджет задержки - это несколько
+    // кадров, поэтому поиск идёт от новых к старым
+    if (time >= sample(0).time) {
+        return sample(0).angles;
+    }
+
+    for (int age = 1; age < m_count; ++age) {
+        const Sample &before = sample(age);
+        if (before.time <= time) {
+            const Sample &after = sample(age - 1);
+            const float fraction = static_cast<float>((time - before.time) / double(after.time - before.time));
+            return interpolate(before.angles, after.angles, fraction);
+        }
+    }
+
+    return sample(m_count - 1).angles;
+}
+
+QVector3D OrientationInterpolator::interpolate(const QVector3D &from, const QVector3D &to, float fraction)
+{
+    if (fraction <= 0.0f) {
+        return from;
+    }
+    if (fraction >= 1.0f) {
+        return to;
+    }
+
+    const QQuaternion orientation = QQuaternion::slerp(QQuaternion::fromEulerAngles(from),
+                                                       QQuaternion::fromEulerAngles(to), fraction);
+    const QVector3D angles = orientation.toEulerAngles();
+
+    // Кватернион задаёт положение, но не сами углы: (p, y, r) и (180 - p, y + 180, r + 180) -
+    // один и тот же поворот, и каждый угол определён с точностью до оборота.
+    // Берём вариант, ближайший к покомпонентной интерполяции исходных углов, чтобы
+    // значения на панелях осей продолжали ряд записей, а не скакали на 180° или 360°
+    const QVector3D reference = from + (nearestTurn(to, from) - from) * fraction;
+    const QVector3D direct = nearestTurn(angles, reference);
+    const QVector3D flipped = nearestTurn(QVector3D(180.0f - angles.x(), angles.y() + 180.0f, angles.z() + 180.0f),
+                                          reference);
+
+    return (direct - reference).lengthSquared() <= (flipped - reference).lengthSquared() ? direct : flipped;
+}
@@ -0,0 +1,50 @@
+#ifndef ORIENTATION_INTERPOLATOR_H
+#define ORIENTATION_INTERPOLATOR_H
+
+#include <QtCore/QtGlobal>
+#include <QtGui/QQuaternion>
+#include <QtGui/QVector3D>
+
+// Ориентация головы между записями. Кадры приходят раз в 15-25 мс с неровными
+// интервалами, а экран обновляется 60-144 раз в секунду; без интерполяции голова
+// на 3D-виде движется ступеньками с частотой датчика.
+// Углы переводятся в кватернионы и интерполируются по дуге (slerp): поворот идёт
+// по кратчайшему пути с постоянной угловой скоростью, без рывков при переходе
+// рыскания через ±180° и без искажений, которые даёт покомпонентная интерполяция углов.
+//
+// Углы - QVector3D(pitch, yaw, roll) в градусах, как в QQuaternion::fromEulerAngles:
+// порядок поворотов тот же, что в HeadModel::transformationMatrix()
+class OrientationInterpolator
+{
+public:
+    static const int HistorySize = 64;      // Степень двойки; ~0.6 с при 100 Гц
+
+    void clear() { m_count = 0; }
+    bool isEmpty() const { return m_count == 0; }
+
+    // Кадры добавляются в порядке времени (живой режим)
+    void append(qint64 time, const QVector3D &angles);
+    qint64 lastTime() const;
+
+    // Ориентация на момент time (мс). Раньше первого кадра истории - первый кадр,
+    // позже последнего - последний: экстраполяции нет, голова не уходит туда,
+    // куда пациент не поворачивался
+    QVector3D anglesAt(double time) const;
+
+    // Интерполяция между двумя положениями, fraction 0..1
+    static QVector3D interpolate(const QVector3D &from, const QVector3D &to, float fraction);
+
+private:
+    struct Sample {
+        qint64 time;
+        QVector3D angles;
+    };
+
+    const Sample &sample(int age) const { return m_samples[(m_head - age) & (HistorySize - 1)]; }
+
+    Sample m_samples[HistorySize];
+    int m_head = -1;        // Индекс последнего кадра
+    int m_count = 0;
+};
+
+#endif // ORIENTATION_INTERPOLATOR_H
@@ -0,0 +1,332 @@
+#include "paged_log_file.h"
+#include "frame_parser.h"
+#include "log_file_loader.h"
+#include <QSharedPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace {
+
+const qint64 kMinChunkBytes = 256 * 1024;
+const int kProgressLines = 4096;
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\0';
+}
+
+inline const char *lineEnd(const char *pos, const char *end)
+{
+    const char *newline = static_cast<const char *>(std::memchr(pos, '\n', end - pos));
+    return newline ? newline : end;
+}
+
+// Стоимость страницы в кэше, КБ
+inline int pageCost(const SampleColumns &columns)
+{
+    const qint64 bytes = columns.size() * qint64(sizeof(qint64) + 3 * sizeof(float) + sizeof(quint8));
+    return static_cast<int>(qMax<qint64>(1, bytes / 1024));
+}
+
+inline qint64 pageBytes()
+{
+    return PagedLogFile::PageSize * qint64(sizeof(qint64) + 3 * sizeof(float) + sizeof(quint8));
+}
+
+} // namespace
+
+PagedLogFile::~PagedLogFile()
+{
+    m_cache.clear();
+    if (m_data) {
+        m_file.unmap(reinterpret_cast<uchar *>(const_cast<char *>(m_data)));
+    }
+}
+
+bool PagedLogFile::open(const QString &fileName, qint64 memoryBudget,
+                        LogFileContents &contents, LogLoadControl *control)
+{
+    contents = LogFileContents();
+
+    QSharedPointer<PagedLogFile> paged(new PagedLogFile);
+    paged->m_file.setFileName(fileName);
+    if (!paged->m_file.open(QIODevice::ReadOnly)) {
+        contents.errorString = paged->m_file.errorString();
+        return false;
+    }
+
+    // Постраничный режим имеет смысл только с отображением: страницы читаются с диска
+    // по требованию, а не лежат в памяти процесса
+    paged->m_size = paged->m_file.size();
+    uchar *mapped = paged->m_file.map(0, paged->m_size);
+    if (!mapped) {
+        contents.errorString = "не удалось отобразить файл в память: " + paged->m_file.errorString();
+        return false;
+    }
+    paged->m_data = reinterpret_cast<const char *>(mapped);
+    paged->setMemoryBudget(memoryBudget);
+
+    if (control) {
+        control->bytesTotal = paged->m_size;
+    }
+
+    const char *data = paged->m_data;
+    const qint64 size = paged->m_size;
+    contents.headerLines = LogFileLoader::readHeader(data, size);
+
+    // Индекс строится по кускам в несколько потоков, как и обычная загрузка
+    const int threads = qMax(1, QThread::idealThreadCount());
+    const int chunkCount = static_cast<int>(qBound<qint64>(1, size / kMinChunkBytes, threads * 4));
+    QVector<ScanChunk> chunks(chunkCount);
+    qint64 begin = 0;
+    for (int i = 0; i < chunkCount; ++i) {
+        qint64 end = size;
+        if (i + 1 < chunkCount) {
+            const qint64 nominal = qMax(begin, size * (i + 1) / chunkCount);
+            end = qMin(size, (lineEnd(data + nominal, data + size) - data) + 1);
+        }
+        chunks[i].begin = begin;
+        chunks[i].end = end;
+        begin = end;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for (ScanChunk &chunk : chunks) {
+        pool.start([data, &chunk, control]() { scanChunk(data, chunk, control); });
+    }
+    pool.waitForDone();
+
+    if (control && control->isCancelled()) {
+        contents.cancelled = true;
+        contents.errorString = "загрузка отменена";
+        return false;
+    }
+
+    // Склейка индекса: номера записей и строк становятся сквозными
+    qint64 lineOffset = 0;
+    qint64 sampleCount = 0;
+    for (const ScanChunk &chunk : chunks) {
+        for (PageInfo page : chunk.pages) {
+            page.firstSample = static_cast<int>(sampleCount);
+            sampleCount += page.count;
+            paged->m_pages.append(page);
+        }
+
+        contents.failedLineCount += chunk.failedCount;
+        for (qint64 line : chunk.failedLines) {
+            if (contents.failedLines.size() >= LogFileLoader::MaxReportedLines) {
+                break;
+            }
+            contents.failedLines.append(lineOffset + line + 1);
+        }
+        lineOffset += chunk.lineCount;
+    }
+
+    if (sampleCount > INT_MAX) {
+        contents.errorString = "слишком много записей в файле";
+        return false;
+    }
+
+    paged->m_sampleCount = static_cast<int>(sampleCount);
+    contents.totalLines = lineOffset;
+    contents.samples = SampleStore(paged);
+    return true;
+}
+
+void PagedLogFile::scanChunk(const char *data, ScanChunk &chunk, LogLoadControl *control)
+{
+    const char *pos = data + chunk.begin;
+    const char *end = data + chunk.end;
+    const char *reported = pos;
+    PageInfo page;
+
+    while (pos < end) {
+        if (control && chunk.lineCount % kProgressLines == 0) {
+            control->bytesParsed.fetch_add(pos - reported, std::memory_order_relaxed);
+            reported = pos;
+            if (control->isCancelled()) {
+                return;
+            }
+        }
+
+        const char *eol = lineEnd(pos, end);
+        const char *first = pos;
+        while (first < eol && isSpace(*first)) {
+            ++first;
+        }
+
+        if (first < eol && *first != '#') {
+            // Записи разбираются, но не сохраняются - нужно только время и число записей
+            RawFrame frame;
+            if (FrameParser::parseLine(first, eol, frame)) {
+                if (page.count == 0) {
+                    page.begin = pos - data;
+                    page.firstTime = frame.deviceTime;
+                }
+                page.lastTime = frame.deviceTime;
+                page.end = qMin<qint64>(eol + 1 - data, chunk.end);
+                page.count++;
+
+                if (page.count == PageSize) {
+                    chunk.pages.append(page);
+                    page = PageInfo();
+                }
+            } else {
+                chunk.failedCount++;
+                if (chunk.failedLines.size() < LogFileLoader::MaxReportedLines) {
+                    chunk.failedLines.append(chunk.lineCount);
+                }
+            }
+        }
+
+        pos = eol + 1;
+        chunk.lineCount++;
+    }
+
+    if (page.count > 0) {
+        chunk.pages.append(page);
+    }
+
+    if (control) {
+        control->bytesParsed.fetch_add(end - reported, std::memory_order_relaxed);
+    }
+}
+
+int PagedLogFile::pageOf(int index) const
+{
+    // Быстрый путь: та же страница, что и в прошлый раз
+    if (m_lastPage >= 0) {
+        const PageInfo &last = m_pages[m_lastPage];
+        if (index >= last.firstSample && index < last.firstSample + last.count) {
+            return m_lastPage;
+        }
+    }
+
+    const auto found = std::upper_bound(m_pages.cbegin(), m_pages.cend(), index,
+                                        [](int value, const PageInfo &page) { return value < page.firstSample; });
+    return static_cast<int>(found - m_pages.cbegin()) - 1;
+}
+
+const SampleColumns &PagedLogFile::page(int pageIndex) const
+{
+    if (pageIndex == m_lastPage) {
+        return *m_lastColumns;
+    }
+
+    SampleColumns *columns = m_cache.object(pageIndex);
+    if (!columns) {
+        // Подкачка страницы: разбор её строк из отображённого файла
+        const PageInfo &info = m_pages[pageIndex];
+        columns = new SampleColumns;
+        columns->resize(info.count);
+
+        const char *pos = m_data + info.begin;
+        const char *end = m_data + info.end;
+        int written = 0;
+        while (pos < end && written < info.count) {
+            const char *eol = lineEnd(pos, end);
+            const char *first = pos;
+            while (first < eol && isSpace(*first)) {
+                ++first;
+            }
+
+            // Комментарии и ошибочные строки внутри страницы пропускаются так же, как при индексации
+            RawFrame frame;
+            if (first < eol && *first != '#' && FrameParser::parseLine(first, eol, frame)) {
+                columns->time[written] = frame.deviceTime;
+                columns->pitch[written] = frame.pitch;
+                columns->roll[written] = frame.roll;
+                columns->yaw[written] = frame.yaw;
+                columns->buttons[written] = (frame.patientDizziness ? SampleStore::PatientButton : 0) |
+                                            (frame.doctorDizziness ? SampleStore::DoctorButton : 0);
+                written++;
+            }
+            pos = eol + 1;
+        }
+
+        // Бюджет не меньше MinCachedPages страниц, поэтому новая страница в кэш помещается
+        m_cache.insert(pageIndex, columns, pageCost(*columns));
+    }
+
+    m_lastPage = pageIndex;
+    m_lastColumns = columns;
+    return *columns;
+}
+
+qint64 PagedLogFile::time(int index) const
+{
+    const int pageIndex = pageOf(index);
+    return page(pageIndex).time[index - m_pages[pageIndex].firstSample];
+}
+
+float PagedLogFile::angle(SampleStore::Axis axis, int index) const
+{
+    const int pageIndex = pageOf(index);
+    const SampleColumns &columns = page(pageIndex);
+    const int offset = index - m_pages[pageIndex].firstSample;
+
+    switch (axis) {
+    case SampleStore::Roll:
+        return columns.roll[offset];
+    case SampleStore::Yaw:
+        return columns.yaw[offset];
+    case SampleStore::Pitch:
+    default:
+        return columns.pitch[offset];
+    }
+}
+
+quint8 PagedLogFile::buttons(int index) const
+{
+    const int pageIndex = pageOf(index);
+    return page(pageIndex).buttons[index - m_pages[pageIndex].firstSample];
+}
+
+int PagedLogFile::findIndexByTime(qint64 time) const
+{
+    if (m_pages.isEmpty()) {
+        return -1;
+    }
+
+    // Сначала страница по индексу (без подкачки), затем поиск внутри одной страницы
+    const auto found = std::upper_bound(m_pages.cbegin(), m_pages.cend(), time,
+                                        [](qint64 value, const PageInfo &page) { return value < page.firstTime; });
+    const int pageIndex = static_cast<int>(found - m_pages.cbegin()) - 1;
+    if (pageIndex < 0) {
+        return -1;
+    }
+
+    const PageInfo &info = m_pages[pageIndex];
+    if (time >= info.lastTime) {
+        return info.firstSample + info.count - 1;
+    }
+
+    const SampleColumns &columns = page(pageIndex);
+    const qint64 *times = columns.time.constData();
+    const qint64 *inPage = std::upper_bound(times, times + info.count, time);
+    return info.firstSample + static_cast<int>(inPage - times) - 1;
+}
+
+qint64 PagedLogFile::cachedBytes() const
+{
+    return qint64(m_cache.totalCost()) * 1024;
+}
+
+qint64 PagedLogFile::memoryBudget() const
+{
+    return qint64(m_cache.maxCost()) * 1024;
+}
+
+void PagedLogFile::setMemoryBudget(qint64 bytes)
+{
+    const qint64 budget = qMax(bytes, MinCachedPages * pageBytes());
+    m_cache.setMaxCost(static_cast<int>(qMin<qint64>(budget / 1024, INT_MAX)));
+
+    // Уменьшение бюджета могло вытеснить последнюю страницу
+    m_lastPage = -1;
+    m_lastColumns = nullptr;
+}
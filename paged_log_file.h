@@ -0,0 +1,88 @@
+#ifndef PAGED_LOG_FILE_H
+#define PAGED_LOG_FILE_H
+
+#include <QtCore/QCache>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include "sample_store.h"
+
+struct LogFileContents;
+struct LogLoadControl;
+
+// Постраничный доступ к текстовому файлу исследования, который не помещается
+// в отведённую память (многочасовые амбулаторные записи на 60-500 Гц).
+// При открытии файл отображается в память и разбирается один раз без сохранения
+// записей - строится только разреженный индекс страниц (смещение в файле и
+// диапазон времени на каждые PageSize записей). Записи страницы разбираются при
+// первом обращении и держатся в LRU-кэше (QCache) в пределах бюджета памяти.
+//
+// Доступ только из одного потока (GUI): кэш меняется при чтении
+class PagedLogFile
+{
+public:
+    static const int PageSize = 4096;           // Записей на странице
+    static const int MinCachedPages = 16;       // Бюджет не меньше этого числа страниц
+
+    ~PagedLogFile();
+
+    // Построение индекса; contents.samples получает SampleStore поверх страниц
+    static bool open(const QString &fileName, qint64 memoryBudget,
+                     LogFileContents &contents, LogLoadControl *control = nullptr);
+
+    int size() const { return m_sampleCount; }
+    int pageCount() const { return m_pages.size(); }
+
+    qint64 time(int index) const;
+    float angle(SampleStore::Axis axis, int index) const;
+    quint8 buttons(int index) const;
+
+    // Индекс последней записи со временем <= time, -1 если все записи позже
+    int findIndexByTime(qint64 time) const;
+
+    // Память, занятая разобранными страницами
+    qint64 cachedBytes() const;
+    qint64 memoryBudget() const;
+    void setMemoryBudget(qint64 bytes);
+
+private:
+    struct PageInfo {
+        qint64 begin = 0;       // Смещение первой строки страницы в файле
+        qint64 end = 0;         // Смещение после последней строки
+        qint64 firstTime = 0;
+        qint64 lastTime = 0;
+        int firstSample = 0;    // Номер первой записи страницы во всём файле
+        int count = 0;
+    };
+
+    // Кусок файла, который индексируется в отдельном потоке
+    struct ScanChunk {
+        qint64 begin = 0;
+        qint64 end = 0;
+        qint64 lineCount = 0;
+        qint64 failedCount = 0;
+        QVector<qint64> failedLines;    // Номера строк внутри куска (с 0)
+        QVector<PageInfo> pages;
+    };
+
+    PagedLogFile() = default;
+
+    static void scanChunk(const char *data, ScanChunk &chunk, LogLoadControl *control);
+
+    int pageOf(int index) const;
+    const SampleColumns &page(int pageIndex) const;
+
+    QFile m_file;
+    const char *m_data = nullptr;
+    qint64 m_size = 0;
+    QVector<PageInfo> m_pages;
+    int m_sampleCount = 0;
+
+    // Ключ - номер страницы, стоимость - килобайты разобранных колонок
+    mutable QCache<int, SampleColumns> m_cache;
+    // Последняя страница: последовательный проход не обращается к хэшу кэша
+    mutable int m_lastPage = -1;
+    mutable const SampleColumns *m_lastColumns = nullptr;
+};
+
+#endif // PAGED_LOG_FILE_H
@@ -0,0 +1,103 @@
+#ifndef PLAYBACK_CURSOR_H
+#define PLAYBACK_CURSOR_H
+
+#include <QtCore/QtGlobal>
+#include "sample_store.h"
+
+// Позиция воспроизведения в хранилище записей: индекс последней записи со временем
+// не больше заданного (как SampleStore::findIndexByTime).
+// ОПТИМИЗАЦИЯ: поиск идёт от текущей позиции в обе стороны шагами 1, 2, 4, ...,
+// а затем двоичным поиском внутри найденного отрезка. За кадр воспроизведения курсор
+// сдвигается на несколько записей (при 32x и 100 Гц - примерно на 50), поэтому
+// шаг стоит O(log сдвига), в среднем O(1), вперёд и назад одинаково, а переход
+// в любое место записи - не дороже двоичного поиска по всему хранилищу
+class PlaybackCursor
+{
+public:
+    PlaybackCursor() = default;
+
+    void setStore(const SampleStore *samples)
+    {
+        m_samples = samples;
+        m_index = 0;
+    }
+
+    int index() const { return m_index; }
+    void setIndex(int index) { m_index = clamp(index); }
+
+    bool atStart() const { return m_index <= 0; }
+    bool atEnd() const { return !m_samples || m_index >= m_samples->size() - 1; }
+
+    // Сдвиг на frames записей (отрицательный - назад)
+    int step(int frames)
+    {
+        m_index = clamp(m_index + frames);
+        return m_index;
+    }
+
+    int seek(qint64 time)
+    {
+        if (!m_samples || m_samples->isEmpty()) {
+            m_index = 0;
+            return m_index;
+        }
+
+        const int n = m_samples->size();
+        m_index = clamp(m_index);
+
+        if (m_samples->time(m_index) <= time) {
+            // Вперёд: ищем первую запись позже time
+            int low = m_index;          // time(low) <= time
+            int stride = 1;
+            int high = low + stride;
+            while (high < n && m_samples->time(high) <= time) {
+                low = high;
+                stride *= 2;
+                high = low + stride;
+            }
+            m_index = lastNotAfter(low, qMin(high, n), time);
+        } else {
+            // Назад: ищем запись не позже time
+            int high = m_index;         // time(high) > time
+            int stride = 1;
+            int low = high - stride;
+            while (low >= 0 && m_samples->time(low) > time) {
+                high = low;
+                stride *= 2;
+                low = high - stride;
+            }
+            // Время раньше первой записи - курсор на первой записи
+            m_index = low < 0 && m_samples->time(0) > time ? 0
+                                                           : lastNotAfter(qMax(low, 0), high, time);
+        }
+        return m_index;
+    }
+
+private:
+    int clamp(int index) const
+    {
+        if (!m_samples || m_samples->isEmpty()) {
+            return 0;
+        }
+        return qBound(0, index, m_samples->size() - 1);
+    }
+
+    // Последний индекс в [low, high) со временем не больше time; time(low) <= time
+    int lastNotAfter(int low, int high, qint64 time) const
+    {
+        while (high - low > 1) {
+            const int middle = low + (high - low) / 2;
+            if (m_samples->time(middle) <= time) {
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    const SampleStore *m_samples = nullptr;
+    int m_index = 0;
+};
+
+#endif // PLAYBACK_CURSOR_H
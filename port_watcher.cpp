@@ -0,0 +1,162 @@
+#include "port_watcher.h"
+#include <QDebug>
+#include <QSocketNotifier>
+#include <QtSerialPort/QSerialPortInfo>
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+PortWatcher::PortWatcher(QObject *parent) : QObject(parent)
+{
+    // Таймеры - дочерние объекты, переезжают в поток вместе с наблюдателем
+    m_debounceTimer = new QTimer(this);
+    m_debounceTimer->setSingleShot(true);
+    // udev создаёт узел /dev/ttyUSB* немного позже события ядра
+    m_debounceTimer->setInterval(300);
+    connect(m_debounceTimer, &QTimer::timeout, this, [this]() { scanPorts(false); });
+
+    m_pollTimer = new QTimer(this);
+    m_pollTimer->setInterval(2000);
+    connect(m_pollTimer, &QTimer::timeout, this, [this]() { scanPorts(false); });
+}
+
+PortWatcher::~PortWatcher()
+{
+    closeDeviceEvents();
+}
+
+void PortWatcher::start()
+{
+    if (!openDeviceEvents()) {
+        m_pollTimer->start();
+    }
+
+    scanPorts(true);
+}
+
+void PortWatcher::stop()
+{
+    m_debounceTimer->stop();
+    m_pollTimer->stop();
+    closeDeviceEvents();
+}
+
+void PortWatcher::refresh()
+{
+    scanPorts(true);
+}
+
+void PortWatcher::scanPorts(bool force)
+{
+    QStringList ports;
+    const QList<QSerialPortInfo> infos = QSerialPortInfo::availablePorts();
+    ports.reserve(infos.size());
+    for (const QSerialPortInfo &info : infos) {
+        ports << info.portName();
+    }
+
+    // Сортируем порты для удобства
+    std::sort(ports.begin(), ports.end());
+
+    if (!force && m_hasPorts && ports == m_ports) {
+        return;
+    }
+
+    m_ports = ports;
+    m_hasPorts = true;
+    emit portsChanged(m_ports);
+}
+
+#ifdef Q_OS_LINUX
+
+bool PortWatcher::openDeviceEvents()
+{
+    m_eventSocket = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (m_eventSocket < 0) {
+        qDebug() << "Port watcher: netlink is unavailable, falling back to polling";
+        return false;
+    }
+
+    sockaddr_nl address;
+    std::memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_pid = 0;
+    address.nl_groups = 1; // События ядра (группа KOBJECT_UEVENT)
+
+    if (::bind(m_eventSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+        qDebug() << "Port watcher: cannot bind netlink socket, falling back to polling";
+        closeDeviceEvents();
+        return false;
+    }
+
+    m_eventNotifier = new QSocketNotifier(m_eventSocket, QSocketNotifier::Read, this);
+    connect(m_eventNotifier, &QSocketNotifier::activated, this, &PortWatcher::readDeviceEvents);
+    return true;
+}
+
+void PortWatcher::closeDeviceEvents()
+{
+    if (m_eventNotifier) {
+        m_eventNotifier->setEnabled(false);
+        delete m_eventNotifier;
+        m_eventNotifier = nullptr;
+    }
+
+    if (m_eventSocket >= 0) {
+        ::close(m_eventSocket);
+        m_eventSocket = -1;
+    }
+}
+
+void PortWatcher::readDeviceEvents()
+{
+    // Сообщение uevent: "add@/devices/...\0ACTION=add\0SUBSYSTEM=tty\0..."
+    char message[4096];
+    bool portEvent = false;
+
+    for (;;) {
+        const ssize_t size = ::recv(m_eventSocket, message, sizeof(message) - 1, 0);
+        if (size <= 0) {
+            break; // Очередь сокета прочитана (EAGAIN)
+        }
+        message[size] = '\0';
+
+        bool addOrRemove = false;
+        bool tty = false;
+        for (const char *field = message; field < message + size; field += std::strlen(field) + 1) {
+            if (std::strcmp(field, "ACTION=add") == 0 || std::strcmp(field, "ACTION=remove") == 0) {
+                addOrRemove = true;
+            } else if (std::strcmp(field, "SUBSYSTEM=tty") == 0) {
+                tty = true;
+            }
+        }
+
+        portEvent = portEvent || (addOrRemove && tty);
+    }
+
+    if (portEvent) {
+        m_debounceTimer->start();
+    }
+}
+
+#else
+
+bool PortWatcher::openDeviceEvents()
+{
+    return false;
+}
+
+void PortWatcher::closeDeviceEvents()
+{
+}
+
+void PortWatcher::readDeviceEvents()
+{
+}
+
+#endif
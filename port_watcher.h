@@ -0,0 +1,51 @@
+#ifndef PORT_WATCHER_H
+#define PORT_WATCHER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+
+class QSocketNotifier;
+
+// Отслеживание подключения и отключения последовательных портов.
+// Перечисление QSerialPortInfo::availablePorts() медленное (на машинах с большим
+// числом виртуальных TTY - десятки миллисекунд), поэтому выполняется в отдельном
+// потоке и только по событию. На Linux события приходят от ядра через netlink
+// (uevent подсистемы tty), на остальных системах список опрашивается раз в 2 секунды.
+// Сигнал portsChanged отправляется только при изменении списка.
+class PortWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PortWatcher(QObject *parent = nullptr);
+    ~PortWatcher();
+
+public slots:
+    // Запуск наблюдения в потоке, куда перенесён объект
+    void start();
+    void stop();
+    // Принудительное перечисление (кнопка "Обновить список портов")
+    void refresh();
+
+signals:
+    void portsChanged(const QStringList &ports);
+
+private slots:
+    void readDeviceEvents();
+
+private:
+    bool openDeviceEvents();
+    void closeDeviceEvents();
+    void scanPorts(bool force);
+
+    QStringList m_ports;
+    bool m_hasPorts = false;
+
+    int m_eventSocket = -1;
+    QSocketNotifier *m_eventNotifier = nullptr;
+    QTimer *m_debounceTimer = nullptr;  // Одно перечисление на пачку событий
+    QTimer *m_pollTimer = nullptr;      // Если событий от системы нет
+};
+
+#endif // PORT_WATCHER_H
@@ -0,0 +1,181 @@
+#ifndef REORDER_WINDOW_H
+#define REORDER_WINDOW_H
+
+#include <QtCore/QtGlobal>
+#include "frame_parser.h"
+
+// Восстановление порядка бинарных пакетов, пришедших по UDP.
+// Датаграммы могут теряться, дублироваться и приходить не по порядку.
+// Пакеты с номером внутри небольшого окна придерживаются, пока не придут
+// пропущенные перед ними. Пропуск ждём не дольше MaxHoldMs: для живого
+// мониторинга лучше потерять отсчёт, чем показать устаревший.
+// Пакеты, опоздавшие за окно, отбрасываются - порядок выдачи строго возрастающий,
+// что важно для пересчёта времени устройства (DeviceTimebase).
+class ReorderWindow
+{
+public:
+    static const int Size = 8;              // Степень двойки: индекс слота = номер & (Size - 1)
+    static const int MaxHoldMs = 30;        // Сколько ждём пропущенный пакет
+    static const int RestartDistance = 1024; // Скачок номера дальше - перезапуск устройства
+
+    ReorderWindow() { reset(); }
+
+    void reset()
+    {
+        for (int i = 0; i < Size; ++i) {
+            m_slots[i].occupied = false;
+        }
+        m_hasExpected = false;
+        m_expected = 0;
+        m_buffered = 0;
+        m_lostPackets = 0;
+        m_lateFrames = 0;
+        m_duplicateFrames = 0;
+    }
+
+    // Принимает пакет с номером и выдаёт onFrame(const RawFrame &, double arrivalTime)
+    // для всех пакетов, которые теперь можно отдать по порядку
+    template <typename Callback>
+    void insert(const RawFrame &frame, double arrivalTime, Callback &&onFrame);
+
+    // Отдаёт придержанные пакеты, если пропуск перед ними ждёт дольше MaxHoldMs.
+    // Вызывается при каждой датаграмме и по таймеру, если поток данных прервался
+    template <typename Callback>
+    void flushStale(double now, Callback &&onFrame);
+
+    int buffered() const { return m_buffered; }
+    quint64 lostPackets() const { return m_lostPackets; }
+    quint64 lateFrames() const { return m_lateFrames; }
+    quint64 duplicateFrames() const { return m_duplicateFrames; }
+
+private:
+    struct Slot {
+        RawFrame frame;
+        double arrivalTime;
+        bool occupied;
+    };
+
+    Slot &slot(quint16 sequence) { return m_slots[sequence & (Size - 1)]; }
+
+    // Выдаёт подряд идущие пакеты начиная с ожидаемого
+    template <typename Callback>
+    void release(Callback &onFrame);
+
+    // Сдвигает окно на один номер: пакет выдаётся или считается потерянным
+    template <typename Callback>
+    void advance(Callback &onFrame);
+
+    Slot m_slots[Size];
+    bool m_hasExpected;
+    quint16 m_expected;
+    int m_buffered;
+    quint64 m_lostPackets;
+    quint64 m_lateFrames;
+    quint64 m_duplicateFrames;
+};
+
+template <typename Callback>
+void ReorderWindow::insert(const RawFrame &frame, double arrivalTime, Callback &&onFrame)
+{
+    if (!m_hasExpected) {
+        m_hasExpected = true;
+        m_expected = frame.sequence;
+    }
+
+    // Расстояние вперёд от ожидаемого номера с учётом переполнения 16-битного счётчика
+    const quint16 distance = static_cast<quint16>(frame.sequence - m_expected);
+
+    if (distance >= 0x8000) {
+        const int behind = 0x10000 - distance;
+        if (behind <= RestartDistance) {
+            // Опоздал: на его место уже выданы более новые отсчёты
+            m_lateFrames++;
+            return;
+        }
+
+        // Номера начались заново - устройство перезапустилось, придержанное отдаём
+        while (m_buffered > 0) {
+            advance(onFrame);
+        }
+        m_expected = frame.sequence;
+    } else if (distance > RestartDistance) {
+        while (m_buffered > 0) {
+            advance(onFrame);
+        }
+        m_expected = frame.sequence;
+    } else if (distance >= Size) {
+        // Пакет за пределами окна: сдвигаем окно, пропуски считаем потерянными
+        while (m_buffered > 0 && static_cast<quint16>(frame.sequence - m_expected) >= Size) {
+            advance(onFrame);
+        }
+        // Все номера перед пришедшим уже засчитаны потерянными - ждать их незачем,
+        // пакет выдаётся сразу
+        const quint16 gap = static_cast<quint16>(frame.sequence - m_expected);
+        if (gap >= Size) {
+            m_lostPackets += gap;
+            m_expected = frame.sequence;
+        }
+    }
+
+    Slot &target = slot(frame.sequence);
+    if (target.occupied) {
+        m_duplicateFrames++;
+        return;
+    }
+
+    target.frame = frame;
+    target.arrivalTime = arrivalTime;
+    target.occupied = true;
+    m_buffered++;
+
+    release(onFrame);
+}
+
+template <typename Callback>
+void ReorderWindow::flushStale(double now, Callback &&onFrame)
+{
+    while (m_buffered > 0) {
+        // Самый старый придержанный пакет определяет, сколько уже ждём
+        double oldest = now;
+        for (int i = 0; i < Size; ++i) {
+            if (m_slots[i].occupied && m_slots[i].arrivalTime < oldest) {
+                oldest = m_slots[i].arrivalTime;
+            }
+        }
+
+        if (now - oldest < MaxHoldMs) {
+            return;
+        }
+
+        // Пропускаем недостающие номера до ближайшего пришедшего пакета
+        while (!slot(m_expected).occupied) {
+            m_lostPackets++;
+            m_expected++;
+        }
+        release(onFrame);
+    }
+}
+
+template <typename Callback>
+void ReorderWindow::release(Callback &onFrame)
+{
+    while (m_buffered > 0 && slot(m_expected).occupied) {
+        advance(onFrame);
+    }
+}
+
+template <typename Callback>
+void ReorderWindow::advance(Callback &onFrame)
+{
+    Slot &current = slot(m_expected);
+    if (current.occupied) {
+        current.occupied = false;
+        m_buffered--;
+        onFrame(current.frame, current.arrivalTime);
+    } else {
+        m_lostPackets++;
+    }
+    m_expected++;
+}
+
+#endif // REORDER_WINDOW_H
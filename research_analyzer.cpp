@@ -0,0 +1,223 @@
+// Пакетный анализ исследований MonitorHead без интерфейса.
+// Загружает файлы исследований (txt, mhs, mha) параллельно на пуле потоков и
+// считает по каждому: длительность, диапазон движения по осям, пиковую и среднюю
+// угловую скорость (как LogReader в программе), число и длительность эпизодов
+// головокружения. Результат - CSV или JSON.
+//
+// Пример: MonitorHeadAnalyze ~/Documents/MonitorHead/research -o review.csv
+//         MonitorHeadAnalyze --format json --window 1.0 Research_0001*.mha
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include "study_analysis.h"
+
+namespace {
+
+const char *const kAxisNames[] = {"pitch", "roll", "yaw"};
+
+QStringList collectInputs(const QStringList &arguments)
+{
+    QStringList files;
+    for (const QString &argument : arguments) {
+        const QFileInfo info(argument);
+        if (info.isDir()) {
+            QDirIterator it(argument, {"*.txt", "*.mha", "*.mhs"}, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                files << it.next();
+            }
+        } else {
+            files << argument;
+        }
+    }
+    files.sort();
+    return files;
+}
+
+QString csvField(const QString &value)
+{
+    if (value.contains(',') || value.contains('"') || value.contains('\n')) {
+        QString quoted = value;
+        quoted.replace('"', "\"\"");
+        return '"' + quoted + '"';
+    }
+    return value;
+}
+
+QByteArray toCsv(const QVector<StudyMetrics> &results)
+{
+    QStringList header = {"file", "research_number", "recorded_at", "samples", "failed_lines",
+                          "duration_s", "sample_rate_hz"};
+    for (const char *axis : kAxisNames) {
+        const QString name = QString::fromLatin1(axis);
+        header << name + "_min" << name + "_max" << name + "_range"
+               << name + "_peak_speed" << name + "_mean_speed";
+    }
+    header << "patient_episodes" << "patient_total_s" << "patient_longest_s"
+           << "doctor_episodes" << "doctor_total_s" << "doctor_longest_s" << "error";
+
+    QStringList lines;
+    lines << header.join(',');
+
+    for (const StudyMetrics &m : results) {
+        QStringList row = {csvField(m.file), m.researchNumber, m.recordedAt,
+                           QString::number(m.samples), QString::number(m.failedLines),
+                           QString::number(m.duration / 1000.0, 'f', 3),
+                           QString::number(m.sampleRate, 'f', 1)};
+        for (const AxisMetrics &axis : m.axes) {
+            row << QString::number(axis.min, 'f', 2) << QString::number(axis.max, 'f', 2)
+                << QString::number(axis.max - axis.min, 'f', 2)
+                << QString::number(axis.peakSpeed, 'f', 2) << QString::number(axis.meanSpeed, 'f', 2);
+        }
+        for (const DizzinessMetrics *dizziness : {&m.patient, &m.doctor}) {
+            row << QString::number(dizziness->episodes)
+                << QString::number(dizziness->total / 1000.0, 'f', 3)
+                << QString::number(dizziness->longest / 1000.0, 'f', 3);
+        }
+        row << csvField(m.error);
+        lines << row.join(',');
+    }
+
+    return (lines.join('\n') + '\n').toUtf8();
+}
+
+QByteArray toJson(const QVector<StudyMetrics> &results)
+{
+    QJsonArray studies;
+    for (const StudyMetrics &m : results) {
+        QJsonObject study;
+        study["file"] = m.file;
+        if (!m.ok) {
+            study["error"] = m.error;
+            studies.append(study);
+            continue;
+        }
+
+        study["researchNumber"] = m.researchNumber;
+        study["recordedAt"] = m.recordedAt;
+        study["samples"] = m.samples;
+        study["failedLines"] = m.failedLines;
+        study["durationMs"] = m.duration;
+        study["sampleRateHz"] = m.sampleRate;
+
+        for (int axis = 0; axis < 3; ++axis) {
+            const AxisMetrics &a = m.axes[axis];
+            QJsonObject object;
+            object["min"] = a.min;
+            object["max"] = a.max;
+            object["range"] = a.max - a.min;
+            object["peakSpeed"] = a.peakSpeed;
+            object["meanSpeed"] = a.meanSpeed;
+            study[kAxisNames[axis]] = object;
+        }
+
+        auto dizzinessJson = [](const DizzinessMetrics &d) {
+            QJsonObject object;
+            object["episodes"] = d.episodes;
+            object["totalMs"] = d.total;
+            object["longestMs"] = d.longest;
+            return object;
+        };
+        study["patientDizziness"] = dizzinessJson(m.patient);
+        study["doctorDizziness"] = dizzinessJson(m.doctor);
+        studies.append(study);
+    }
+
+    return QJsonDocument(studies).toJson(QJsonDocument::Indented);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("MonitorHeadAnalyze");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Пакетный анализ исследований MonitorHead");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("inputs", "Файлы исследований (txt, mhs, mha) или папки с ними.", "inputs...");
+
+    QCommandLineOption outputOption({"o", "output"}, "Файл результата (по умолчанию стандартный вывод).", "file");
+    QCommandLineOption formatOption({"f", "format"}, "csv или json (по умолчанию по расширению файла, иначе csv).", "format");
+    QCommandLineOption jobsOption({"j", "jobs"}, "Число исследований, обрабатываемых параллельно.", "n",
+                                  QString::number(QThread::idealThreadCount()));
+    QCommandLineOption windowOption("window", "Окно сглаживания скорости, с (0.1-3).", "seconds", "0.5");
+    QCommandLineOption stepOption("step", "Шаг расчёта скорости, мс.", "ms", "100");
+    parser.addOptions({outputOption, formatOption, jobsOption, windowOption, stepOption});
+    parser.process(app);
+
+    const QStringList inputs = collectInputs(parser.positionalArguments());
+    if (inputs.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    const QString output = parser.value(outputOption);
+    QString format = parser.value(formatOption);
+    if (format.isEmpty()) {
+        format = output.endsWith(".json", Qt::CaseInsensitive) ? "json" : "csv";
+    }
+    if (format != "csv" && format != "json") {
+        fprintf(stderr, "Unknown format %s\n", qPrintable(format));
+        return 1;
+    }
+
+    StudyAnalysis::Options options;
+    options.window = qBound(0.1f, parser.value(windowOption).toFloat(), 3.0f);
+    options.step = qMax<qint64>(1, parser.value(stepOption).toLongLong());
+
+    // Каждое исследование - отдельная задача; результаты пишутся в свои ячейки,
+    // поэтому порядок вывода совпадает с порядком файлов
+    QVector<StudyMetrics> results(inputs.size());
+    std::atomic<int> done{0};
+    QElapsedTimer timer;
+    timer.start();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(1, parser.value(jobsOption).toInt()));
+    for (int i = 0; i < inputs.size(); ++i) {
+        pool.start([&, i]() {
+            results[i] = StudyAnalysis::analyzeFile(inputs[i], options);
+            const int finished = ++done;
+            if (!results[i].ok) {
+                fprintf(stderr, "%s: %s\n", qPrintable(inputs[i]), qPrintable(results[i].error));
+            }
+            if (finished % 100 == 0) {
+                fprintf(stderr, "%d/%d\n", finished, int(inputs.size()));
+            }
+        });
+    }
+    pool.waitForDone();
+
+    const QByteArray report = format == "json" ? toJson(results) : toCsv(results);
+
+    if (output.isEmpty()) {
+        fwrite(report.constData(), 1, report.size(), stdout);
+    } else {
+        QFile file(output);
+        if (!file.open(QIODevice::WriteOnly) || file.write(report) != report.size()) {
+            fprintf(stderr, "Cannot write %s: %s\n", qPrintable(output), qPrintable(file.errorString()));
+            return 1;
+        }
+    }
+
+    const int failed = std::count_if(results.cbegin(), results.cend(), [](const StudyMetrics &m) { return !m.ok; });
+    fprintf(stderr, "Analyzed %d studies, failed %d in %.1f s\n",
+            int(inputs.size()) - failed, failed, timer.elapsed() / 1000.0);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,536 @@
+#include "research_archive.h"
+#include "log_file_loader.h"
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = {'M', 'H', 'A', '1'};
+
+const char kTextBlock = 'T';
+const char kSamplesBlock = 'S';
+const char kEndBlock = 'E';
+
+// Блок больше этого размера считается повреждённым (обычный блок записей ~20 КБ)
+const quint64 kMaxPayload = 64 * 1024 * 1024;
+
+// Таблица CRC-32 (полином 0xEDB88320, как в zip/png)
+struct Crc32Table {
+    quint32 values[256];
+
+    Crc32Table()
+    {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            }
+            values[i] = crc;
+        }
+    }
+};
+
+const Crc32Table kCrc32Table;
+
+inline quint64 zigZag(qint64 value)
+{
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+inline qint64 unZigZag(quint64 value)
+{
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+inline void appendVarint(QByteArray &out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+inline bool readVarint(const uchar *&pos, const uchar *end, quint64 &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+        const uchar byte = *pos++;
+        value |= static_cast<quint64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool readSigned(const uchar *&pos, const uchar *end, qint64 &value)
+{
+    quint64 raw;
+    if (!readVarint(pos, end, raw)) {
+        return false;
+    }
+    value = unZigZag(raw);
+    return true;
+}
+
+// Угол в сотых долях градуса - точность текстового файла исследования
+inline qint32 toCentiDegrees(float angle)
+{
+    return static_cast<qint32>(qRound(static_cast<double>(angle) * 100.0));
+}
+
+inline float fromCentiDegrees(qint64 value)
+{
+    return static_cast<float>(value) / 100.0f;
+}
+
+} // namespace
+
+quint32 ResearchArchive::crc32(const char *data, qsizetype size)
+{
+    quint32 crc = 0xFFFFFFFFu;
+    for (qsizetype i = 0; i < size; ++i) {
+        crc = (crc >> 8) ^ kCrc32Table.values[(crc ^ static_cast<quint8>(data[i])) & 0xFF];
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+bool ResearchArchive::isArchiveFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    char magic[sizeof(kMagic)];
+    return file.read(magic, sizeof(magic)) == sizeof(magic) &&
+           std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool ResearchArchive::load(const QString &fileName, LogFileContents &contents, LogLoadControl *control)
+{
+    contents = LogFileContents();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        contents.errorString = file.errorString();
+        return false;
+    }
+
+    if (control) {
+        control->bytesTotal = file.size();
+    }
+
+    ResearchArchiveReader reader(&file);
+    SampleColumns columns;
+    QByteArray headerText;
+    bool samplesSeen = false;
+
+    for (;;) {
+        if (control && control->isCancelled()) {
+            contents.cancelled = true;
+            contents.errorString = "загрузка отменена";
+            return false;
+        }
+
+        const ResearchArchiveReader::TokenType token = reader.readNext();
+        if (token == ResearchArchiveReader::EndOfArchive) {
+            break;
+        }
+        if (token == ResearchArchiveReader::Invalid) {
+            contents.errorString = reader.errorString();
+            return false;
+        }
+
+        if (token == ResearchArchiveReader::Corrupted) {
+            // Как строки с ошибками в текстовом файле: блок пропускается, остальные читаются
+            qWarning() << "Archive" << fileName << ": block" << reader.blockIndex()
+                       << "skipped:" << reader.blockError();
+            contents.failedLineCount++;
+            if (contents.failedLines.size() < LogFileLoader::MaxReportedLines) {
+                contents.failedLines.append(reader.blockIndex() + 1);
+            }
+        } else if (token == ResearchArchiveReader::Text) {
+            // Заголовок - комментарии до первых записей, как в текстовом файле
+            if (!samplesSeen) {
+                headerText += reader.text().toUtf8();
+                headerText += '\n';
+            }
+        } else {
+            samplesSeen = true;
+            const SampleColumns &block = reader.samples();
+            const qsizetype offset = columns.size();
+            columns.resize(offset + block.size());
+            std::copy(block.time.constBegin(), block.time.constEnd(), columns.time.begin() + offset);
+            std::copy(block.pitch.constBegin(), block.pitch.constEnd(), columns.pitch.begin() + offset);
+            std::copy(block.roll.constBegin(), block.roll.constEnd(), columns.roll.begin() + offset);
+            std::copy(block.yaw.constBegin(), block.yaw.constEnd(), columns.yaw.begin() + offset);
+            std::copy(block.buttons.constBegin(), block.buttons.constEnd(), columns.buttons.begin() + offset);
+        }
+
+        if (control) {
+            control->bytesParsed = file.pos();
+        }
+    }
+
+    if (!reader.isComplete()) {
+        qWarning() << "Archive" << fileName << "has no end block, recording was interrupted";
+    }
+
+    if (reader.corruptedBlockCount() > 0) {
+        contents.errorString = QString("архив повреждён: пропущено блоков - %1")
+                                   .arg(reader.corruptedBlockCount());
+    }
+
+    contents.headerLines = LogFileLoader::readHeader(headerText.constData(), headerText.size());
+    contents.totalLines = reader.sampleCount();
+    columns.squeeze();
+    contents.samples = SampleStore(std::move(columns));
+    return true;
+}
+
+bool ResearchArchive::write(const QString &fileName, const QStringList &headerLines,
+                            const SampleStore &samples, QString *errorString)
+{
+    QString error;
+    if (!errorString) {
+        errorString = &error;
+    }
+
+    // Файл заменяется целиком только после успешной записи
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    QStringList comments;
+    for (const QString &line : headerLines) {
+        comments << (line.startsWith('#') ? "#" + line : "# " + line);
+    }
+
+    ResearchArchiveWriter writer(&file);
+    bool ok = comments.isEmpty() || writer.writeText(comments.join('\n'));
+    for (int i = 0; ok && i < samples.size(); ++i) {
+        const quint8 buttons = (samples.patientDizziness(i) ? SampleStore::PatientButton : 0) |
+                               (samples.doctorDizziness(i) ? SampleStore::DoctorButton : 0);
+        ok = writer.writeSample(samples.time(i), samples.pitch(i), samples.roll(i), samples.yaw(i), buttons);
+    }
+    ok = ok && writer.finish();
+
+    if (!ok) {
+        *errorString = writer.errorString();
+        file.cancelWriting();
+        return false;
+    }
+
+    if (!file.commit()) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+ResearchArchiveWriter::ResearchArchiveWriter(QIODevice *device)
+    : m_device(device)
+{
+    m_samples.reserve(ResearchArchive::BlockSamples * 6);
+}
+
+QString ResearchArchiveWriter::errorString() const
+{
+    return m_device->errorString();
+}
+
+bool ResearchArchiveWriter::writeBlock(char type, const QByteArray &payload)
+{
+    if (m_failed) {
+        return false;
+    }
+
+    QByteArray block;
+    if (!m_started) {
+        block.append(kMagic, sizeof(kMagic));
+        m_started = true;
+    }
+
+    block.append(type);
+    appendVarint(block, static_cast<quint64>(payload.size()));
+    const quint32 crc = ResearchArchive::crc32(payload.constData(), payload.size());
+    for (int shift = 0; shift < 32; shift += 8) {
+        block.append(static_cast<char>((crc >> shift) & 0xFF));
+    }
+    block.append(payload);
+
+    m_failed = m_device->write(block) != block.size();
+    return !m_failed;
+}
+
+bool ResearchArchiveWriter::writeText(const QString &text)
+{
+    // Порядок комментариев и записей в потоке сохраняется
+    return flushBlock() && writeBlock(kTextBlock, text.toUtf8());
+}
+
+bool ResearchArchiveWriter::writeSample(qint64 time, float pitch, float roll, float yaw, quint8 buttons)
+{
+    // Первая запись блока хранит время целиком: блок декодируется без предыдущих
+    if (m_blockCount == 0) {
+        appendVarint(m_samples, zigZag(time));
+        m_prevDelta = 0;
+    } else {
+        const qint64 delta = time - m_prevTime;
+        appendVarint(m_samples, zigZag(delta - m_prevDelta));
+        m_prevDelta = delta;
+    }
+    m_prevTime = time;
+
+    const qint32 centiPitch = toCentiDegrees(pitch);
+    const qint32 centiRoll = toCentiDegrees(roll);
+    const qint32 centiYaw = toCentiDegrees(yaw);
+    appendVarint(m_samples, zigZag(centiPitch - m_prevPitch));
+    appendVarint(m_samples, zigZag(centiRoll - m_prevRoll));
+    appendVarint(m_samples, zigZag(centiYaw - m_prevYaw));
+    m_prevPitch = centiPitch;
+    m_prevRoll = centiRoll;
+    m_prevYaw = centiYaw;
+
+    if (m_runLength > 0 && buttons != m_runValue) {
+        appendRun();
+    }
+    m_runValue = buttons;
+    m_runLength++;
+
+    m_blockCount++;
+    m_sampleCount++;
+
+    if (m_blockCount == ResearchArchive::BlockSamples) {
+        return flushBlock();
+    }
+    return !m_failed;
+}
+
+void ResearchArchiveWriter::appendRun()
+{
+    m_runs.append(static_cast<char>(m_runValue));
+    appendVarint(m_runs, static_cast<quint64>(m_runLength));
+    m_runCount++;
+    m_runLength = 0;
+}
+
+bool ResearchArchiveWriter::flushBlock()
+{
+    if (m_blockCount == 0) {
+        return !m_failed;
+    }
+
+    if (m_runLength > 0) {
+        appendRun();
+    }
+
+    // Данные блока: число записей, записи, серии кнопок
+    QByteArray payload;
+    payload.reserve(m_samples.size() + m_runs.size() + 16);
+    appendVarint(payload, static_cast<quint64>(m_blockCount));
+    payload.append(m_samples);
+    appendVarint(payload, static_cast<quint64>(m_runCount));
+    payload.append(m_runs);
+
+    m_samples.clear();
+    m_runs.clear();
+    m_runCount = 0;
+    m_blockCount = 0;
+    m_prevTime = 0;
+    m_prevDelta = 0;
+    m_prevPitch = 0;
+    m_prevRoll = 0;
+    m_prevYaw = 0;
+
+    return writeBlock(kSamplesBlock, payload);
+}
+
+bool ResearchArchiveWriter::finish()
+{
+    QByteArray payload;
+    appendVarint(payload, static_cast<quint64>(m_sampleCount));
+    return flushBlock() && writeBlock(kEndBlock, payload);
+}
+
+ResearchArchiveReader::ResearchArchiveReader(QIODevice *device)
+    : m_device(device)
+{
+}
+
+ResearchArchiveReader::TokenType ResearchArchiveReader::fail(const QString &message)
+{
+    m_errorString = message;
+    return Invalid;
+}
+
+// Длина блока прочитана, поэтому следующий блок находится и без данных этого
+ResearchArchiveReader::TokenType ResearchArchiveReader::skip(const QString &message)
+{
+    m_corruptedBlocks++;
+    m_blockError = message;
+    return Corrupted;
+}
+
+ResearchArchiveReader::TokenType ResearchArchiveReader::readNext()
+{
+    if (!m_errorString.isEmpty()) {
+        return Invalid;
+    }
+
+    if (!m_started) {
+        char magic[sizeof(kMagic)];
+        if (m_device->read(magic, sizeof(magic)) != sizeof(magic) ||
+            std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+            return fail("это не архив исследования");
+        }
+        m_started = true;
+    }
+
+    char type;
+    if (m_complete || !m_device->getChar(&type)) {
+        // Файл без блока конца (запись прервалась) читается до последнего целого блока
+        return EndOfArchive;
+    }
+
+    quint64 size = 0;
+    int shift = 0;
+    char byte = 0;
+    do {
+        if (shift >= 64 || !m_device->getChar(&byte)) {
+            return EndOfArchive;
+        }
+        size |= static_cast<quint64>(static_cast<uchar>(byte) & 0x7F) << shift;
+        shift += 7;
+    } while (static_cast<uchar>(byte) & 0x80);
+
+    if (size > kMaxPayload) {
+        return fail(QString("архив повреждён (блок %1)").arg(m_blockIndex));
+    }
+
+    uchar crcBytes[4];
+    if (m_device->read(reinterpret_cast<char *>(crcBytes), 4) != 4) {
+        return EndOfArchive;
+    }
+    const quint32 expectedCrc = static_cast<quint32>(crcBytes[0]) |
+                                (static_cast<quint32>(crcBytes[1]) << 8) |
+                                (static_cast<quint32>(crcBytes[2]) << 16) |
+                                (static_cast<quint32>(crcBytes[3]) << 24);
+
+    const QByteArray payload = m_device->read(static_cast<qint64>(size));
+    if (payload.size() != static_cast<qsizetype>(size)) {
+        return EndOfArchive; // Недописанный последний блок
+    }
+
+    m_blockIndex++;
+
+    if (ResearchArchive::crc32(payload.constData(), payload.size()) != expectedCrc) {
+        return skip("неверная контрольная сумма");
+    }
+
+    switch (type) {
+    case kTextBlock:
+        m_text = QString::fromUtf8(payload.constData(), payload.size());
+        return Text;
+    case kSamplesBlock:
+        if (!decodeSamples(payload)) {
+            return skip("неверные данные записей");
+        }
+        m_sampleCount += m_columns.size();
+        return Samples;
+    case kEndBlock: {
+        // Записи пропущенных блоков неизвестны, поэтому итог сверяется только без них
+        const uchar *pos = reinterpret_cast<const uchar *>(payload.constData());
+        quint64 total = 0;
+        if (!readVarint(pos, pos + payload.size(), total) ||
+            (m_corruptedBlocks == 0 && total != static_cast<quint64>(m_sampleCount))) {
+            return fail("архив повреждён: не совпадает число записей");
+        }
+        m_complete = true;
+        return EndOfArchive;
+    }
+    default:
+        // Тип не входит в контрольную сумму - испорченный байт типа не должен обрывать чтение
+        return skip("неизвестный тип блока");
+    }
+}
+
+bool ResearchArchiveReader::decodeSamples(const QByteArray &payload)
+{
+    const uchar *pos = reinterpret_cast<const uchar *>(payload.constData());
+    const uchar *end = pos + payload.size();
+
+    quint64 count;
+    // Запись занимает не меньше 4 байт - так отсекаются явно неверные счётчики
+    if (!readVarint(pos, end, count) || count > static_cast<quint64>(payload.size() / 4)) {
+        return false;
+    }
+
+    m_columns.resize(static_cast<qsizetype>(count));
+    qint64 *time = m_columns.time.data();
+    float *pitch = m_columns.pitch.data();
+    float *roll = m_columns.roll.data();
+    float *yaw = m_columns.yaw.data();
+
+    qint64 prevTime = 0;
+    qint64 prevDelta = 0;
+    qint64 centiPitch = 0;
+    qint64 centiRoll = 0;
+    qint64 centiYaw = 0;
+
+    for (quint64 i = 0; i < count; ++i) {
+        qint64 value;
+        if (!readSigned(pos, end, value)) {
+            return false;
+        }
+        if (i == 0) {
+            prevTime = value;
+        } else {
+            prevDelta += value;
+            prevTime += prevDelta;
+        }
+        time[i] = prevTime;
+
+        qint64 dPitch, dRoll, dYaw;
+        if (!readSigned(pos, end, dPitch) || !readSigned(pos, end, dRoll) || !readSigned(pos, end, dYaw)) {
+            return false;
+        }
+        centiPitch += dPitch;
+        centiRoll += dRoll;
+        centiYaw += dYaw;
+        pitch[i] = fromCentiDegrees(centiPitch);
+        roll[i] = fromCentiDegrees(centiRoll);
+        yaw[i] = fromCentiDegrees(centiYaw);
+    }
+
+    // Серии состояний кнопок должны покрыть блок ровно
+    quint64 runCount;
+    if (!readVarint(pos, end, runCount)) {
+        return false;
+    }
+
+    quint8 *buttons = m_columns.buttons.data();
+    quint64 filled = 0;
+    for (quint64 run = 0; run < runCount; ++run) {
+        quint64 length;
+        if (pos >= end) {
+            return false;
+        }
+        const quint8 value = *pos++;
+        if (!readVarint(pos, end, length) || length > count - filled) {
+            return false;
+        }
+        std::fill(buttons + filled, buttons + filled + length, value);
+        filled += length;
+    }
+
+    return filled == count && pos == end;
+}
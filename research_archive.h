@@ -0,0 +1,135 @@
+#ifndef RESEARCH_ARCHIVE_H
+#define RESEARCH_ARCHIVE_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QtGlobal>
+#include "sample_store.h"
+
+class QIODevice;
+struct LogFileContents;
+struct LogLoadControl;
+
+// Сжатый архивный формат исследования .mha. Строка Research_*.txt занимает ~35 байт,
+// а углы между соседними записями меняются на сотые доли градуса, поэтому хранятся
+// только разности:
+//   время     - разность разностей (при ровной частоте устройства почти всегда 0)
+//   углы      - разность с предыдущей записью в сотых долях градуса (точность текстового файла)
+//   кнопки    - серии одинаковых состояний (run-length)
+// Все числа - zig-zag varint, обычная запись занимает 4-5 байт.
+//
+// Файл: сигнатура "MHA1", затем блоки
+//   quint8 тип ('T' - текст, 'S' - записи, 'E' - конец), varint длина данных,
+//   quint32 CRC-32 данных (little-endian), данные
+// Блок записей содержит до BlockSamples записей и декодируется независимо от остальных:
+// повреждение одного блока обнаруживается по CRC, блок пропускается, а чтение
+// продолжается со следующего (пропущенные блоки попадают в failedLineCount).
+// Текстовые блоки хранят строки '#' (заголовок и итоги записи) на своих местах в потоке.
+// Блок 'E' с общим числом записей пишется при закрытии; файл без него (прерванная запись)
+// читается до последнего целого блока
+class ResearchArchive
+{
+public:
+    static const int BlockSamples = 4096;
+
+    // Проверка сигнатуры (читаются только первые байты файла)
+    static bool isArchiveFile(const QString &fileName);
+
+    // Декодирование файла целиком в колонки
+    static bool load(const QString &fileName, LogFileContents &contents,
+                     LogLoadControl *control = nullptr);
+
+    // Запись загруженного исследования (для конвертера)
+    static bool write(const QString &fileName, const QStringList &headerLines,
+                      const SampleStore &samples, QString *errorString = nullptr);
+
+    static quint32 crc32(const char *data, qsizetype size);
+};
+
+// Потоковый кодировщик: записи копятся в текущем блоке и уходят в устройство,
+// когда блок заполнен. Памяти нужно на один блок независимо от длины исследования
+class ResearchArchiveWriter
+{
+public:
+    explicit ResearchArchiveWriter(QIODevice *device);
+
+    // Строки комментариев ('#'), разделённые '\n'. Незаконченный блок записей закрывается
+    bool writeText(const QString &text);
+    bool writeSample(qint64 time, float pitch, float roll, float yaw, quint8 buttons);
+    // Досрочное закрытие блока записей (например, перед сбросом файла на диск)
+    bool flushBlock();
+    // Последний блок и блок конца файла
+    bool finish();
+
+    qint64 sampleCount() const { return m_sampleCount; }
+    QString errorString() const;
+
+private:
+    bool writeBlock(char type, const QByteArray &payload);
+    void appendRun();
+
+    QIODevice *m_device;
+    bool m_started = false;
+    bool m_failed = false;
+    qint64 m_sampleCount = 0;
+
+    // Текущий блок записей
+    int m_blockCount = 0;
+    QByteArray m_samples;
+    QByteArray m_runs;
+    int m_runCount = 0;
+    quint8 m_runValue = 0;
+    int m_runLength = 0;
+    qint64 m_prevTime = 0;
+    qint64 m_prevDelta = 0;
+    qint32 m_prevPitch = 0;
+    qint32 m_prevRoll = 0;
+    qint32 m_prevYaw = 0;
+};
+
+// Потоковый декодер: readNext() читает один блок, как QXmlStreamReader
+class ResearchArchiveReader
+{
+public:
+    enum TokenType {
+        Text,           // text() - строки комментариев блока
+        Samples,        // samples() - записи блока
+        Corrupted,      // Блок blockIndex() повреждён и пропущен, blockError() - причина
+        EndOfArchive,
+        Invalid         // errorString()
+    };
+
+    explicit ResearchArchiveReader(QIODevice *device);
+
+    TokenType readNext();
+
+    const QString &text() const { return m_text; }
+    const SampleColumns &samples() const { return m_columns; }
+    // Был блок конца файла (запись завершена штатно)
+    bool isComplete() const { return m_complete; }
+    qint64 sampleCount() const { return m_sampleCount; }
+    // Номер последнего прочитанного блока (с 0)
+    int blockIndex() const { return m_blockIndex - 1; }
+    int corruptedBlockCount() const { return m_corruptedBlocks; }
+    QString blockError() const { return m_blockError; }
+    QString errorString() const { return m_errorString; }
+
+private:
+    TokenType fail(const QString &message);
+    TokenType skip(const QString &message);
+    bool decodeSamples(const QByteArray &payload);
+
+    QIODevice *m_device;
+    bool m_started = false;
+    bool m_complete = false;
+    int m_blockIndex = 0;
+    int m_corruptedBlocks = 0;
+    qint64 m_sampleCount = 0;
+    QString m_text;
+    SampleColumns m_columns;
+    QString m_blockError;
+    QString m_errorString;
+};
+
+#endif // RESEARCH_ARCHIVE_H
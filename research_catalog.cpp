@@ -0,0 +1,436 @@
+#include "research_catalog.h"
+#include "log_file_loader.h"
+#include "study_analysis.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+
+const char kCatalogFileName[] = "catalog.json";
+
+// Сводка больше этого объёма считается постранично, чтобы фоновый разбор
+// многочасовой записи не занимал память наравне с открытым исследованием
+const qint64 kSummaryMemoryBudget = 128 * 1024 * 1024;
+
+const QStringList &researchFilters()
+{
+    static const QStringList filters = {"Research_*.txt", "Research_*.mha", "Research_*.mhs"};
+    return filters;
+}
+
+const QRegularExpression &fileNamePattern()
+{
+    static const QRegularExpression re("^Research_(\\d{6})_(\\d{4}_\\d{2}_\\d{2}_\\d{2}_\\d{2}_\\d{2})\\.(txt|mha|mhs)$");
+    return re;
+}
+
+QJsonObject toJson(const ResearchCatalog::Entry &entry)
+{
+    QJsonObject object;
+    object["file"] = entry.fileName;
+    object["number"] = entry.researchNumber;
+    object["recordedAt"] = entry.recordedAt;
+    object["duration"] = entry.duration;
+    object["samples"] = entry.sampleCount;
+    object["patientDizziness"] = entry.patientDizziness;
+    object["doctorDizziness"] = entry.doctorDizziness;
+    object["patientEpisodes"] = entry.patientEpisodes;
+    object["doctorEpisodes"] = entry.doctorEpisodes;
+    object["size"] = entry.fileSize;
+    object["modified"] = entry.modified;
+    return object;
+}
+
+ResearchCatalog::Entry fromJson(const QJsonObject &object)
+{
+    ResearchCatalog::Entry entry;
+    entry.fileName = object["file"].toString();
+    entry.researchNumber = object["number"].toInt();
+    entry.recordedAt = object["recordedAt"].toInteger();
+    entry.duration = object["duration"].toInteger();
+    entry.sampleCount = object["samples"].toInteger();
+    entry.patientDizziness = object["patientDizziness"].toInteger();
+    entry.doctorDizziness = object["doctorDizziness"].toInteger();
+    entry.patientEpisodes = object["patientEpisodes"].toInt();
+    entry.doctorEpisodes = object["doctorEpisodes"].toInt();
+    entry.fileSize = object["size"].toInteger();
+    entry.modified = object["modified"].toInteger();
+    entry.summarized = true;
+    return entry;
+}
+
+// Строка каталога для файла, который ещё не разобран: всё, что известно по имени
+ResearchCatalog::Entry pendingEntry(const QFileInfo &info)
+{
+    ResearchCatalog::Entry entry;
+    entry.fileName = info.fileName();
+    entry.researchNumber = ResearchCatalog::researchNumberFromFileName(entry.fileName);
+    entry.fileSize = info.size();
+    entry.modified = info.lastModified().toMSecsSinceEpoch();
+
+    const QRegularExpressionMatch match = fileNamePattern().match(entry.fileName);
+    if (match.hasMatch()) {
+        const QDateTime dateTime = QDateTime::fromString(match.captured(2), "yyyy_MM_dd_HH_mm_ss");
+        if (dateTime.isValid()) {
+            entry.recordedAt = dateTime.toMSecsSinceEpoch();
+        }
+    }
+    return entry;
+}
+
+} // namespace
+
+ResearchCatalog::ResearchCatalog(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    // Разбор по одному файлу: фоновая сверка не мешает загрузке исследования
+    m_pool.setMaxThreadCount(1);
+
+    // Несколько изменений подряд сохраняются одной записью файла
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(1000);
+    connect(&m_saveTimer, &QTimer::timeout, this, &ResearchCatalog::save);
+}
+
+ResearchCatalog::~ResearchCatalog()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+
+    if (m_saveTimer.isActive()) {
+        save();
+    }
+}
+
+int ResearchCatalog::researchNumberFromFileName(const QString &fileName)
+{
+    const QRegularExpressionMatch match = fileNamePattern().match(fileName);
+    return match.hasMatch() ? match.captured(1).toInt() : 0;
+}
+
+QVector<ResearchCatalog::Entry> ResearchCatalog::readCatalog() const
+{
+    QVector<Entry> entries;
+
+    QFile file(QDir(m_directory).filePath(kCatalogFileName));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return entries;
+    }
+
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    const QJsonObject root = document.object();
+    if (root["version"].toInt() != Version) {
+        return entries; // Неизвестная версия - каталог строится заново
+    }
+
+    const QJsonArray array = root["entries"].toArray();
+    entries.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        entries.append(fromJson(value.toObject()));
+    }
+    return entries;
+}
+
+void ResearchCatalog::save()
+{
+    if (m_directory.isEmpty()) {
+        return;
+    }
+
+    QJsonArray array;
+    for (const Entry &entry : m_entries) {
+        // Неразобранные файлы не сохраняются: при следующем запуске они будут разобраны снова
+        if (entry.summarized) {
+            array.append(toJson(entry));
+        }
+    }
+
+    QJsonObject root;
+    root["version"] = Version;
+    root["entries"] = array;
+
+    QSaveFile file(QDir(m_directory).filePath(kCatalogFileName));
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) < 0 ||
+        !file.commit()) {
+        qWarning() << "Cannot save research catalog:" << file.errorString();
+    }
+}
+
+void ResearchCatalog::open(const QString &directory)
+{
+    m_generation++;
+    m_pool.clear();
+
+    if (m_saveTimer.isActive()) {
+        m_saveTimer.stop();
+        save();
+    }
+
+    m_directory = directory;
+
+    QHash<QString, Entry> known;
+    for (const Entry &entry : readCatalog()) {
+        known.insert(entry.fileName, entry);
+    }
+
+    // ОПТИМИЗАЦИЯ: только список файлов с размером и временем изменения, без чтения
+    // содержимого. Разбираются лишь файлы, которых нет в каталоге или которые изменились
+    QDir dir(m_directory);
+    const QFileInfoList files = dir.entryInfoList(researchFilters(), QDir::Files, QDir::Name | QDir::Reversed);
+
+    QVector<Entry> entries;
+    entries.reserve(files.size());
+    QStringList toSummarize;
+    bool changed = files.size() != known.size();
+
+    for (const QFileInfo &info : files) {
+        const auto found = known.constFind(info.fileName());
+        if (found != known.constEnd() && found->fileSize == info.size() &&
+            found->modified == info.lastModified().toMSecsSinceEpoch()) {
+            entries.append(*found);
+        } else {
+            entries.append(pendingEntry(info));
+            toSummarize << info.fileName();
+            changed = true;
+        }
+    }
+
+    beginResetModel();
+    m_entries = entries;
+    endResetModel();
+    emit countChanged();
+
+    const bool wasScanning = scanning();
+    m_pending = 0;
+    for (const QString &fileName : toSummarize) {
+        scheduleSummary(fileName);
+    }
+    if (wasScanning != scanning()) {
+        emit scanningChanged();
+    }
+
+    // Удалённые файлы убираются из каталога
+    if (changed) {
+        m_saveTimer.start();
+    }
+}
+
+void ResearchCatalog::refreshFile(const QString &filePath)
+{
+    const QFileInfo info(filePath);
+    if (m_directory.isEmpty() || QDir(info.absolutePath()) != QDir(m_directory) ||
+        !fileNamePattern().match(info.fileName()).hasMatch()) {
+        return;
+    }
+
+    const int row = indexOf(info.fileName());
+    if (row < 0) {
+        const int position = insertPosition(info.fileName());
+        beginInsertRows(QModelIndex(), position, position);
+        m_entries.insert(position, pendingEntry(info));
+        endInsertRows();
+        emit countChanged();
+    } else {
+        m_entries[row] = pendingEntry(info);
+        emit dataChanged(index(row), index(row));
+    }
+
+    const bool wasScanning = scanning();
+    scheduleSummary(info.fileName());
+    if (!wasScanning) {
+        emit scanningChanged();
+    }
+}
+
+void ResearchCatalog::scheduleSummary(const QString &fileName)
+{
+    m_pending++;
+
+    const quint64 generation = m_generation;
+    const QString path = QDir(m_directory).filePath(fileName);
+    m_pool.start([this, generation, fileName, path]() {
+        Entry entry;
+        entry.fileName = fileName;
+        const bool ok = summarize(path, entry);
+
+        QMetaObject::invokeMethod(this, [this, generation, entry, ok]() {
+            applySummary(generation, entry, ok);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ResearchCatalog::applySummary(quint64 generation, const Entry &entry, bool ok)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    m_pending--;
+    if (m_pending == 0) {
+        emit scanningChanged();
+    }
+
+    const int row = indexOf(entry.fileName);
+    if (row < 0) {
+        return;
+    }
+
+    if (!ok) {
+        // Строка остаётся с данными из имени файла; при следующем запуске попытка повторится
+        qWarning() << "Cannot summarize research file" << entry.fileName;
+        return;
+    }
+
+    m_entries[row] = entry;
+    emit dataChanged(index(row), index(row));
+    m_saveTimer.start();
+}
+
+bool ResearchCatalog::summarize(const QString &filePath, Entry &entry)
+{
+    const QFileInfo info(filePath);
+    const Entry fromName = pendingEntry(info);
+
+    LogLoadControl control;
+    control.memoryBudget = kSummaryMemoryBudget;
+    LogFileContents contents;
+    if (!LogFileLoader::load(filePath, contents, &control)) {
+        return false;
+    }
+
+    entry = fromName;
+
+    // Номер и дата из заголовка, если имя файла не по шаблону
+    static const QRegularExpression numberRe("Исследование №\\s*(\\d{6})");
+    for (const QString &line : contents.headerLines) {
+        const QRegularExpressionMatch match = numberRe.match(line);
+        if (entry.researchNumber == 0 && match.hasMatch()) {
+            entry.researchNumber = match.captured(1).toInt();
+        }
+        const QDateTime dateTime = QDateTime::fromString(line.trimmed(), "yyyy-MM-dd HH:mm:ss");
+        if (entry.recordedAt == 0 && dateTime.isValid()) {
+            entry.recordedAt = dateTime.toMSecsSinceEpoch();
+        }
+    }
+
+    const SampleStore &samples = contents.samples;
+    const int n = samples.size();
+    entry.sampleCount = n;
+    entry.duration = n > 0 ? samples.lastTime() - samples.firstTime() : 0;
+
+    // Эпизоды и время головокружения - так же, как в пакетном анализе
+    const DizzinessMetrics patient = StudyAnalysis::dizziness(samples, SampleStore::PatientButton);
+    const DizzinessMetrics doctor = StudyAnalysis::dizziness(samples, SampleStore::DoctorButton);
+    entry.patientDizziness = patient.total;
+    entry.doctorDizziness = doctor.total;
+    entry.patientEpisodes = patient.episodes;
+    entry.doctorEpisodes = doctor.episodes;
+
+    entry.summarized = true;
+    return true;
+}
+
+int ResearchCatalog::maxResearchNumber() const
+{
+    int maxNumber = 0;
+    for (const Entry &entry : m_entries) {
+        maxNumber = qMax(maxNumber, entry.researchNumber);
+    }
+    return maxNumber;
+}
+
+int ResearchCatalog::indexOf(const QString &fileName) const
+{
+    const auto found = std::find_if(m_entries.cbegin(), m_entries.cend(),
+                                    [&fileName](const Entry &entry) { return entry.fileName == fileName; });
+    return found == m_entries.cend() ? -1 : static_cast<int>(found - m_entries.cbegin());
+}
+
+int ResearchCatalog::insertPosition(const QString &fileName) const
+{
+    const auto found = std::lower_bound(m_entries.cbegin(), m_entries.cend(), fileName,
+                                        [](const Entry &entry, const QString &name) { return entry.fileName > name; });
+    return static_cast<int>(found - m_entries.cbegin());
+}
+
+QString ResearchCatalog::filePath(int row) const
+{
+    if (row < 0 || row >= m_entries.size()) {
+        return QString();
+    }
+    return QDir(m_directory).filePath(m_entries[row].fileName);
+}
+
+int ResearchCatalog::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_entries.size();
+}
+
+QVariant ResearchCatalog::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.size()) {
+        return QVariant();
+    }
+
+    const Entry &entry = m_entries[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+    case FileNameRole:
+        return entry.fileName;
+    case FilePathRole:
+        return QDir(m_directory).filePath(entry.fileName);
+    case ResearchNumberRole:
+        return QString::number(entry.researchNumber).rightJustified(6, '0');
+    case RecordedAtRole:
+        return entry.recordedAt > 0 ? QDateTime::fromMSecsSinceEpoch(entry.recordedAt) : QDateTime();
+    case DurationRole:
+        return entry.duration;
+    case SampleCountRole:
+        return entry.sampleCount;
+    case PatientDizzinessRole:
+        return entry.patientDizziness;
+    case DoctorDizzinessRole:
+        return entry.doctorDizziness;
+    case PatientEpisodesRole:
+        return entry.patientEpisodes;
+    case DoctorEpisodesRole:
+        return entry.doctorEpisodes;
+    case FileSizeRole:
+        return entry.fileSize;
+    case FormatRole:
+        return QFileInfo(entry.fileName).suffix();
+    case PendingRole:
+        return !entry.summarized;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ResearchCatalog::roleNames() const
+{
+    return {
+        {FileNameRole, "fileName"},
+        {FilePathRole, "filePath"},
+        {ResearchNumberRole, "researchNumber"},
+        {RecordedAtRole, "recordedAt"},
+        {DurationRole, "duration"},
+        {SampleCountRole, "sampleCount"},
+        {PatientDizzinessRole, "patientDizziness"},
+        {DoctorDizzinessRole, "doctorDizziness"},
+        {PatientEpisodesRole, "patientEpisodes"},
+        {DoctorEpisodesRole, "doctorEpisodes"},
+        {FileSizeRole, "fileSize"},
+        {FormatRole, "format"},
+        {PendingRole, "pending"}
+    };
+}
@@ -0,0 +1,102 @@
+#ifndef RESEARCH_CATALOG_H
+#define RESEARCH_CATALOG_H
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QString>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+// Каталог папки исследований: номер, дата, длительность, число записей и время
+// головокружения по каждому файлу. Хранится в catalog.json рядом с исследованиями.
+// При запуске файлы сверяются с каталогом только по размеру и времени изменения -
+// разбираются лишь новые и изменённые, в фоне, по одному. Поэтому запуск не
+// замедляется с ростом архива, а номер следующего исследования известен сразу
+// (он берётся из имён файлов).
+//
+// Для QML - модель списка, новые исследования сверху
+class ResearchCatalog : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool scanning READ scanning NOTIFY scanningChanged)
+
+public:
+    enum Roles {
+        FileNameRole = Qt::UserRole + 1,
+        FilePathRole,
+        ResearchNumberRole,
+        RecordedAtRole,
+        DurationRole,           // мс
+        SampleCountRole,
+        PatientDizzinessRole,   // Суммарное время с нажатой кнопкой пациента, мс
+        DoctorDizzinessRole,    // То же для кнопки врача, мс
+        PatientEpisodesRole,
+        DoctorEpisodesRole,
+        FileSizeRole,
+        FormatRole,             // "txt", "mha" или "mhs"
+        PendingRole             // Файл ещё не разобран
+    };
+
+    struct Entry {
+        QString fileName;
+        int researchNumber = 0;
+        qint64 recordedAt = 0;      // мс с эпохи, 0 - неизвестно
+        qint64 duration = 0;
+        qint64 sampleCount = 0;
+        qint64 patientDizziness = 0;
+        qint64 doctorDizziness = 0;
+        int patientEpisodes = 0;
+        int doctorEpisodes = 0;
+        // Отпечаток файла: если они совпадают, сводка не пересчитывается
+        qint64 fileSize = 0;
+        qint64 modified = 0;        // мс с эпохи
+        bool summarized = false;
+    };
+
+    static const int Version = 1;
+
+    explicit ResearchCatalog(QObject *parent = nullptr);
+    ~ResearchCatalog();
+
+    // Загрузка каталога и сверка с папкой
+    void open(const QString &directory);
+    QString directory() const { return m_directory; }
+
+    // Файл записан или изменён - его строка пересчитывается в фоне
+    Q_INVOKABLE void refreshFile(const QString &filePath);
+    Q_INVOKABLE QString filePath(int row) const;
+
+    int count() const { return m_entries.size(); }
+    bool scanning() const { return m_pending > 0; }
+    int maxResearchNumber() const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Разбор файла исследования в сводку (выполняется в фоновом потоке)
+    static bool summarize(const QString &filePath, Entry &entry);
+    static int researchNumberFromFileName(const QString &fileName);
+
+signals:
+    void countChanged();
+    void scanningChanged();
+
+private:
+    QVector<Entry> readCatalog() const;
+    void save();
+    void scheduleSummary(const QString &fileName);
+    void applySummary(quint64 generation, const Entry &entry, bool ok);
+    int indexOf(const QString &fileName) const;
+    int insertPosition(const QString &fileName) const;
+
+    QString m_directory;
+    QVector<Entry> m_entries;   // По убыванию имени файла (новые сверху)
+    QThreadPool m_pool;
+    QTimer m_saveTimer;
+    int m_pending = 0;
+    quint64 m_generation = 0;   // Смена папки отбрасывает сводки, посчитанные для старой
+};
+
+#endif // RESEARCH_CATALOG_H
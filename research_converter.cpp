@@ -0,0 +1,322 @@
+// Конвертер архива исследований MonitorHead.
+// Переводит файлы исследований между форматами (исходные файлы не изменяются):
+//   mhs - бинарный файл сессии, открывается за постоянное время (по умолчанию);
+//   mha - сжатый архив для хранения и резервных копий;
+//   txt - текстовый Research_*.txt (восстановление из архива .mha).
+//
+// Пример: MonitorHeadConvert ~/Documents/MonitorHead/research
+//         MonitorHeadConvert --format mha --output-dir /mnt/archive Research_000001_*.txt
+//         MonitorHeadConvert --format txt Research_000001_2025_11_09_18_01_45.mha
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <cstdio>
+#include <cstring>
+#include "frame_parser.h"
+#include "log_file_loader.h"
+#include "research_archive.h"
+#include "session_file.h"
+
+namespace {
+
+// Файлы исследований из аргументов: файлы как есть, папки - все файлы с расширениями
+// nameFilters внутри
+QStringList collectInputs(const QStringList &arguments, const QStringList &nameFilters)
+{
+    QStringList files;
+    for (const QString &argument : arguments) {
+        const QFileInfo info(argument);
+        if (info.isDir()) {
+            QDirIterator it(argument, nameFilters, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                files << it.next();
+            }
+        } else {
+            files << argument;
+        }
+    }
+    files.sort();
+    return files;
+}
+
+QString outputFileName(const QString &input, const QString &outputDir, const QString &format)
+{
+    const QFileInfo info(input);
+    const QString dir = outputDir.isEmpty() ? info.absolutePath() : outputDir;
+    return QDir(dir).filePath(info.completeBaseName() + "." + format);
+}
+
+// Текст -> архив построчно: комментарии остаются на своих местах (заголовок и итоги
+// записи), файл любого размера кодируется с памятью на один блок
+bool encodeTextFile(const QString &input, const QString &output, qint64 *samples, QString *errorString)
+{
+    QFile file(input);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    const qint64 size = file.size();
+    const uchar *mapped = size > 0 ? file.map(0, size) : nullptr;
+    const QByteArray buffer = mapped ? QByteArray() : file.readAll();
+    const char *pos = mapped ? reinterpret_cast<const char *>(mapped) : buffer.constData();
+    const char *end = pos + (mapped ? size : buffer.size());
+
+    QSaveFile out(output);
+    if (!out.open(QIODevice::WriteOnly)) {
+        *errorString = out.errorString();
+        return false;
+    }
+
+    ResearchArchiveWriter writer(&out);
+    QStringList comments;
+    bool ok = true;
+
+    while (ok && pos < end) {
+        const char *newline = static_cast<const char *>(std::memchr(pos, '\n', end - pos));
+        const char *eol = newline ? newline : end;
+        const char *first = pos;
+        while (first < eol && (*first == ' ' || *first == '\t')) {
+            ++first;
+        }
+
+        RawFrame frame;
+        if (first < eol && *first == '#') {
+            const char *last = eol;
+            while (last > first && (last[-1] == '\r' || last[-1] == ' ')) {
+                --last;
+            }
+            comments << QString::fromUtf8(first, last - first);
+        } else if (FrameParser::parseLine(first, eol, frame)) {
+            if (!comments.isEmpty()) {
+                ok = writer.writeText(comments.join('\n'));
+                comments.clear();
+            }
+            const quint8 buttons = (frame.patientDizziness ? SampleStore::PatientButton : 0) |
+                                   (frame.doctorDizziness ? SampleStore::DoctorButton : 0);
+            ok = ok && writer.writeSample(frame.deviceTime, frame.pitch, frame.roll, frame.yaw, buttons);
+        }
+        pos = eol + 1;
+    }
+
+    if (ok && !comments.isEmpty()) {
+        ok = writer.writeText(comments.join('\n'));
+    }
+    ok = ok && writer.finish();
+
+    if (!ok) {
+        *errorString = writer.errorString();
+        out.cancelWriting();
+        return false;
+    }
+    if (!out.commit()) {
+        *errorString = out.errorString();
+        return false;
+    }
+
+    *samples = writer.sampleCount();
+    return true;
+}
+
+// Архив -> текст в формате записи исследования
+bool decodeArchiveFile(const QString &input, const QString &output, qint64 *samples, QString *errorString)
+{
+    QFile file(input);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    QSaveFile out(output);
+    if (!out.open(QIODevice::WriteOnly)) {
+        *errorString = out.errorString();
+        return false;
+    }
+
+    ResearchArchiveReader reader(&file);
+    QByteArray text;
+    bool ok = true;
+
+    for (;;) {
+        const ResearchArchiveReader::TokenType token = reader.readNext();
+        if (token == ResearchArchiveReader::EndOfArchive) {
+            break;
+        }
+        if (token == ResearchArchiveReader::Invalid) {
+            *errorString = reader.errorString();
+            out.cancelWriting();
+            return false;
+        }
+        if (token == ResearchArchiveReader::Corrupted) {
+            fprintf(stderr, "%s: block %d skipped: %s\n", qPrintable(input),
+                    reader.blockIndex() + 1, qPrintable(reader.blockError()));
+            continue;
+        }
+
+        text.clear();
+        if (token == ResearchArchiveReader::Text) {
+            text = reader.text().toUtf8();
+            text += '\n';
+        } else {
+            const SampleColumns &block = reader.samples();
+            for (qsizetype i = 0; i < block.size(); ++i) {
+                text += QByteArray::number(block.time[i]).rightJustified(10, '0');
+                text += ';';
+                text += QByteArray::number(block.pitch[i], 'f', 2);
+                text += ';';
+                text += QByteArray::number(block.roll[i], 'f', 2);
+                text += ';';
+                text += QByteArray::number(block.yaw[i], 'f', 2);
+                text += (block.buttons[i] & SampleStore::PatientButton) ? ";1" : ";0";
+                text += (block.buttons[i] & SampleStore::DoctorButton) ? ";1\n" : ";0\n";
+            }
+        }
+
+        if (out.write(text) != text.size()) {
+            ok = false;
+            break;
+        }
+    }
+
+    if (!ok || !out.commit()) {
+        *errorString = out.errorString();
+        return false;
+    }
+
+    *samples = reader.sampleCount();
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("MonitorHeadConvert");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Конвертер исследований MonitorHead между форматами txt, mhs и mha");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("inputs", "Файлы исследований или папки с ними.", "inputs...");
+
+    QCommandLineOption outputDirOption({"o", "output-dir"}, "Папка для результатов (по умолчанию рядом с исходными).", "dir");
+    QCommandLineOption forceOption("force", "Перезаписывать существующие файлы.");
+    QCommandLineOption formatOption({"f", "format"}, "Формат результата: mhs (по умолчанию), mha или txt.", "format", "mhs");
+    parser.addOptions({outputDirOption, forceOption, formatOption});
+    parser.process(app);
+
+    const QString format = parser.value(formatOption);
+    if (format != "mhs" && format != "mha" && format != "txt") {
+        fprintf(stderr, "Unknown format %s\n", qPrintable(format));
+        return 1;
+    }
+
+    // Из папок берутся исходные файлы для выбранного формата: текст для mhs/mha, архивы для txt
+    const QStringList nameFilters = format == "txt" ? QStringList{"*.mha"} : QStringList{"*.txt"};
+    const QStringList inputs = collectInputs(parser.positionalArguments(), nameFilters);
+    if (inputs.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    const QString outputDir = parser.value(outputDirOption);
+    if (!outputDir.isEmpty() && !QDir().mkpath(outputDir)) {
+        fprintf(stderr, "Cannot create %s\n", qPrintable(outputDir));
+        return 1;
+    }
+
+    int converted = 0;
+    int skipped = 0;
+    int failed = 0;
+    QElapsedTimer timer;
+    timer.start();
+
+    qint64 inputBytes = 0;
+    qint64 outputBytes = 0;
+
+    for (const QString &input : inputs) {
+        const QString output = outputFileName(input, outputDir, format);
+        if (QFileInfo(output) == QFileInfo(input) ||
+            (!parser.isSet(forceOption) && QFileInfo::exists(output))) {
+            skipped++;
+            continue;
+        }
+
+        // Потоковые пути: текст -> архив и архив -> текст
+        const bool archiveInput = ResearchArchive::isArchiveFile(input);
+        const bool textInput = !archiveInput && !SessionFile::isSessionFile(input);
+        if ((format == "mha" && textInput) || (format == "txt" && archiveInput)) {
+            qint64 samples = 0;
+            QString error;
+            const bool ok = format == "mha" ? encodeTextFile(input, output, &samples, &error)
+                                            : decodeArchiveFile(input, output, &samples, &error);
+            if (!ok) {
+                fprintf(stderr, "%s: %s\n", qPrintable(input), qPrintable(error));
+                failed++;
+                continue;
+            }
+
+            inputBytes += QFileInfo(input).size();
+            outputBytes += QFileInfo(output).size();
+            fprintf(stderr, "%s -> %s (%lld samples)\n", qPrintable(input), qPrintable(output),
+                    static_cast<long long>(samples));
+            converted++;
+            continue;
+        }
+
+        if (format == "txt") {
+            fprintf(stderr, "%s: only .mha archives can be converted to text\n", qPrintable(input));
+            failed++;
+            continue;
+        }
+
+        LogFileContents contents;
+        if (!LogFileLoader::load(input, contents)) {
+            fprintf(stderr, "%s: %s\n", qPrintable(input), qPrintable(contents.errorString));
+            failed++;
+            continue;
+        }
+
+        if (contents.samples.isEmpty()) {
+            fprintf(stderr, "%s: no samples\n", qPrintable(input));
+            failed++;
+            continue;
+        }
+
+        if (contents.failedLineCount > 0) {
+            fprintf(stderr, "%s: %lld %s skipped\n", qPrintable(input),
+                    static_cast<long long>(contents.failedLineCount),
+                    contents.errorString.isEmpty() ? "lines" : "corrupted blocks");
+        }
+
+        QString error;
+        const bool written = format == "mha"
+            ? ResearchArchive::write(output, contents.headerLines, contents.samples, &error)
+            : SessionFile::write(output, contents.headerLines, contents.samples, &error);
+        if (!written) {
+            fprintf(stderr, "%s: %s\n", qPrintable(output), qPrintable(error));
+            failed++;
+            continue;
+        }
+
+        inputBytes += QFileInfo(input).size();
+        outputBytes += QFileInfo(output).size();
+        fprintf(stderr, "%s -> %s (%d samples)\n", qPrintable(input), qPrintable(output),
+                contents.samples.size());
+        converted++;
+    }
+
+    fprintf(stderr, "Converted %d, skipped %d, failed %d in %.1f s\n",
+            converted, skipped, failed, timer.elapsed() / 1000.0);
+    if (inputBytes > 0) {
+        fprintf(stderr, "%.1f MB -> %.1f MB (%.1f%%)\n", inputBytes / 1048576.0,
+                outputBytes / 1048576.0, 100.0 * outputBytes / inputBytes);
+    }
+    return failed == 0 ? 0 : 1;
+}
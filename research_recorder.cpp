@@ -0,0 +1,139 @@
+#include "research_recorder.h"
+#include "research_archive.h"
+#include "sample_store.h"
+
+ResearchRecorder::~ResearchRecorder()
+{
+    close();
+}
+
+bool ResearchRecorder::open(const QString &fileName, bool compressed)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    const QIODevice::OpenMode mode = compressed ? QIODevice::WriteOnly
+                                                : QIODevice::WriteOnly | QIODevice::Text;
+    if (!m_file.open(mode)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    m_errorString.clear();
+    m_sampleCount = 0;
+
+    if (compressed) {
+        m_archive = new ResearchArchiveWriter(&m_file);
+        m_text.clear();
+        m_blockTimer.start();
+        m_stream.setString(&m_text);
+    } else {
+        m_stream.setDevice(&m_file);
+    }
+    return true;
+}
+
+bool ResearchRecorder::close()
+{
+    if (!m_file.isOpen()) {
+        return true;
+    }
+
+    bool ok = true;
+    m_stream.flush();
+
+    if (m_archive) {
+        flushComments();
+        if (!m_archive->finish()) {
+            setArchiveError();
+            ok = false;
+        }
+        delete m_archive;
+        m_archive = nullptr;
+    }
+
+    m_stream.setDevice(nullptr);
+    m_file.close();
+    return ok;
+}
+
+// В сжатой записи накопленные строки комментариев уходят в архив одним текстовым блоком
+void ResearchRecorder::flushComments()
+{
+    m_stream.flush();
+    if (m_text.isEmpty()) {
+        return;
+    }
+
+    if (m_text.endsWith('\n')) {
+        m_text.chop(1);
+    }
+    if (!m_archive->writeText(m_text)) {
+        setArchiveError();
+    }
+    m_text.clear();
+}
+
+// Сообщение первой ошибки записи архива: последующие вызывают ту же ошибку устройства
+void ResearchRecorder::setArchiveError()
+{
+    if (m_errorString.isEmpty()) {
+        m_errorString = m_archive->errorString();
+    }
+}
+
+void ResearchRecorder::writeSample(qint64 time, float pitch, float roll, float yaw,
+                                   bool patientDizziness, bool doctorDizziness)
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    m_sampleCount++;
+
+    if (m_archive) {
+        flushComments();
+        const quint8 buttons = (patientDizziness ? SampleStore::PatientButton : 0) |
+                               (doctorDizziness ? SampleStore::DoctorButton : 0);
+        if (!m_archive->writeSample(time, pitch, roll, yaw, buttons)) {
+            setArchiveError();
+        }
+        return;
+    }
+
+    QString timestamp = QString::number(time).rightJustified(10, '0');
+    QString formattedLine = QString("%1;%2;%3;%4;%5;%6")
+                                .arg(timestamp)
+                                .arg(pitch, 0, 'f', 2)
+                                .arg(roll, 0, 'f', 2)
+                                .arg(yaw, 0, 'f', 2)
+                                .arg(patientDizziness ? 1 : 0)
+                                .arg(doctorDizziness ? 1 : 0);
+
+    m_stream << formattedLine << "\n";
+}
+
+void ResearchRecorder::flush()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    if (m_archive) {
+        flushComments();
+
+        // Блок в 4096 записей заполняется около 4 секунд, а прерванный архив читается
+        // только до последнего целого блока. Раз в секунду блок закрывается досрочно:
+        // лишние ~20 байт в секунду (заголовок блока и первая запись целиком) против
+        // потери нескольких секунд при обрыве
+        if (m_blockTimer.elapsed() >= BlockFlushIntervalMs) {
+            if (!m_archive->flushBlock()) {
+                setArchiveError();
+            }
+            m_blockTimer.restart();
+        }
+    } else {
+        m_stream.flush();
+    }
+    m_file.flush();
+}
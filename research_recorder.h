@@ -0,0 +1,65 @@
+#ifndef RESEARCH_RECORDER_H
+#define RESEARCH_RECORDER_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+#include <QtCore/QTextStream>
+#include <QtCore/QtGlobal>
+
+class ResearchArchiveWriter;
+
+// Запись исследования в файл: текстовый Research_*.txt или сжатый архив .mha.
+// Строки комментариев ('#') и записи идут в том порядке, в каком поступают;
+// в сжатом режиме комментарии копятся и уходят в архив текстовым блоком перед
+// следующей записью или при закрытии. Не зависит от интерфейса и источника кадров -
+// им пользуются и программа, и эмуляторы с тестовыми стендами
+class ResearchRecorder
+{
+public:
+    ResearchRecorder() = default;
+    ~ResearchRecorder();
+
+    ResearchRecorder(const ResearchRecorder &) = delete;
+    ResearchRecorder &operator=(const ResearchRecorder &) = delete;
+
+    bool open(const QString &fileName, bool compressed);
+    // Сбрасывает всё накопленное и закрывает файл; false - ошибка записи (errorString())
+    bool close();
+
+    bool isOpen() const { return m_file.isOpen(); }
+    bool isCompressed() const { return m_archive != nullptr; }
+    QString fileName() const { return m_file.fileName(); }
+    qint64 sampleCount() const { return m_sampleCount; }
+    QString errorString() const { return m_errorString; }
+    // Была ошибка записи (запоминается первая, запись при этом не закрывается)
+    bool hasError() const { return !m_errorString.isEmpty(); }
+
+    // Поток для строк комментариев; каждая строка должна начинаться с '#'
+    QTextStream &comments() { return m_stream; }
+
+    void writeSample(qint64 time, float pitch, float roll, float yaw,
+                     bool patientDizziness, bool doctorDizziness);
+
+    // Интервал, с которым незаполненный блок сжатой записи закрывается при flush()
+    static const int BlockFlushIntervalMs = 1000;
+
+    // Сброс буферов на диск (раз на пачку кадров, не на каждую запись).
+    // В сжатом режиме не реже раза в BlockFlushIntervalMs закрывается и текущий блок,
+    // чтобы при обрыве записи терялось не больше секунды
+    void flush();
+
+private:
+    void flushComments();
+    void setArchiveError();
+
+    QFile m_file;
+    QTextStream m_stream;
+    ResearchArchiveWriter *m_archive = nullptr;
+    QString m_text;             // Комментарии сжатой записи до ближайшего текстового блока
+    QElapsedTimer m_blockTimer; // Время с последнего закрытия блока сжатой записи
+    qint64 m_sampleCount = 0;
+    QString m_errorString;
+};
+
+#endif // RESEARCH_RECORDER_H
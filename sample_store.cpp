@@ -0,0 +1,144 @@
+#include "sample_store.h"
+#include "paged_log_file.h"
+#include <QFile>
+#include <algorithm>
+
+void SampleColumns::resize(qsizetype size)
+{
+    time.resize(size);
+    pitch.resize(size);
+    roll.resize(size);
+    yaw.resize(size);
+    buttons.resize(size);
+}
+
+void SampleColumns::squeeze()
+{
+    time.squeeze();
+    pitch.squeeze();
+    roll.squeeze();
+    yaw.squeeze();
+    buttons.squeeze();
+}
+
+SampleStore::SampleStore()
+{
+}
+
+SampleStore::SampleStore(SampleColumns &&columns)
+    : m_columns(QSharedPointer<const SampleColumns>::create(std::move(columns)))
+{
+    m_view.time = m_columns->time.constData();
+    m_view.pitch = m_columns->pitch.constData();
+    m_view.roll = m_columns->roll.constData();
+    m_view.yaw = m_columns->yaw.constData();
+    m_view.buttons = m_columns->buttons.constData();
+    m_view.size = static_cast<int>(m_columns->size());
+}
+
+SampleStore::SampleStore(const SampleColumnView &view, const QSharedPointer<QFile> &file)
+    : m_view(view)
+    , m_file(file)
+{
+}
+
+SampleStore::SampleStore(const QSharedPointer<PagedLogFile> &paged)
+    : m_paged(paged)
+{
+    m_view.size = paged->size();
+}
+
+LogDataEntry SampleStore::at(int index) const
+{
+    LogDataEntry entry;
+    entry.time = time(index);
+    entry.pitch = pitch(index);
+    entry.roll = roll(index);
+    entry.yaw = yaw(index);
+    entry.dizziness = patientDizziness(index);
+    entry.doctorDizziness = doctorDizziness(index);
+    return entry;
+}
+
+float SampleStore::angle(Axis axis, int index) const
+{
+    const float *column = angles(axis);
+    return Q_LIKELY(column) ? column[index] : pagedAngle(axis, index);
+}
+
+const float *SampleStore::angles(Axis axis) const
+{
+    switch (axis) {
+    case Roll:
+        return m_view.roll;
+    case Yaw:
+        return m_view.yaw;
+    case Pitch:
+    default:
+        return m_view.pitch;
+    }
+}
+
+int SampleStore::findIndexByTime(qint64 time) const
+{
+    if (m_paged) {
+        return m_paged->findIndexByTime(time);
+    }
+
+    const qint64 *begin = times();
+    const qint64 *end = begin + size();
+
+    // ОПТИМИЗАЦИЯ: в отображённом файле двоичный поиск по всей колонке времени
+    // задевает десятки страниц, которых ещё нет в памяти. Индекс блоков компактный,
+    // после него поиск идёт внутри одного блока (32 КБ колонки)
+    if (!m_blockTimes.isEmpty()) {
+        const int block = static_cast<int>(std::upper_bound(m_blockTimes.constBegin(), m_blockTimes.constEnd(), time)
+                                           - m_blockTimes.constBegin()) - 1;
+        if (block < 0) {
+            return -1;
+        }
+        const qint64 *blockBegin = begin + qMin(qint64(block) * m_blockSize, qint64(size()));
+        const qint64 *blockEnd = begin + qMin(qint64(block + 1) * m_blockSize, qint64(size()));
+        return static_cast<int>(std::upper_bound(blockBegin, blockEnd, time) - begin) - 1;
+    }
+
+    const qint64 *found = std::upper_bound(begin, end, time);
+    // Для пустого хранилища begin == end == nullptr, результат -1
+    return static_cast<int>(found - begin) - 1;
+}
+
+void SampleStore::setBlockIndex(const QVector<qint64> &blockTimes, int blockSize)
+{
+    m_blockTimes = blockTimes;
+    m_blockSize = blockSize;
+}
+
+qint64 SampleStore::memoryUsage() const
+{
+    if (m_paged) {
+        return m_paged->cachedBytes();
+    }
+    return size() * qint64(sizeof(qint64) + 3 * sizeof(float) + sizeof(quint8));
+}
+
+void SampleStore::setPagedMemoryBudget(qint64 bytes) const
+{
+    if (m_paged) {
+        m_paged->setMemoryBudget(bytes);
+    }
+}
+
+qint64 SampleStore::pagedTime(int index) const
+{
+    return m_paged->time(index);
+}
+
+float SampleStore::pagedAngle(Axis axis, int index) const
+{
+    return m_paged->angle(axis, index);
+}
+
+quint8 SampleStore::pagedButtons(int index) const
+{
+    return m_paged->buttons(index);
+}
@@ -0,0 +1,128 @@
+#ifndef SAMPLE_STORE_H
+#define SAMPLE_STORE_H
+
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
+#include <QtCore/QtGlobal>
+
+class QFile;
+class PagedLogFile;
+
+// Одна запись лог-файла (строка исследования)
+struct LogDataEntry {
+    qint64 time;
+    float pitch;
+    float roll;
+    float yaw;
+    bool dizziness;
+    bool doctorDizziness;
+
+    LogDataEntry() : time(0), pitch(0), roll(0), yaw(0),
+        dizziness(false), doctorDizziness(false) {}
+};
+
+// Колонки исследования во время заполнения (загрузчик пишет в них напрямую)
+struct SampleColumns {
+    QVector<qint64> time;
+    QVector<float> pitch;
+    QVector<float> roll;
+    QVector<float> yaw;
+    QVector<quint8> buttons;    // Биты SampleStore::PatientButton / DoctorButton
+
+    qsizetype size() const { return time.size(); }
+    void resize(qsizetype size);
+    void squeeze();
+};
+
+// Колонки в чужой памяти (например, в отображённом файле сессии)
+struct SampleColumnView {
+    const qint64 *time = nullptr;
+    const float *pitch = nullptr;
+    const float *roll = nullptr;
+    const float *yaw = nullptr;
+    const quint8 *buttons = nullptr;
+    int size = 0;
+};
+
+// Загруженное исследование в виде колонок (structure of arrays).
+// Данные неизменяемые и разделяются по счётчику ссылок: контроллер, LogReader и
+// построение графиков держат копии SampleStore, которые указывают на одни и те же
+// массивы. Проходы по одной оси читают один непрерывный массив float.
+// Память колонок принадлежит либо SampleColumns (текстовый файл), либо
+// отображённому в память файлу сессии .mhs - тогда данные не копируются вовсе,
+// либо PagedLogFile - тогда в памяти только страницы, к которым обращались.
+// В постраничном режиме times()/angles()/buttons() возвращают nullptr: непрерывных
+// массивов нет, доступ только по индексу
+class SampleStore
+{
+public:
+    enum Axis {
+        Pitch,
+        Roll,
+        Yaw
+    };
+
+    static const quint8 PatientButton = 0x01;
+    static const quint8 DoctorButton = 0x02;
+
+    SampleStore();
+    explicit SampleStore(SampleColumns &&columns);
+    // Колонки в отображённом файле; file держит отображение, пока живут копии хранилища
+    SampleStore(const SampleColumnView &view, const QSharedPointer<QFile> &file);
+    // Записи текстового файла, подкачиваемые страницами
+    explicit SampleStore(const QSharedPointer<PagedLogFile> &paged);
+
+    int size() const { return m_view.size; }
+    bool isEmpty() const { return m_view.size == 0; }
+
+    qint64 time(int index) const { return Q_LIKELY(m_view.time) ? m_view.time[index] : pagedTime(index); }
+    float pitch(int index) const { return Q_LIKELY(m_view.pitch) ? m_view.pitch[index] : pagedAngle(Pitch, index); }
+    float roll(int index) const { return Q_LIKELY(m_view.roll) ? m_view.roll[index] : pagedAngle(Roll, index); }
+    float yaw(int index) const { return Q_LIKELY(m_view.yaw) ? m_view.yaw[index] : pagedAngle(Yaw, index); }
+    float angle(Axis axis, int index) const;
+    bool patientDizziness(int index) const { return (buttonsAt(index) & PatientButton) != 0; }
+    bool doctorDizziness(int index) const { return (buttonsAt(index) & DoctorButton) != 0; }
+
+    // Строка целиком (для мест, где нужны все поля сразу)
+    LogDataEntry at(int index) const;
+
+    const qint64 *times() const { return m_view.time; }
+    const float *angles(Axis axis) const;
+    const quint8 *buttons() const { return m_view.buttons; }
+
+    qint64 firstTime() const { return isEmpty() ? 0 : time(0); }
+    qint64 lastTime() const { return isEmpty() ? 0 : time(size() - 1); }
+
+    // Индекс последней записи со временем <= time, -1 если все записи позже
+    int findIndexByTime(qint64 time) const;
+
+    // Время первой записи каждого блока из blockSize записей (индекс файла сессии).
+    // findIndexByTime сначала выбирает блок по индексу и ищет только внутри него
+    void setBlockIndex(const QVector<qint64> &blockTimes, int blockSize);
+
+    // Объём данных в байтах (в постраничном режиме - только разобранные страницы)
+    qint64 memoryUsage() const;
+    // Данные лежат в отображённом файле (страницы подгружает ОС)
+    bool isMapped() const { return !m_file.isNull(); }
+    // Записи подкачиваются страницами из текстового файла
+    bool isPaged() const { return !m_paged.isNull(); }
+    // Бюджет памяти под страницы (только в постраничном режиме)
+    void setPagedMemoryBudget(qint64 bytes) const;
+
+private:
+    quint8 buttonsAt(int index) const { return Q_LIKELY(m_view.buttons) ? m_view.buttons[index] : pagedButtons(index); }
+
+    // ОПТИМИЗАЦИЯ: вызовы вне строки - обычные колонки платят только проверкой указателя
+    qint64 pagedTime(int index) const;
+    float pagedAngle(Axis axis, int index) const;
+    quint8 pagedButtons(int index) const;
+
+    SampleColumnView m_view;
+    QSharedPointer<const SampleColumns> m_columns;
+    QSharedPointer<QFile> m_file;
+    QSharedPointer<PagedLogFile> m_paged;
+    QVector<qint64> m_blockTimes;
+    int m_blockSize = 0;
+};
+
+#endif // SAMPLE_STORE_H
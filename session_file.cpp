@@ -0,0 +1,309 @@
+#include "session_file.h"
+#include "log_file_loader.h"
+#include <QDateTime>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSharedPointer>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = {'M', 'H', 'S', '1'};
+
+inline quint64 align8(quint64 offset)
+{
+    return (offset + 7) & ~quint64(7);
+}
+
+// Номер и дата исследования из заголовка текстового файла
+QString researchNumberFromHeader(const QStringList &headerLines)
+{
+    static const QRegularExpression re("Исследование №\\s*(\\d{6})");
+    for (const QString &line : headerLines) {
+        const QRegularExpressionMatch match = re.match(line);
+        if (match.hasMatch()) {
+            return match.captured(1);
+        }
+    }
+    return QString();
+}
+
+qint64 recordedAtFromHeader(const QStringList &headerLines)
+{
+    for (const QString &line : headerLines) {
+        const QDateTime dateTime = QDateTime::fromString(line.trimmed(), "yyyy-MM-dd HH:mm:ss");
+        if (dateTime.isValid()) {
+            return dateTime.toMSecsSinceEpoch();
+        }
+    }
+    return 0;
+}
+
+bool writeAll(QSaveFile &file, const void *data, qint64 size)
+{
+    return size == 0 || file.write(static_cast<const char *>(data), size) == size;
+}
+
+bool writePadding(QSaveFile &file, quint64 target)
+{
+    static const char zeros[8] = {};
+    const qint64 padding = static_cast<qint64>(target) - file.pos();
+    return padding >= 0 && padding < 8 && writeAll(file, zeros, padding);
+}
+
+} // namespace
+
+bool SessionFile::isSessionFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    char magic[sizeof(kMagic)];
+    return file.read(magic, sizeof(magic)) == sizeof(magic) &&
+           std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool SessionFile::readHeader(const uchar *data, qint64 size, Header &header, QString *errorString)
+{
+    static_assert(sizeof(Header) == 256, "SessionFile::Header must stay 256 bytes");
+
+    if (size < static_cast<qint64>(sizeof(Header))) {
+        *errorString = "файл сессии повреждён (нет заголовка)";
+        return false;
+    }
+
+    std::memcpy(&header, data, sizeof(Header));
+
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        *errorString = "это не файл сессии";
+        return false;
+    }
+    if (header.version != Version || header.headerSize != sizeof(Header)) {
+        *errorString = QString("неподдерживаемая версия файла сессии: %1").arg(header.version);
+        return false;
+    }
+    if (header.fileSize != static_cast<quint64>(size)) {
+        *errorString = "файл сессии обрезан";
+        return false;
+    }
+    if (header.sampleCount > static_cast<quint64>(INT_MAX) || header.blockSize == 0 ||
+        header.blockSize > static_cast<quint32>(INT_MAX)) {
+        *errorString = "файл сессии повреждён (число записей)";
+        return false;
+    }
+    // Число блоков задаётся числом записей; иначе размер индекса может переполниться
+    // или выйти за раздел
+    if (header.blockCount != (header.sampleCount + header.blockSize - 1) / header.blockSize) {
+        *errorString = "файл сессии повреждён (число блоков)";
+        return false;
+    }
+
+    // Каждый раздел должен целиком лежать в файле, колонки - быть выровнены
+    const quint64 n = header.sampleCount;
+    const quint64 fileSize = header.fileSize;
+    auto fits = [fileSize](quint64 offset, quint64 length, quint64 alignment) {
+        return offset % alignment == 0 && offset <= fileSize && length <= fileSize - offset;
+    };
+
+    if (!fits(header.textOffset, header.textSize, 1) ||
+        !fits(header.indexOffset, header.blockCount * sizeof(SessionBlock), 8) ||
+        !fits(header.timeOffset, n * sizeof(qint64), 8) ||
+        !fits(header.pitchOffset, n * sizeof(float), 4) ||
+        !fits(header.rollOffset, n * sizeof(float), 4) ||
+        !fits(header.yawOffset, n * sizeof(float), 4) ||
+        !fits(header.buttonsOffset, n, 1)) {
+        *errorString = "файл сессии повреждён (смещения разделов)";
+        return false;
+    }
+
+    return true;
+}
+
+bool SessionFile::load(const QString &fileName, LogFileContents &contents, QVector<SessionBlock> *blocks)
+{
+    contents = LogFileContents();
+
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    // Колонки используются без преобразования, а записаны в little-endian
+    contents.errorString = "файлы сессии не поддерживаются на этой платформе";
+    return false;
+#endif
+
+    QSharedPointer<QFile> file = QSharedPointer<QFile>::create(fileName);
+    if (!file->open(QIODevice::ReadOnly)) {
+        contents.errorString = file->errorString();
+        return false;
+    }
+
+    // ОПТИМИЗАЦИЯ: отображение не читает файл - страницы колонок подгрузятся при обращении.
+    // Открытие стоит одинаково для исследования на минуту и на сутки
+    const qint64 size = file->size();
+    const uchar *data = file->map(0, size);
+    if (!data) {
+        contents.errorString = "не удалось отобразить файл сессии в память: " + file->errorString();
+        return false;
+    }
+
+    Header header;
+    if (!readHeader(data, size, header, &contents.errorString)) {
+        return false;
+    }
+
+    if (header.textSize > 0) {
+        const QString text = QString::fromUtf8(reinterpret_cast<const char *>(data + header.textOffset),
+                                               static_cast<qsizetype>(header.textSize));
+        contents.headerLines = text.split('\n');
+    }
+
+    SampleColumnView view;
+    view.time = reinterpret_cast<const qint64 *>(data + header.timeOffset);
+    view.pitch = reinterpret_cast<const float *>(data + header.pitchOffset);
+    view.roll = reinterpret_cast<const float *>(data + header.rollOffset);
+    view.yaw = reinterpret_cast<const float *>(data + header.yawOffset);
+    view.buttons = data + header.buttonsOffset;
+    view.size = static_cast<int>(header.sampleCount);
+
+    // Время начала каждого блока - для поиска записи по времени. Индекс занимает
+    // доли процента файла, колонки при этом не читаются
+    const SessionBlock *index = reinterpret_cast<const SessionBlock *>(data + header.indexOffset);
+    const int blockCount = static_cast<int>(header.blockCount);
+    QVector<qint64> blockTimes(blockCount);
+    for (int block = 0; block < blockCount; ++block) {
+        blockTimes[block] = index[block].firstTime;
+        if (block > 0 && blockTimes[block] < blockTimes[block - 1]) {
+            contents.errorString = "файл сессии повреждён (индекс блоков)";
+            return false;
+        }
+    }
+
+    contents.samples = SampleStore(view, file);
+    contents.samples.setBlockIndex(blockTimes, static_cast<int>(header.blockSize));
+    contents.totalLines = static_cast<qint64>(header.sampleCount);
+
+    if (blocks) {
+        *blocks = QVector<SessionBlock>(index, index + blockCount);
+    }
+
+    return true;
+}
+
+QVector<SessionBlock> SessionFile::buildIndex(const SampleStore &samples)
+{
+    QVector<SessionBlock> index;
+    const int size = samples.size();
+    index.reserve((size + BlockSize - 1) / BlockSize);
+
+    const qint64 *time = samples.times();
+    const float *pitch = samples.angles(SampleStore::Pitch);
+    const float *roll = samples.angles(SampleStore::Roll);
+    const float *yaw = samples.angles(SampleStore::Yaw);
+    const quint8 *buttons = samples.buttons();
+
+    for (int begin = 0; begin < size; begin += BlockSize) {
+        const int end = qMin(size, begin + BlockSize);
+
+        SessionBlock block;
+        block.firstTime = time[begin];
+        block.lastTime = time[end - 1];
+        block.minPitch = *std::min_element(pitch + begin, pitch + end);
+        block.maxPitch = *std::max_element(pitch + begin, pitch + end);
+        block.minRoll = *std::min_element(roll + begin, roll + end);
+        block.maxRoll = *std::max_element(roll + begin, roll + end);
+        block.minYaw = *std::min_element(yaw + begin, yaw + end);
+        block.maxYaw = *std::max_element(yaw + begin, yaw + end);
+        block.patientSamples = 0;
+        block.doctorSamples = 0;
+        for (int i = begin; i < end; ++i) {
+            block.patientSamples += (buttons[i] & SampleStore::PatientButton) ? 1 : 0;
+            block.doctorSamples += (buttons[i] & SampleStore::DoctorButton) ? 1 : 0;
+        }
+        index.append(block);
+    }
+
+    return index;
+}
+
+bool SessionFile::write(const QString &fileName, const QStringList &headerLines,
+                        const SampleStore &samples, QString *errorString)
+{
+    QString error;
+    if (!errorString) {
+        errorString = &error;
+    }
+
+    // Колонки пишутся целиком, постраничным данным нужно сначала загрузиться в память
+    if (samples.isPaged()) {
+        *errorString = "исследование открыто постранично и не может быть записано";
+        return false;
+    }
+
+    const QByteArray text = headerLines.join('\n').toUtf8();
+    const QVector<SessionBlock> index = buildIndex(samples);
+    const quint64 n = static_cast<quint64>(samples.size());
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = Version;
+    header.headerSize = sizeof(Header);
+    header.blockSize = BlockSize;
+    header.sampleCount = n;
+    header.blockCount = static_cast<quint64>(index.size());
+    header.firstTime = samples.firstTime();
+    header.lastTime = samples.lastTime();
+    header.recordedAt = recordedAtFromHeader(headerLines);
+
+    const QByteArray number = researchNumberFromHeader(headerLines).toLatin1();
+    std::memcpy(header.researchNumber, number.constData(),
+                qMin<size_t>(number.size(), sizeof(header.researchNumber) - 1));
+
+    header.textOffset = sizeof(Header);
+    header.textSize = static_cast<quint64>(text.size());
+    header.indexOffset = align8(header.textOffset + header.textSize);
+    header.timeOffset = header.indexOffset + header.blockCount * sizeof(SessionBlock);
+    header.pitchOffset = align8(header.timeOffset + n * sizeof(qint64));
+    header.rollOffset = align8(header.pitchOffset + n * sizeof(float));
+    header.yawOffset = align8(header.rollOffset + n * sizeof(float));
+    header.buttonsOffset = align8(header.yawOffset + n * sizeof(float));
+    header.fileSize = header.buttonsOffset + n;
+
+    // Файл заменяется целиком только после успешной записи
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    const bool ok = writeAll(file, &header, sizeof(header)) &&
+                    writeAll(file, text.constData(), text.size()) &&
+                    writePadding(file, header.indexOffset) &&
+                    writeAll(file, index.constData(), index.size() * qint64(sizeof(SessionBlock))) &&
+                    writePadding(file, header.timeOffset) &&
+                    writeAll(file, samples.times(), n * sizeof(qint64)) &&
+                    writePadding(file, header.pitchOffset) &&
+                    writeAll(file, samples.angles(SampleStore::Pitch), n * sizeof(float)) &&
+                    writePadding(file, header.rollOffset) &&
+                    writeAll(file, samples.angles(SampleStore::Roll), n * sizeof(float)) &&
+                    writePadding(file, header.yawOffset) &&
+                    writeAll(file, samples.angles(SampleStore::Yaw), n * sizeof(float)) &&
+                    writePadding(file, header.buttonsOffset) &&
+                    writeAll(file, samples.buttons(), n);
+
+    if (!ok) {
+        *errorString = file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+
+    if (!file.commit()) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,88 @@
+#ifndef SESSION_FILE_H
+#define SESSION_FILE_H
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+#include <QtCore/QtGlobal>
+#include "sample_store.h"
+
+struct LogFileContents;
+
+// Сводка по блоку записей (хранится в индексе файла сессии)
+struct SessionBlock {
+    qint64 firstTime;
+    qint64 lastTime;
+    float minPitch;
+    float maxPitch;
+    float minRoll;
+    float maxRoll;
+    float minYaw;
+    float maxYaw;
+    quint32 patientSamples;     // Записей с нажатой кнопкой пациента
+    quint32 doctorSamples;      // Записей с нажатой кнопкой врача
+};
+
+// Бинарный файл сессии .mhs - то же исследование, что и текстовый Research_*.txt,
+// но открывается за постоянное время: файл отображается в память, а колонки
+// SampleStore указывают прямо в отображение (разбора и копирования нет).
+//
+// Формат (little-endian, все смещения выровнены на 8 байт):
+//   Header (256 байт)       сигнатура "MHS1", версия, число записей и блоков,
+//                           номер и дата исследования, смещения разделов
+//   текст заголовка         строки '#' исходного файла в UTF-8 через '\n'
+//   индекс                  SessionBlock на каждые BlockSize записей: время
+//                           начала/конца блока и минимумы/максимумы углов
+//   time                    qint64 * N, мс
+//   pitch, roll, yaw        float * N каждая колонка
+//   buttons                 quint8 * N, биты SampleStore::PatientButton/DoctorButton
+//
+// Блок - это BlockSize последовательных записей всех колонок; по индексу блок
+// находится по времени без обращения к самим колонкам
+class SessionFile
+{
+public:
+    static const int BlockSize = 4096;
+    static const quint32 Version = 1;
+
+    // Проверка сигнатуры (читаются только первые байты файла)
+    static bool isSessionFile(const QString &fileName);
+
+    // Открытие файла сессии; blocks - копия индекса (по записи на BlockSize отсчётов)
+    static bool load(const QString &fileName, LogFileContents &contents,
+                     QVector<SessionBlock> *blocks = nullptr);
+
+    static bool write(const QString &fileName, const QStringList &headerLines,
+                      const SampleStore &samples, QString *errorString = nullptr);
+
+    // Сводки блоков по данным (для записи файла)
+    static QVector<SessionBlock> buildIndex(const SampleStore &samples);
+
+private:
+    struct Header {
+        char magic[4];
+        quint32 version;
+        quint32 headerSize;
+        quint32 blockSize;
+        quint64 sampleCount;
+        quint64 blockCount;
+        qint64 firstTime;
+        qint64 lastTime;
+        qint64 recordedAt;          // Дата исследования, мс с эпохи (0 - неизвестна)
+        char researchNumber[16];    // "000009", дополнено нулями
+        quint64 textOffset;
+        quint64 textSize;
+        quint64 indexOffset;
+        quint64 timeOffset;
+        quint64 pitchOffset;
+        quint64 rollOffset;
+        quint64 yawOffset;
+        quint64 buttonsOffset;
+        quint64 fileSize;
+        char reserved[112];
+    };
+
+    static bool readHeader(const uchar *data, qint64 size, Header &header, QString *errorString);
+};
+
+#endif // SESSION_FILE_H
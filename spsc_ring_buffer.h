@@ -0,0 +1,80 @@
+#ifndef SPSC_RING_BUFFER_H
+#define SPSC_RING_BUFFER_H
+
+#include <QtCore/QVector>
+#include <atomic>
+#include <cstddef>
+
+// Кольцевой буфер без блокировок для одного производителя и одного потребителя.
+// Производитель (поток приёма) вызывает только push(), потребитель (GUI-поток) -
+// только pop()/clear(). Ёмкость округляется вверх до степени двойки.
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    explicit SpscRingBuffer(int capacity = 4096)
+    {
+        size_t rounded = 1;
+        while (rounded < static_cast<size_t>(capacity)) {
+            rounded <<= 1;
+        }
+        m_capacity = rounded;
+        m_mask = rounded - 1;
+        m_buffer.resize(static_cast<int>(rounded));
+        m_data = m_buffer.data();
+    }
+
+    // Возвращает false, если буфер заполнен (кадр отбрасывается)
+    bool push(const T &item)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        if (head - tail >= m_capacity) {
+            return false;
+        }
+
+        m_data[head & m_mask] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &item)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        if (tail == head) {
+            return false;
+        }
+
+        item = m_data[tail & m_mask];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Отбрасывает всё накопленное (вызывается со стороны потребителя)
+    void clear()
+    {
+        m_tail.store(m_head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    int size() const
+    {
+        return static_cast<int>(m_head.load(std::memory_order_acquire) -
+                                m_tail.load(std::memory_order_acquire));
+    }
+
+    int capacity() const { return static_cast<int>(m_capacity); }
+    bool isEmpty() const { return size() == 0; }
+
+private:
+    QVector<T> m_buffer;
+    T *m_data = nullptr;     // Буфер не разделяется, поэтому указатель стабилен
+    size_t m_capacity = 0;
+    size_t m_mask = 0;
+
+    // Индексы на разных кэш-линиях, чтобы потоки не мешали друг другу
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+#endif // SPSC_RING_BUFFER_H
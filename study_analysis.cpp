@@ -0,0 +1,125 @@
+#include "study_analysis.h"
+#include "log_file_loader.h"
+#include "log_reader.h"
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <cmath>
+
+DizzinessMetrics StudyAnalysis::dizziness(const SampleStore &samples, quint8 button)
+{
+    DizzinessMetrics metrics;
+    const int n = samples.size();
+    qint64 start = 0;
+    bool pressed = false;
+
+    for (int i = 0; i < n; ++i) {
+        const bool now = button == SampleStore::PatientButton ? samples.patientDizziness(i)
+                                                              : samples.doctorDizziness(i);
+        if (now && !pressed) {
+            metrics.episodes++;
+            start = samples.time(i);
+        } else if (!now && pressed) {
+            const qint64 length = samples.time(i) - start;
+            metrics.total += length;
+            metrics.longest = qMax(metrics.longest, length);
+        }
+        pressed = now;
+    }
+
+    if (pressed && n > 0) {
+        const qint64 length = samples.time(n - 1) - start;
+        metrics.total += length;
+        metrics.longest = qMax(metrics.longest, length);
+    }
+
+    return metrics;
+}
+
+StudyMetrics StudyAnalysis::analyzeFile(const QString &fileName, const Options &options)
+{
+    LogLoadControl control;
+    control.memoryBudget = options.memoryBudget;
+    LogFileContents contents;
+    if (!LogFileLoader::load(fileName, contents, &control)) {
+        StudyMetrics metrics;
+        metrics.file = fileName;
+        metrics.error = contents.errorString;
+        return metrics;
+    }
+
+    StudyMetrics metrics = analyze(contents, options);
+    metrics.file = fileName;
+
+    // Номер при его отсутствии в заголовке - из имени файла
+    if (metrics.researchNumber.isEmpty()) {
+        static const QRegularExpression fileNumberRe("Research_(\\d{6})_");
+        metrics.researchNumber = fileNumberRe.match(QFileInfo(fileName).fileName()).captured(1);
+    }
+    return metrics;
+}
+
+StudyMetrics StudyAnalysis::analyze(const LogFileContents &contents, const Options &options)
+{
+    StudyMetrics metrics;
+
+    const SampleStore &samples = contents.samples;
+    if (samples.isEmpty()) {
+        metrics.error = "no samples";
+        return metrics;
+    }
+
+    // Номер и дата - из заголовка
+    static const QRegularExpression numberRe("Исследование №\\s*(\\d{6})");
+    static const QRegularExpression dateRe("^\\d{4}-\\d{2}-\\d{2} \\d{2}:\\d{2}:\\d{2}$");
+    for (const QString &line : contents.headerLines) {
+        const QRegularExpressionMatch match = numberRe.match(line);
+        if (match.hasMatch()) {
+            metrics.researchNumber = match.captured(1);
+        } else if (dateRe.match(line.trimmed()).hasMatch()) {
+            metrics.recordedAt = line.trimmed();
+        }
+    }
+
+    const int n = samples.size();
+    metrics.samples = n;
+    metrics.failedLines = contents.failedLineCount;
+    metrics.duration = samples.lastTime() - samples.firstTime();
+    metrics.sampleRate = metrics.duration > 0 ? (n - 1) * 1000.0 / metrics.duration : 0.0;
+
+    // Диапазон движения - один проход по каждой колонке
+    for (int axis = 0; axis < 3; ++axis) {
+        AxisMetrics &result = metrics.axes[axis];
+        result.min = result.max = samples.angle(SampleStore::Axis(axis), 0);
+        for (int i = 1; i < n; ++i) {
+            const float value = samples.angle(SampleStore::Axis(axis), i);
+            result.min = qMin(result.min, value);
+            result.max = qMax(result.max, value);
+        }
+    }
+
+    // Скорость - тем же окном и формулой, что и при воспроизведении в программе
+    LogReader reader;
+    reader.setSmoothingWindow(options.window);
+    reader.setData(samples);
+
+    qint64 points = 0;
+    double sums[3] = {0.0, 0.0, 0.0};
+    // С первой записи: до неё скоростей нет, и нулевые точки занизили бы среднее
+    for (qint64 time = samples.firstTime(); time <= samples.lastTime(); time += options.step) {
+        for (int axis = 0; axis < 3; ++axis) {
+            const float speed = std::fabs(reader.angularSpeedAt(time, SampleStore::Axis(axis)));
+            metrics.axes[axis].peakSpeed = qMax(metrics.axes[axis].peakSpeed, speed);
+            sums[axis] += speed;
+        }
+        points++;
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        metrics.axes[axis].meanSpeed = points > 0 ? sums[axis] / points : 0.0;
+    }
+
+    metrics.patient = dizziness(samples, SampleStore::PatientButton);
+    metrics.doctor = dizziness(samples, SampleStore::DoctorButton);
+
+    metrics.ok = true;
+    return metrics;
+}
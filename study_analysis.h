@@ -0,0 +1,61 @@
+#ifndef STUDY_ANALYSIS_H
+#define STUDY_ANALYSIS_H
+
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+#include "sample_store.h"
+
+struct LogFileContents;
+
+// Метрики одного исследования: длительность, диапазон движения по осям, пиковая
+// и средняя угловая скорость (тем же окном, что LogReader при воспроизведении),
+// эпизоды головокружения. Общие для пакетного анализа и каталога исследований
+struct AxisMetrics {
+    float min = 0.0f;
+    float max = 0.0f;
+    float peakSpeed = 0.0f;     // Максимум модуля скорости, °/с
+    double meanSpeed = 0.0;     // Среднее модуля скорости, °/с
+};
+
+struct DizzinessMetrics {
+    int episodes = 0;
+    qint64 total = 0;           // мс
+    qint64 longest = 0;         // мс
+};
+
+struct StudyMetrics {
+    QString file;
+    bool ok = false;
+    QString error;
+    QString researchNumber;
+    QString recordedAt;
+    qint64 samples = 0;
+    qint64 failedLines = 0;
+    qint64 duration = 0;        // мс
+    double sampleRate = 0.0;    // Гц
+    AxisMetrics axes[3];
+    DizzinessMetrics patient;
+    DizzinessMetrics doctor;
+};
+
+class StudyAnalysis
+{
+public:
+    struct Options {
+        float window = 0.5f;        // Окно сглаживания скорости, с (как smoothingWindow в LogReader)
+        qint64 step = 100;          // Шаг, с которым считается скорость, мс
+        // Записи больше этого объёма читаются постранично: параллельно анализируется
+        // несколько исследований, и каждое не должно занимать память целиком
+        qint64 memoryBudget = 256 * 1024 * 1024;
+    };
+
+    // Загрузка файла (txt, mhs, mha) и все метрики; потокобезопасно
+    static StudyMetrics analyzeFile(const QString &fileName, const Options &options);
+    static StudyMetrics analyze(const LogFileContents &contents, const Options &options);
+
+    // Эпизоды - непрерывные серии записей с нажатой кнопкой; длительность считается
+    // по интервалам между записями, как интервалы на графике
+    static DizzinessMetrics dizziness(const SampleStore &samples, quint8 button);
+};
+
+#endif // STUDY_ANALYSIS_H
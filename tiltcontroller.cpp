@@ -1,4 +1,6 @@
 #include "tiltcontroller.h"
+#include "frame_parser.h"
+#include "log_file_loader.h"
 #include <QDebug>
 #include <QFile>
 #include <QTextStream>
@@ -9,6 +11,8 @@
 #include <QTcpSocket>
 #include <QHostAddress>
 #include <QStandardPaths>
+#include <QQuickWindow>
+#include <QScreen>
 #include <algorithm>
 
 TiltController::TiltController(QObject *parent) : QObject(parent)
@@ -21,26 +25,27 @@ TiltController::TiltController(QObject *parent) : QObject(parent)
     , m_wifiPort(8080)
     , m_wifiConnected(false)
 {
+    m_logCursor.setStore(&m_samples);
+
+    m_seekTimer.setSingleShot(true);
+    connect(&m_seekTimer, &QTimer::timeout, this, &TiltController::applyPendingSeek);
+
+    m_playbackClock.start();
     m_logTimer.setInterval(16);
-    connect(&m_logTimer, &QTimer::timeout, this, &TiltController::updateLogPlayback);
+    m_logTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_logTimer, &QTimer::timeout, this, &TiltController::onPlaybackTimer);
 
     m_autoConnectTimer.setInterval(5000);
     connect(&m_autoConnectTimer, &QTimer::timeout, this, &TiltController::autoConnect);
 
-    m_safetyTimer.setInterval(2000);
-    connect(&m_safetyTimer, &QTimer::timeout, this, [this]() {
-        if (m_serialPort && m_serialPort->isOpen()) {
-            if (m_serialPort->error() == QSerialPort::ResourceError) {
-                qDebug() << "Safety timer detected port error, cleaning up...";
-                safeDisconnect();
-            }
-        }
-    });
+    // Загрузка лог-файлов: по одной в фоне, ход опрашивается 10 раз в секунду
+    m_loadPool.setMaxThreadCount(1);
+    m_loadProgressTimer.setInterval(100);
+    connect(&m_loadProgressTimer, &QTimer::timeout, this, &TiltController::updateLoadProgress);
 
     // Инициализация переменных для исследования
     m_researchFrameCounter = 1;
     m_headModel.resetData();
-    refreshPorts();
     // m_autoConnectTimer.start();  // запуск таймера автопереподключения
     addNotification("Программа запущена. Готово к подключению по WiFi...");  // ИЗМЕНЕНО: Уведомление
 
@@ -56,23 +61,17 @@ TiltController::TiltController(QObject *parent) : QObject(parent)
 
     // ОПТИМИЗАЦИЯ: Инициализация временных меток
     m_startTime = QDateTime::currentMSecsSinceEpoch();
+    m_sessionClockOrigin = m_playbackClock.nsecsElapsed();
     m_lastDataTime = 0;
-    m_useRelativeTime = true; // Используем относительное время для синхронизации
     m_lastDizzinessState = false;
     m_currentDizzinessStart = 0;
 
     // Инициализация переменных синхронизации
-    m_playbackStartRealTime = 0;
     m_playbackStartLogTime = 0;
     m_playbackTimeInitialized = false;
 
     m_graphDisplayTime = m_graphDuration * 1000; // Начальное значение: показываем первые 30 секунд
 
-    // Инициализация переменных синхронизации
-    m_playbackStartRealTime = 0;
-    m_playbackStartLogTime = 0;
-    m_playbackTimeInitialized = false;
-
     // Инициализация буферов истории
     m_pitchHistory.reserve(m_speedCalculationPoints + 1);
     m_rollHistory.reserve(m_speedCalculationPoints + 1);
@@ -92,22 +91,67 @@ TiltController::TiltController(QObject *parent) : QObject(parent)
 
     emit angularSpeedUpdateFrequencyChanged(m_angularSpeedUpdateFrequency);
 
-    m_comSpeedUpdateTimer.setInterval(1000 / m_angularSpeedUpdateFrequencyCOM);
-    connect(&m_comSpeedUpdateTimer, &QTimer::timeout, this, &TiltController::updateCOMAngularSpeeds);
+    m_comSpeedEstimator.setWindow(LiveSpeedWindowMs);
 
     m_lastAngularSpeedUpdate = 0;
 
-    // Инициализация TCP сокета для WiFi
-    m_tcpSocket = new QTcpSocket(this);
-    connect(m_tcpSocket, &QTcpSocket::readyRead, this, &TiltController::readWiFiData);
-    connect(m_tcpSocket, &QTcpSocket::errorOccurred, this, &TiltController::handleWiFiError);
-    connect(m_tcpSocket, &QTcpSocket::stateChanged, this, &TiltController::handleWiFiStateChanged);
+    // Поток приёма данных: COM-порт и TCP сокет живут в нём вместе с разбором строк
+    m_ingestWorker = new IngestWorker(&m_ingestQueue);
+    m_ingestWorker->moveToThread(&m_ingestThread);
+    connect(&m_ingestThread, &QThread::finished, m_ingestWorker, &QObject::deleteLater);
+    connect(m_ingestWorker, &IngestWorker::serialPortError, this, &TiltController::handleCOMPortError);
+    connect(m_ingestWorker, &IngestWorker::tcpConnectFinished, this, &TiltController::handleWiFiConnectFinished);
+    connect(m_ingestWorker, &IngestWorker::tcpError, this, &TiltController::handleWiFiError);
+    connect(m_ingestWorker, &IngestWorker::tcpDisconnected, this, &TiltController::handleWiFiDisconnected);
+    connect(m_ingestWorker, &IngestWorker::streamFormatDetected, this, &TiltController::handleStreamFormatDetected);
+    connect(m_ingestWorker, &IngestWorker::lostPacketsChanged, this, &TiltController::handleLostPacketsChanged);
+    connect(m_ingestWorker, &IngestWorker::timebaseUpdated, this, &TiltController::handleTimebaseUpdated);
+    qRegisterMetaType<IngestStats>();
+    connect(m_ingestWorker, &IngestWorker::statsUpdated, this, &TiltController::handleIngestStats);
+    m_ingestThread.setObjectName("MonitorHeadIngest");
+    m_ingestThread.start();
+
+    // Очередь кадров выбирается один раз за кадр отрисовки (~60 Гц)
+    m_ingestDrainTimer.setInterval(16);
+    m_ingestDrainTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_ingestDrainTimer, &QTimer::timeout, this, &TiltController::drainIngestQueue);
+
+    // Список COM-портов ведётся в отдельном потоке и обновляется по событиям системы
+    m_portWatcher = new PortWatcher;
+    m_portWatcher->moveToThread(&m_portWatcherThread);
+    connect(&m_portWatcherThread, &QThread::finished, m_portWatcher, &QObject::deleteLater);
+    connect(m_portWatcher, &PortWatcher::portsChanged, this, &TiltController::handlePortsChanged);
+    m_portWatcherThread.setObjectName("MonitorHeadPorts");
+    m_portWatcherThread.start(QThread::LowPriority);
+    QMetaObject::invokeMethod(m_portWatcher, &PortWatcher::start, Qt::QueuedConnection);
+
+    // Подключение и переподключение: транспорт открывается по запросу менеджера
+    connect(&m_connectionManager, &ConnectionManager::openRequested, this, &TiltController::openTransport);
+    connect(&m_connectionManager, &ConnectionManager::linkLost, this, &TiltController::handleLinkLost);
+    connect(&m_connectionManager, &ConnectionManager::sessionResumed, this, &TiltController::handleSessionResumed);
+    connect(&m_connectionManager, &ConnectionManager::sessionRestarted, this, &TiltController::handleSessionRestarted);
+    connect(&m_connectionManager, &ConnectionManager::connectFailed, this, &TiltController::handleConnectFailed);
+    connect(&m_connectionManager, &ConnectionManager::gaveUp, this, &TiltController::handleReconnectGaveUp);
+    connect(&m_connectionManager, &ConnectionManager::stateChanged, this, &TiltController::handleConnectionStateChanged);
 }
 
 TiltController::~TiltController()
 {
     m_isCleaningUp = true;
     cleanupCOMPort();
+
+    // Фоновая загрузка обращается к контроллеру - дожидаемся её остановки
+    if (m_loadControl) {
+        m_loadControl->cancelled = true;
+    }
+    cancelSpeedChannels();
+    m_loadPool.waitForDone();
+
+    m_ingestThread.quit();
+    m_ingestThread.wait();
+
+    m_portWatcherThread.quit();
+    m_portWatcherThread.wait();
 }
 
 // Новый метод для настройки LogReader
@@ -116,57 +160,76 @@ void TiltController::setupLogReader()
     m_logReader.setUpdateFrequency(m_angularSpeedUpdateFrequency);
 }
 
-// Новый метод для обновления угловых скоростей с использованием LogReader
-void TiltController::updateAngularSpeeds()
+void TiltController::updateSpeedChannels()
 {
-    if (!m_logLoaded || m_logData.isEmpty()) return;
+    cancelSpeedChannels();
 
-    float speedPitch = m_logReader.calculateAngularSpeed(m_currentTime, "pitch", m_logPlaying);
-    float speedRoll = m_logReader.calculateAngularSpeed(m_currentTime, "roll", m_logPlaying);
-    float speedYaw = m_logReader.calculateAngularSpeed(m_currentTime, "yaw", m_logPlaying);
-
-    // Обновляем модель с новыми скоростями
-    if (m_currentLogIndex >= 0 && m_currentLogIndex < m_logData.size()) {
-        const LogEntry &entry = m_logData[m_currentLogIndex];
-        updateHeadModel(entry.pitch, entry.roll, entry.yaw,
-                        speedPitch, speedRoll, speedYaw,
-                        entry.dizziness || entry.doctorDizziness);
+    // PagedLogFile читается только из GUI-потока, а каналы на всю многочасовую запись
+    // заняли бы память, которую ограничивает бюджет: для постраничных записей
+    // скорость считается по окну при каждом обновлении
+    if (!m_logLoaded || m_samples.isEmpty() || m_samples.isPaged()) {
+        return;
     }
+
+    const quint64 generation = m_speedChannelsGeneration;
+    QSharedPointer<std::atomic<bool>> cancelled = QSharedPointer<std::atomic<bool>>::create(false);
+    m_speedChannelsCancelled = cancelled;
+    const SampleStore samples = m_samples;
+    const float window = m_logReader.smoothingWindow();
+
+    m_loadPool.start([this, generation, samples, window, cancelled]() {
+        const AngularSpeedChannels channels = AngularSpeedChannels::compute(samples, window, cancelled.data());
+        if (channels.isEmpty()) {
+            return;
+        }
+
+        QMetaObject::invokeMethod(this, [this, generation, channels]() {
+            if (generation != m_speedChannelsGeneration) {
+                return; // Окно или запись уже сменились
+            }
+            m_speedChannelsCancelled.reset();
+            m_logReader.setSpeedChannels(channels);
+        }, Qt::QueuedConnection);
+    });
 }
 
-void TiltController::initializeResearchNumber()
+void TiltController::cancelSpeedChannels()
 {
-    QString researchDir = getResearchDirectory();
-    QDir dir(researchDir);
-    int maxNumber = 0;
-
-    // Создаем папку если не существует
-    if (!dir.exists()) {
-        dir.mkpath(".");
+    // Результат уже запущенного расчёта будет отброшен по номеру поколения
+    ++m_speedChannelsGeneration;
+    if (m_speedChannelsCancelled) {
+        *m_speedChannelsCancelled = true;
+        m_speedChannelsCancelled.reset();
     }
+}
 
-    // Ищем файлы исследований
-    QStringList filters;
-    filters << "Research_*.txt";
-    dir.setNameFilters(filters);
-    dir.setSorting(QDir::Name);
+// Новый метод для обновления угловых скоростей с использованием LogReader
+void TiltController::updateAngularSpeeds()
+{
+    if (!m_logLoaded || m_samples.isEmpty()) return;
 
-    QFileInfoList files = dir.entryInfoList();
+    const int index = m_logCursor.index();
+    float speedPitch = m_logReader.angularSpeedAtIndex(index, SampleStore::Pitch);
+    float speedRoll = m_logReader.angularSpeedAtIndex(index, SampleStore::Roll);
+    float speedYaw = m_logReader.angularSpeedAtIndex(index, SampleStore::Yaw);
 
-    for (const QFileInfo &file : files) {
-        QString fileName = file.fileName();
-        QRegularExpression re("Research_(\\d{6})_\\d{4}_\\d{2}_\\d{2}_\\d{2}_\\d{2}_\\d{2}\\.txt");
-        QRegularExpressionMatch match = re.match(fileName);
+    // Обновляем модель с новыми скоростями
+    const LogDataEntry entry = m_samples.at(index);
+    updateHeadModel(entry.pitch, entry.roll, entry.yaw,
+                    speedPitch, speedRoll, speedYaw,
+                    entry.dizziness || entry.doctorDizziness);
+}
 
-        if (match.hasMatch()) {
-            int number = match.captured(1).toInt();
-            if (number > maxNumber) {
-                maxNumber = number;
-            }
-        }
+void TiltController::initializeResearchNumber()
+{
+    // ОПТИМИЗАЦИЯ: номер берётся из каталога исследований. Каталог сверяется с папкой
+    // по размеру и времени изменения файлов, сводки новых файлов считаются в фоне
+    const QString researchDir = getResearchDirectory();
+    if (m_researchCatalog.directory() != researchDir) {
+        m_researchCatalog.open(researchDir);
     }
 
-    m_researchNumber = QString::number(maxNumber + 1).rightJustified(6, '0');
+    m_researchNumber = QString::number(m_researchCatalog.maxResearchNumber() + 1).rightJustified(6, '0');
     emit researchNumberChanged(m_researchNumber);
 }
 
@@ -214,24 +277,35 @@ QString TiltController::generateResearchFileName(const QString &number)
     QString dateStr = now.toString("yyyy_MM_dd");
     QString timeStr = now.toString("hh_mm_ss");
 
-    return QString("%1/Research_%2_%3_%4.txt")
+    return QString("%1/Research_%2_%3_%4.%5")
         .arg(researchDir)
         .arg(number)
         .arg(dateStr)
-        .arg(timeStr);
+        .arg(timeStr)
+        .arg(m_compressedRecording ? "mha" : "txt");
 }
 
 void TiltController::writeResearchHeader()
 {
-    if (!m_researchStream) return;
+    if (!m_researchRecorder.isOpen()) return;
 
     QString dateTimeStr = m_researchStartTime.toString("yyyy-MM-dd hh:mm:ss");
 
-    *m_researchStream << "##########\n";
-    *m_researchStream << "# Исследование № " << m_researchNumber << "\n";
-    *m_researchStream << "# " << dateTimeStr << "\n";
-    *m_researchStream << "##########\n";
-    m_researchStream->flush();
+    QTextStream &out = m_researchRecorder.comments();
+    out << "##########\n";
+    out << "# Исследование № " << m_researchNumber << "\n";
+    out << "# " << dateTimeStr << "\n";
+    out << "##########\n";
+    m_researchRecorder.flush();
+}
+
+void TiltController::setCompressedRecording(bool compressed)
+{
+    if (m_compressedRecording != compressed) {
+        // Формат текущей записи не меняется, настройка действует со следующей
+        m_compressedRecording = compressed;
+        emit compressedRecordingChanged(m_compressedRecording);
+    }
 }
 
 void TiltController::connectDevice()
@@ -246,19 +320,28 @@ void TiltController::connectDevice()
         return;
     }
 
+    // Повторное нажатие во время первого подключения отменяет его
+    if (m_connectionManager.state() == ConnectionManager::Connecting) {
+        m_connectionManager.stop();
+        cleanupWiFiConnection();
+        addNotification("Подключение отменено");
+        return;
+    }
+
     if (m_connectionType == "COM") {
         if (m_selectedPort.isEmpty()) {
             addNotification("Ошибка: COM-порт не выбран");
             return;
         }
-        setupCOMPort();
     } else if (m_connectionType == "WiFi") {
         if (m_wifiAddress.isEmpty()) {
             addNotification("Ошибка: WiFi адрес не указан");
             return;
         }
-        setupWiFiConnection();
     }
+
+    // Транспорт открывается по сигналу openRequested (см. openTransport)
+    m_connectionManager.start();
 }
 
 void TiltController::disconnectDevice()
@@ -266,56 +349,30 @@ void TiltController::disconnectDevice()
     safeDisconnect();
 }
 
-void TiltController::readCOMPortData()
-{
-    if (!m_serialPort || !m_serialPort->isOpen() || m_isCleaningUp) {
-        return;
-    }
-
-    try {
-        QByteArray data = m_serialPort->readAll();
-
-        if (data.isEmpty()) {
-            return;
-        }
-
-        processCOMPortData(data);
-
-    } catch (const std::exception& e) {
-        safeDisconnect();
-    }
-}
-
-void TiltController::handleCOMPortError(QSerialPort::SerialPortError error)
+void TiltController::handleCOMPortError(QSerialPort::SerialPortError error, const QString &errorString)
 {
-    if (m_isCleaningUp) return;
+    // Сигнал мог прийти из потока приёма уже после отключения или разрыва
+    if (m_isCleaningUp || !m_connectionManager.isLinkUp()) return;
 
     switch (error) {
     case QSerialPort::NoError:
         return;
 
-    case QSerialPort::ResourceError:
-        safeDisconnect();
-        break;
-
     case QSerialPort::PermissionError:
+        // Порт занят другой программой - повторные попытки не помогут
         addNotification("Ошибка доступа к COM-порту. Закройте другие программы, использующие этот порт.");
         safeDisconnect();
         break;
 
+    case QSerialPort::ResourceError:
     case QSerialPort::DeviceNotFoundError:
-        addNotification("COM-порт не найден. Устройство было отключено.");
-        safeDisconnect();
+        // Кабель выдернули или устройство перезагрузилось: пробуем открыть порт снова
+        m_connectionManager.handleLinkLost("COM-порт недоступен");
         break;
 
     default:
-        // ДЛЯ ЛЮБОЙ ДРУГОЙ ОШИБКИ ТОЖЕ ВЫЗЫВАЕМ safeDisconnect
-        if (m_serialPort) {
-            addNotification("Ошибка COM-порта: " + m_serialPort->errorString() + ". Соединение разорвано.");
-        } else {
-            addNotification("Ошибка COM-порта. Соединение разорвано.");
-        }
-        safeDisconnect();  // ДОБАВЛЯЕМ ВЫЗОВ ДЛЯ ВСЕХ ОСТАЛЬНЫХ ОШИБОК
+        m_connectionManager.handleLinkLost(errorString.isEmpty() ? QString("ошибка COM-порта")
+                                                                 : "ошибка COM-порта: " + errorString);
         break;
     }
 }
@@ -370,12 +427,19 @@ void TiltController::switchToCOMPortMode()
 
 void TiltController::playLog()
 {
-    if (!m_logLoaded || m_logData.isEmpty()) return;
+    if (!m_logLoaded || m_samples.isEmpty()) return;
+
+    // Воспроизведение начинается с последней запрошенной позиции
+    applyPendingSeek();
 
     m_logPlaying = true;
     m_playbackTimeInitialized = false;
 
+    // Таймер заказывает кадры окна (или сам ведёт воспроизведение, если окна нет)
     m_logTimer.start();
+    if (m_frameWindow) {
+        m_frameWindow->update();
+    }
 
     emit logPlayingChanged(m_logPlaying);
     addNotification("Воспроизведение данных начато");
@@ -409,22 +473,20 @@ void TiltController::setSelectedPort(const QString &port)
 
 void TiltController::refreshPorts()
 {
-    QStringList oldPorts = m_availablePorts;
-    m_availablePorts.clear();
+    // Перечисление выполняется в потоке наблюдателя, результат придёт в handlePortsChanged
+    QMetaObject::invokeMethod(m_portWatcher, &PortWatcher::refresh, Qt::QueuedConnection);
+}
 
-    QList<QSerialPortInfo> ports = QSerialPortInfo::availablePorts();
-    for (const QSerialPortInfo &port : ports) {
-        m_availablePorts << port.portName();
-    }
+void TiltController::handlePortsChanged(const QStringList &ports)
+{
+    QStringList oldPorts = m_availablePorts;
+    m_availablePorts = ports;
 
     if (m_availablePorts.isEmpty()) {
         m_availablePorts << "COM1" << "COM2" << "COM3";
         qDebug() << "No real COM ports found, using simulation ports";
     }
 
-    // Сортируем порты для удобства
-    std::sort(m_availablePorts.begin(), m_availablePorts.end());
-
     // Проверяем изменения
     bool changed = (oldPorts != m_availablePorts);
 
@@ -451,13 +513,12 @@ void TiltController::refreshPorts()
         qDebug() << "COM ports refreshed. Available:" << m_availablePorts
                  << "Selected:" << m_selectedPort;
     }
-}
 
-QStringList TiltController::availablePorts()
-{
-    // Автоматически обновляем список при запросе
-    refreshPorts();
-    return m_availablePorts;
+    // Порт прерванной сессии снова появился - не ждём очередной паузы переподключения
+    if (m_connectionType == "COM" && m_connectionManager.state() == ConnectionManager::Reconnecting
+        && ports.contains(m_sessionPort)) {
+        m_connectionManager.retryNow();
+    }
 }
 
 void TiltController::updateHeadModel(float pitch, float roll, float yaw,
@@ -466,12 +527,15 @@ void TiltController::updateHeadModel(float pitch, float roll, float yaw,
 {
     m_headModel.setMotionData(pitch, roll, yaw, speedPitch, speedRoll, speedYaw, dizziness);
 
-    static qint64 lastGraphUpdate = 0;
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+    updateGraphsThrottled(1000 / m_updateFrequency);
+}
 
-    if (currentTime - lastGraphUpdate >= (1000 / m_updateFrequency)) {
+void TiltController::updateGraphsThrottled(qint64 interval)
+{
+    const qint64 now = m_playbackClock.elapsed();
+    if (now - m_lastGraphUpdate >= interval) {
         updateGraphDataFromBuffer();
-        lastGraphUpdate = currentTime;
+        m_lastGraphUpdate = now;
     }
 }
 
@@ -494,6 +558,18 @@ void TiltController::setGraphDuration(int duration)
     }
 }
 
+void TiltController::setLogMemoryBudget(int megabytes)
+{
+    megabytes = qBound(64, megabytes, 1 << 20);
+
+    if (m_logMemoryBudget != megabytes) {
+        m_logMemoryBudget = megabytes;
+        // Открытое постранично исследование сразу подстраивает кэш страниц
+        m_samples.setPagedMemoryBudget(qint64(m_logMemoryBudget) * 1024 * 1024);
+        emit logMemoryBudgetChanged(m_logMemoryBudget);
+    }
+}
+
 void TiltController::updateDataDisplay()
 {
     static int updateCounter = 0;
@@ -544,84 +620,169 @@ void TiltController::loadLogFile(const QString &filePath)
         return;
     }
 
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        addNotification("Ошибка открытия файла: " + fileName);
-        return;
+    // Предыдущая загрузка больше не нужна - её результат будет отброшен
+    if (m_loadControl) {
+        m_loadControl->cancelled = true;
     }
 
-    // СОЗДАЕМ fileInfo ДО его использования
-    QFileInfo fileInfo(fileName);
+    if (m_logPlaying) {
+        stopLog();
+    }
 
-    m_logData.clear();
-    m_currentLogIndex = 0;
+    m_samples = SampleStore();
+    m_logReader.setData(m_samples);
+    cancelSpeedChannels();
+    m_logCursor.setIndex(0);
+    m_graphWindowCache.clear();
+    m_pendingSeekTime = -1;
     m_studyInfo.clear();
     m_dataBuffer.clear(); // Очищаем буфер
     m_loadedResearchNumber.clear(); // Сбрасываем номер загруженного исследования
 
-    QTextStream in(&file);
-    int lineNumber = 0;
-    QStringList studyLines;
+    if (m_logLoaded) {
+        m_logLoaded = false;
+        emit logLoadedChanged(m_logLoaded);
+        emit logControlsEnabledChanged(logControlsEnabled());
+    }
 
-    // Создаем временный вектор для LogReader
-    QVector<LogDataEntry> logReaderData;
+    // ВАЖНО: разбор идёт в фоне, окно остаётся отзывчивым и загрузку можно отменить.
+    // Ответы устаревших загрузок отсекаются по номеру поколения
+    const quint64 generation = ++m_loadGeneration;
+    QSharedPointer<LogLoadControl> control = QSharedPointer<LogLoadControl>::create();
+    control->onPreview = [this, generation](const QStringList &headerLines, const SampleStore &preview) {
+        QMetaObject::invokeMethod(this, [this, generation, headerLines, preview]() {
+            applyLogPreview(generation, headerLines, preview);
+        }, Qt::QueuedConnection);
+    };
+    control->memoryBudget = qint64(m_logMemoryBudget) * 1024 * 1024;
+    m_loadControl = control;
+
+    m_loadProgress = 0.0;
+    m_loading = true;
+    emit loadProgressChanged(m_loadProgress);
+    emit loadingChanged(m_loading);
+    m_loadProgressTimer.start();
+
+    m_loadPool.start([this, generation, fileName, control]() {
+        QSharedPointer<LogFileContents> contents = QSharedPointer<LogFileContents>::create();
+        const bool ok = LogFileLoader::load(fileName, *contents, control.data());
+
+        QMetaObject::invokeMethod(this, [this, generation, fileName, ok, contents]() {
+            finishLogLoad(generation, fileName, ok, contents);
+        }, Qt::QueuedConnection);
+    });
+}
 
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        lineNumber++;
+void TiltController::cancelLogLoading()
+{
+    if (m_loading && m_loadControl) {
+        m_loadControl->cancelled = true;
+    }
+}
 
-        if (lineNumber <= 5 && line.startsWith('#')) {
-            studyLines << line.mid(1).trimmed();
-            continue;
-        }
+void TiltController::updateLoadProgress()
+{
+    if (!m_loadControl) {
+        return;
+    }
 
-        if (line.isEmpty() || line.startsWith("##########")) {
-            continue;
-        }
+    const qint64 total = m_loadControl->bytesTotal.load();
+    const qint64 parsed = m_loadControl->bytesParsed.load();
+    const double progress = total > 0 ? qBound(0.0, double(parsed) / double(total), 1.0) : 0.0;
 
-        QStringList parts = line.split(';');
-        if (parts.size() >= 6) {
-            LogEntry entry;  // TiltController::LogEntry
-            LogDataEntry readerEntry;  // LogReader::LogDataEntry
-            bool ok1, ok2, ok3, ok4, ok5, ok6;
-
-            entry.time = parts[0].toLongLong(&ok1);
-            entry.pitch = parts[1].replace(',', '.').toFloat(&ok2);
-            entry.roll = parts[2].replace(',', '.').toFloat(&ok3);
-            entry.yaw = parts[3].replace(',', '.').toFloat(&ok4);
-
-            // Заполняем данные для LogReader
-            readerEntry.time = entry.time;
-            readerEntry.pitch = entry.pitch;
-            readerEntry.roll = entry.roll;
-            readerEntry.yaw = entry.yaw;
-
-            // Парсим головокружение пациента и врача
-            if (parts.size() >= 6) {
-                entry.dizziness = (parts[4].toInt(&ok5) == 1);
-                entry.doctorDizziness = (parts[5].toInt(&ok6) == 1);
-
-                readerEntry.dizziness = entry.dizziness;
-                readerEntry.doctorDizziness = entry.doctorDizziness;
-            }
+    if (!qFuzzyCompare(1.0 + progress, 1.0 + m_loadProgress)) {
+        m_loadProgress = progress;
+        emit loadProgressChanged(m_loadProgress);
+    }
+}
+
+// Начало файла разобрано: показываем первый экран графиков, остальное ещё загружается
+void TiltController::applyLogPreview(quint64 generation, const QStringList &headerLines, const SampleStore &preview)
+{
+    if (generation != m_loadGeneration || !m_loading || preview.isEmpty()) {
+        return;
+    }
 
-            if (ok1 && ok2 && ok3 && ok4 && ok5) {
-                // Вычисляем скорости (для совместимости)
-                entry.speedPitch = 0.0f;
-                entry.speedRoll = 0.0f;
-                entry.speedYaw = 0.0f;
+    m_samples = preview;
+    m_logMode = true;
+    m_currentTime = 0;
+    m_logCursor.setIndex(0);
+    m_graphWindowCache.clear();
+    m_pendingSeekTime = -1;
+    m_graphDisplayTime = m_currentTime + 30000;
 
-                m_logData.append(entry);
-                logReaderData.append(readerEntry);
-            } else {
-                qDebug() << "Failed to parse line:" << line;
-            }
+    if (!headerLines.isEmpty()) {
+        m_studyInfo = headerLines.join(" | ");
+        emit studyInfoChanged(m_studyInfo);
+    }
+
+    emit logModeChanged(m_logMode);
+    emit currentTimeChanged(m_currentTime);
+
+    updateGraphDataFromBuffer();
+}
+
+void TiltController::finishLogLoad(quint64 generation, const QString &fileName, bool ok,
+                                   const QSharedPointer<LogFileContents> &contents)
+{
+    if (generation != m_loadGeneration) {
+        return; // Результат отменённой загрузки, уже начата новая
+    }
+
+    m_loadProgressTimer.stop();
+    m_loadControl.reset();
+    m_loading = false;
+    m_loadProgress = ok ? 1.0 : 0.0;
+    emit loadProgressChanged(m_loadProgress);
+    emit loadingChanged(m_loading);
+
+    if (!ok) {
+        // Убираем предварительный просмотр
+        m_samples = SampleStore();
+        m_pitchGraphData.clear();
+        m_rollGraphData.clear();
+        m_yawGraphData.clear();
+        m_dizzinessPatientData.clear();
+        m_dizzinessDoctorData.clear();
+        emit graphDataChanged();
+
+        if (contents->cancelled) {
+            addNotification("Загрузка файла отменена");
         } else {
-            qDebug() << "Invalid line format:" << line;
+            addNotification("Ошибка открытия файла: " + fileName);
         }
+        return;
     }
 
-    file.close();
+    // СОЗДАЕМ fileInfo ДО его использования
+    QFileInfo fileInfo(fileName);
+
+    const QStringList &studyLines = contents->headerLines;
+
+    // ОПТИМИЗАЦИЯ: одна копия данных на контроллер, LogReader и графики
+    m_samples = contents->samples;
+
+    // Ошибочные строки - одним сообщением с номерами вместо qDebug на каждую
+    if (contents->failedLineCount > 0) {
+        QStringList numbers;
+        for (int i = 0; i < contents->failedLines.size() && i < 10; ++i) {
+            numbers << QString::number(contents->failedLines[i]);
+        }
+        if (contents->failedLineCount > numbers.size()) {
+            numbers << "...";
+        }
+
+        qWarning() << "Log file" << fileName << ":" << contents->failedLineCount
+                   << "lines failed to parse, line numbers:" << contents->failedLines;
+        // Для архива .mha пропускаются не строки, а повреждённые блоки
+        if (!contents->errorString.isEmpty()) {
+            addNotification(QString("%1 (блоки %2)").arg(contents->errorString, numbers.join(", ")));
+        } else {
+            addNotification(QString("Пропущено строк с ошибками: %1 (строки %2)")
+                                .arg(contents->failedLineCount)
+                                .arg(numbers.join(", ")));
+        }
+    }
 
     if (!studyLines.isEmpty()) {
         m_studyInfo = studyLines.join(" | ");
@@ -634,21 +795,29 @@ void TiltController::loadLogFile(const QString &filePath)
         m_loadedResearchNumber = "000000"; // значение по умолчанию
     }
 
-    if (m_logData.isEmpty()) {
+    if (m_samples.isEmpty()) {
         addNotification("В файле нет корректных данных лога");
         m_logLoaded = false;
         emit logLoadedChanged(m_logLoaded);
         return;
     }
 
+    if (m_samples.isPaged()) {
+        addNotification(QString("Файл больше %1 МБ памяти, записи подгружаются по мере просмотра")
+                            .arg(m_logMemoryBudget));
+    }
+
     m_logLoaded = true;
     m_logMode = true;
-    m_totalTime = m_logData.last().time;
+    m_totalTime = static_cast<int>(m_samples.lastTime());
     m_currentTime = 0;
-    m_currentLogIndex = 0;
+    m_logCursor.setIndex(0);
+    m_graphWindowCache.clear();
+    m_pendingSeekTime = -1;
 
-    // Передаем данные в LogReader
-    m_logReader.setData(logReaderData);
+    // Передаем данные в LogReader; скорости по всей записи считаются в фоне
+    m_logReader.setData(m_samples);
+    updateSpeedChannels();
 
     if (m_connected) {
         disconnectDevice();
@@ -656,9 +825,9 @@ void TiltController::loadLogFile(const QString &filePath)
     m_autoConnectTimer.stop();
 
     // После загрузки данных проверим временные метки
-    if (!m_logData.isEmpty()) {
-        qint64 minTime = m_logData.first().time;
-        qint64 maxTime = m_logData.last().time;
+    if (!m_samples.isEmpty()) {
+        qint64 minTime = m_samples.firstTime();
+        qint64 maxTime = m_samples.lastTime();
         qint64 duration = maxTime - minTime;
 
         // Если длительность слишком мала или велика, скорректируем
@@ -670,7 +839,7 @@ void TiltController::loadLogFile(const QString &filePath)
     // УВЕДОМЛЯЕМ ОБ ИЗМЕНЕНИИ НОМЕРА ЗАГРУЖЕННОГО ИССЛЕДОВАНИЯ
     emit loadedResearchNumberChanged(m_loadedResearchNumber);
 
-    addNotification("Лог-файл загружен: " + QString::number(m_logData.size()) + " записей");
+    addNotification("Лог-файл загружен: " + QString::number(m_samples.size()) + " записей");
     emit logLoadedChanged(m_logLoaded);
     emit logModeChanged(m_logMode);
     emit logControlsEnabledChanged(logControlsEnabled());
@@ -687,12 +856,34 @@ void TiltController::loadLogFile(const QString &filePath)
 
 void TiltController::seekLog(int time)
 {
-    if (!m_logLoaded || m_logData.isEmpty()) return;
+    if (!m_logLoaded || m_samples.isEmpty()) return;
+
+    // ОПТИМИЗАЦИЯ: запросы объединяются - пока перемотка ждёт своего кадра,
+    // новые позиции только заменяют запрошенную
+    m_pendingSeekTime = qBound(0, time, m_totalTime);
+    if (m_seekTimer.isActive()) {
+        return;
+    }
+
+    const qint64 sinceLastSeek = m_seekClock.isValid() ? m_seekClock.elapsed() : SeekIntervalMs;
+    m_seekTimer.start(static_cast<int>(qMax<qint64>(0, SeekIntervalMs - sinceLastSeek)));
+}
+
+void TiltController::applyPendingSeek()
+{
+    m_seekTimer.stop();
+    if (m_pendingSeekTime < 0 || !m_logLoaded || m_samples.isEmpty()) {
+        m_pendingSeekTime = -1;
+        return;
+    }
+
+    m_seekClock.restart();
 
     // Устанавливаем позицию ВО ВРЕМЕНИ ЛОГ-ФАЙЛА
-    m_currentTime = qBound(0, time, m_totalTime);
+    m_currentTime = m_pendingSeekTime;
+    m_pendingSeekTime = -1;
 
-    // Сбрасываем синхронизацию времени
+    // Сбрасываем синхронизацию времени (воспроизведение продолжится с новой позиции)
     m_playbackTimeInitialized = false;
 
     // СБРАСЫВАЕМ ИСТОРИЮ ДЛЯ ПЕРЕСЧЕТА СКОРОСТЕЙ
@@ -703,38 +894,95 @@ void TiltController::seekLog(int time)
     // ОБНОВЛЯЕМ ПОЗИЦИЮ ГРАФИКА
     m_graphDisplayTime = m_currentTime + 30000;
 
-    // Находим соответствующий индекс
-    for (int i = 0; i < m_logData.size(); ++i) {
-        if (m_logData[i].time >= m_currentTime) {
-            m_currentLogIndex = i;
-            const LogEntry &entry = m_logData[i];
+    // Находим соответствующий индекс: курсор ищет от текущей записи, соседняя позиция
+    // находится за несколько шагов, дальняя - двоичным поиском
+    m_logCursor.seek(m_currentTime);
+    const LogDataEntry entry = m_samples.at(m_logCursor.index());
 
-            // ОБНОВЛЯЕМ МОДЕЛЬ С НОВЫМИ СКОРОСТЯМИ
-            updateAngularSpeeds();
+    // ОБНОВЛЯЕМ МОДЕЛЬ С НОВЫМИ СКОРОСТЯМИ
+    updateAngularSpeeds();
 
-            // ОБНОВЛЯЕМ СВОЙСТВА ГОЛОВОКРУЖЕНИЯ ДЛЯ 3D ВИДА
-            if (m_patientDizziness != entry.dizziness) {
-                m_patientDizziness = entry.dizziness;
-                emit patientDizzinessChanged(m_patientDizziness);
-            }
+    // ОБНОВЛЯЕМ СВОЙСТВА ГОЛОВОКРУЖЕНИЯ ДЛЯ 3D ВИДА
+    if (m_patientDizziness != entry.dizziness) {
+        m_patientDizziness = entry.dizziness;
+        emit patientDizzinessChanged(m_patientDizziness);
+    }
 
-            if (m_doctorDizziness != entry.doctorDizziness) {
-                m_doctorDizziness = entry.doctorDizziness;
-                emit doctorDizzinessChanged(m_doctorDizziness);
-            }
-            break;
-        }
+    if (m_doctorDizziness != entry.doctorDizziness) {
+        m_doctorDizziness = entry.doctorDizziness;
+        emit doctorDizzinessChanged(m_doctorDizziness);
     }
 
     // ОБНОВЛЯЕМ ГРАФИКИ НЕМЕДЛЕННО
-    updateGraphDataFromBuffer();
+    updateGraphDataFromBuffer(true);
 
     // ВАЖНО: ОБНОВЛЯЕМ ВРЕМЯ ДАЖЕ ПРИ ПАУЗЕ
     emit currentTimeChanged(m_currentTime);
+}
+
+void TiltController::stepLog(int frames)
+{
+    if (!m_logLoaded || m_samples.isEmpty()) return;
+
+    applyPendingSeek();
 
-    // Если воспроизведение активно, продолжаем с новой позиции
     if (m_logPlaying) {
-        m_playbackTimeInitialized = false; // Переинициализируем синхронизацию
+        m_logPlaying = false;
+        m_logTimer.stop();
+        emit logPlayingChanged(m_logPlaying);
+    }
+
+    m_logCursor.step(frames);
+    m_playbackTimeInitialized = false;
+
+    showLogSample(true);
+    updateGraphDataFromBuffer();
+}
+
+void TiltController::setPlaybackRate(double rate)
+{
+    rate = qBound(0.1, rate, 32.0);
+    if (qFuzzyCompare(m_playbackRate, rate)) {
+        return;
+    }
+
+    m_playbackRate = rate;
+    // Отсчёт начинается заново от текущей позиции, иначе при смене скорости она скачет
+    m_playbackTimeInitialized = false;
+    emit playbackRateChanged(m_playbackRate);
+}
+
+void TiltController::setPlaybackReverse(bool reverse)
+{
+    if (m_playbackReverse == reverse) {
+        return;
+    }
+
+    m_playbackReverse = reverse;
+    m_playbackTimeInitialized = false;
+    emit playbackReverseChanged(m_playbackReverse);
+}
+
+void TiltController::setOrientationInterpolation(bool enabled)
+{
+    if (m_orientationInterpolation != enabled) {
+        m_orientationInterpolation = enabled;
+        emit orientationInterpolationChanged(m_orientationInterpolation);
+    }
+}
+
+void TiltController::setLiveLatencyBudget(int milliseconds)
+{
+    milliseconds = qBound(0, milliseconds, 150);
+
+    if (m_liveLatencyBudget != milliseconds) {
+        m_liveLatencyBudget = milliseconds;
+        emit liveLatencyBudgetChanged(m_liveLatencyBudget);
+
+        // Без задержки модель снова показывает последний принятый кадр
+        if (m_liveLatencyBudget == 0) {
+            m_liveOrientation.clear();
+        }
     }
 }
 
@@ -742,11 +990,13 @@ void TiltController::stopLog()
 {
     m_logPlaying = false;
     m_logTimer.stop();
+    m_seekTimer.stop();
+    m_pendingSeekTime = -1;
     m_playbackTimeInitialized = false;
 
     // Сбрасываем позицию воспроизведения на начало
     m_currentTime = 0;
-    m_currentLogIndex = 0;
+    m_logCursor.setIndex(0);
 
     // СБРАСЫВАЕМ ИСТОРИЮ ДЛЯ ПЕРЕСЧЕТА СКОРОСТЕЙ
     m_pitchHistory.clear();
@@ -780,6 +1030,32 @@ void TiltController::stopLog()
     addNotification("Воспроизведение лога остановлено и сброшено в начало");
 }
 
+void TiltController::writeResearchTrailer()
+{
+    if (!m_researchRecorder.isOpen()) return;
+
+    refreshIngestStats();
+    const IngestStats stats = sessionIngestStats() - m_researchStatsStart;
+
+    // Строки начинаются с '#', поэтому при загрузке файла пропускаются
+    QTextStream &out = m_researchRecorder.comments();
+    out << "##########\n";
+    out << "# Статистика приёма\n";
+    out << "# Принято байт: " << stats.bytesReceived << "\n";
+    out << "# Разобрано кадров: " << stats.framesParsed << "\n";
+    out << "# Отброшено кадров: " << stats.framesRejected()
+        << " (CRC: " << stats.rejectedPackets
+        << ", строки: " << stats.rejectedLines
+        << ", NaN: " << stats.invalidValues
+        << ", очередь: " << stats.queueOverflow
+        << ", опоздавшие: " << stats.lateFrames
+        << ", повторы: " << stats.duplicateFrames << ")\n";
+    out << "# Потеряно пакетов: " << (m_lostPackets - m_researchLostPacketsStart) << "\n";
+    out << "# Отброшено байт при переполнении: " << stats.bytesDiscarded << "\n";
+    out << "# Максимальная очередь, кадров: " << m_maxIngestBacklog << "\n";
+    out << "##########\n";
+}
+
 void TiltController::startResearchRecording(const QString &researchNumber)
 {
     if (m_recording || !m_connected) {
@@ -807,18 +1083,19 @@ void TiltController::startResearchRecording(const QString &researchNumber)
     }
 
     QString fileName = generateResearchFileName(researchNumber);
-    m_researchFile = new QFile(fileName);
-
-    if (!m_researchFile->open(QIODevice::WriteOnly | QIODevice::Text)) {
+    if (!m_researchRecorder.open(fileName, m_compressedRecording)) {
         addNotification("Ошибка создания файла исследования: " + fileName);
-        delete m_researchFile;
-        m_researchFile = nullptr;
         return;
     }
 
-    m_researchStream = new QTextStream(m_researchFile);
-
     writeResearchHeader();
+    m_recordingErrorReported = false;
+
+    // Итоги приёма в конце файла считаются от этой точки
+    refreshIngestStats();
+    m_researchStatsStart = sessionIngestStats();
+    m_researchLostPacketsStart = m_lostPackets;
+    m_maxIngestBacklog = 0;
 
     m_recording = true;
     emit recordingChanged(m_recording);
@@ -832,16 +1109,16 @@ void TiltController::stopResearchRecording()
         return;
     }
 
-    if (m_researchStream) {
-        m_researchStream->flush();
-        delete m_researchStream;
-        m_researchStream = nullptr;
-    }
+    if (m_researchRecorder.isOpen()) {
+        writeResearchTrailer();
+
+        const QString fileName = m_researchRecorder.fileName();
+        if (!m_researchRecorder.close() && !m_recordingErrorReported) {
+            addNotification("Ошибка записи файла исследования: " + m_researchRecorder.errorString());
+        }
 
-    if (m_researchFile) {
-        m_researchFile->close();
-        delete m_researchFile;
-        m_researchFile = nullptr;
+        // Новое исследование сразу попадает в каталог
+        m_researchCatalog.refreshFile(fileName);
     }
 
     m_recording = false;
@@ -907,113 +1184,234 @@ float TiltController::calculateAngularSpeed(QVector<AngleHistory>& history, floa
 
 void TiltController::updateLogPlayback()
 {
-    if (m_currentLogIndex >= m_logData.size()) {
+    if (m_samples.isEmpty()) {
         stopLog();
         return;
     }
 
+    // Перемотка во время воспроизведения - продолжаем с новой позиции
+    if (m_pendingSeekTime >= 0) {
+        applyPendingSeek();
+    }
+
     // Инициализация времени при первом вызове
     if (!m_playbackTimeInitialized) {
-        m_playbackStartRealTime = QDateTime::currentMSecsSinceEpoch();
+        m_playbackStartClock = m_playbackClock.nsecsElapsed();
         m_playbackStartLogTime = m_currentTime;
         m_playbackTimeInitialized = true;
     }
 
-    // Вычисляем, сколько реального времени прошло с начала воспроизведения
-    qint64 currentRealTime = QDateTime::currentMSecsSinceEpoch();
-    qint64 realTimeElapsed = currentRealTime - m_playbackStartRealTime;
-
-    // Целевое время в логе = начальное время + прошедшее реальное время
-    qint64 targetLogTime = m_playbackStartLogTime + realTimeElapsed;
+    // Вычисляем, сколько времени прошло с начала воспроизведения к показу этого кадра
+    const qint64 frameTime = playbackFrameTime();
+    const qint64 currentRealTime = frameTime / 1000000;    // мс, для ограничения частоты обновлений
+    const qint64 realTimeElapsed = frameTime - m_playbackStartClock;
 
-    // Находим индекс, соответствующий целевому времени
-    int targetIndex = m_currentLogIndex;
-    while (targetIndex < m_logData.size() && m_logData[targetIndex].time <= targetLogTime) {
-        targetIndex++;
-    }
+    // Целевое время в логе = начальное время + прошедшее время с учётом скорости
+    // и направления. Считается от точки старта, а не накапливается по кадрам,
+    // поэтому при любой скорости воспроизведение не отстаёт от часов
+    const double logTimeElapsed = realTimeElapsed * m_playbackRate / 1000000.0;
+    const double exactLogTime = m_playbackReverse ? m_playbackStartLogTime - logTimeElapsed
+                                                  : m_playbackStartLogTime + logTimeElapsed;
+    const qint64 targetLogTime = static_cast<qint64>(std::floor(exactLogTime));
 
-    // Если нашли кадры для воспроизведения
-    if (targetIndex > m_currentLogIndex) {
-        // Воспроизводим последний найденный кадр
-        const LogEntry &entry = m_logData[targetIndex - 1];
+    // ОПТИМИЗАЦИЯ: курсор сдвигается от текущей записи (в среднем O(1) за кадр),
+    // промежуточные записи не перебираются - показывается только последняя
+    const int previousIndex = m_logCursor.index();
+    const bool indexChanged = m_logCursor.seek(targetLogTime) != previousIndex;
 
+    // С интерполяцией положение головы меняется на каждом кадре, а не только
+    // при смене записи
+    if (indexChanged || m_orientationInterpolation) {
         // ОБНОВЛЯЕМ УГЛОВЫЕ СКОРОСТИ ТОЛЬКО ЕСЛИ ПРОШЛО ДОСТАТОЧНО ВРЕМЕНИ
         qint64 updateInterval = 1000 / m_angularSpeedDisplayRateLog; // Интервал в миллисекундах
+        const bool updateSpeeds = indexChanged && currentRealTime - m_lastAngularSpeedUpdate >= updateInterval;
 
-        if (currentRealTime - m_lastAngularSpeedUpdate >= updateInterval) {
-            // ВЫЧИСЛЯЕМ УГЛОВЫЕ СКОРОСТИ С НОВОЙ ЛОГИКОЙ
-            float speedPitch = m_logReader.calculateAngularSpeed(entry.time, "pitch", true);
-            float speedRoll = m_logReader.calculateAngularSpeed(entry.time, "roll", true);
-            float speedYaw = m_logReader.calculateAngularSpeed(entry.time, "yaw", true);
-
-            // Обновляем модель с новыми скоростями
-            updateHeadModel(entry.pitch, entry.roll, entry.yaw,
-                            speedPitch, speedRoll, speedYaw,
-                            entry.dizziness || entry.doctorDizziness);
+        showLogSample(updateSpeeds, m_orientationInterpolation ? exactLogTime : -1.0);
 
+        if (updateSpeeds) {
             m_lastAngularSpeedUpdate = currentRealTime;
-        } else {
-            // Обновляем только углы (без пересчета скоростей)
-            updateHeadModel(entry.pitch, entry.roll, entry.yaw,
-                            m_headModel.speedPitch(), m_headModel.speedRoll(), m_headModel.speedYaw(),
-                            entry.dizziness || entry.doctorDizziness);
-        }
-
-        m_currentTime = entry.time;
-        m_currentLogIndex = targetIndex;
-
-        // ОБНОВЛЯЕМ СВОЙСТВА ГОЛОВОКРУЖЕНИЯ ДЛЯ 3D ВИДА
-        if (m_patientDizziness != entry.dizziness) {
-            m_patientDizziness = entry.dizziness;
-            emit patientDizzinessChanged(m_patientDizziness);
         }
-
-        if (m_doctorDizziness != entry.doctorDizziness) {
-            m_doctorDizziness = entry.doctorDizziness;
-            emit doctorDizzinessChanged(m_doctorDizziness);
-        }
-
-        // ОБНОВЛЯЕМ ПОЗИЦИЮ ГРАФИКА для отображения текущего момента
-        m_graphDisplayTime = m_currentTime + 30000;
-
-        emit currentTimeChanged(m_currentTime);
     }
 
     // Обновляем графики с фиксированной частотой
-    static qint64 lastGraphUpdate = 0;
-    if (currentRealTime - lastGraphUpdate >= 33) { // ~30 FPS для графиков
-        updateGraphDataFromBuffer();
-        lastGraphUpdate = currentRealTime;
-    }
+    updateGraphsThrottled(33); // ~30 FPS для графиков
 
-    // Если достигли конца лога, останавливаем воспроизведение
-    if (m_currentLogIndex >= m_logData.size()) {
+    // Конец записи: вперёд - остановка и возврат в начало, назад - пауза на первой записи
+    if (!m_playbackReverse && targetLogTime >= m_samples.lastTime()) {
         stopLog();
+    } else if (m_playbackReverse && targetLogTime <= m_samples.firstTime()) {
+        pauseLog();
     }
 }
 
-void TiltController::updateGraphDataFromBuffer()
+void TiltController::onPlaybackTimer()
 {
-    if (m_logMode) {
-        // РЕЖИМ ЛОГ-ФАЙЛА: используем отдельную логику
-        updateGraphDataFromLogFile();
-    } else {
-        // РЕЖИМ COM-ПОРТА: используем восстановленную рабочую логику
-        updateGraphDataFromCOMPort();
+    // Окно на экране - воспроизведение идёт по его кадрам, таймер только заказывает
+    // следующий кадр. Свёрнутое окно кадров не рисует, тогда шаг делает таймер
+    if (m_frameWindow && m_frameWindow->isExposed()) {
+        m_frameWindow->update();
+        return;
     }
-
-    // Всегда эмитируем сигнал после обновления данных
-    emit graphDataChanged();
+    updateLogPlayback();
 }
 
-void TiltController::updateGraphDataFromCOMPort()
+void TiltController::setFrameSource(QQuickWindow *window)
 {
-    if (m_dataBuffer.isEmpty()) {
-        return;
+    if (m_frameWindow) {
+        disconnect(m_frameWindow, nullptr, this, nullptr);
     }
 
-    const qint64 DISPLAY_DURATION_MS = m_graphDuration * 1000;
-    QVariantList newPitchData, newRollData, newYawData, newDizzinessPatientData, newDizzinessDoctorData;
+    m_frameWindow = window;
+    if (!window) {
+        return;
+    }
+
+    // afterAnimating приходит в GUI-потоке перед синхронизацией сцены каждого кадра:
+    // положение, выставленное здесь, попадает именно в этот кадр
+    connect(window, &QQuickWindow::afterAnimating, this, [this]() {
+        if (!m_logPlaying) {
+            updateLiveOrientation();
+            return;
+        }
+
+        m_frameTick = true;
+        updateLogPlayback();
+        m_frameTick = false;
+
+        // Следующий кадр нужен, даже если запись не сменилась (медленное воспроизведение)
+        if (m_logPlaying && m_frameWindow) {
+            m_frameWindow->update();
+        }
+    });
+}
+
+double TiltController::sessionTimeNow() const
+{
+    return (m_playbackClock.nsecsElapsed() - m_sessionClockOrigin) / 1000000.0;
+}
+
+QVector3D TiltController::liveAngles(const DataFrame &newest) const
+{
+    const QVector3D raw(newest.pitch, newest.yaw, newest.roll);
+    if (m_liveLatencyBudget <= 0 || m_liveOrientation.isEmpty()) {
+        return raw;
+    }
+    return m_liveOrientation.anglesAt(sessionTimeNow() - m_liveLatencyBudget);
+}
+
+void TiltController::updateLiveOrientation()
+{
+    if (m_liveLatencyBudget <= 0 || m_logMode || !m_connected || m_liveOrientation.isEmpty()) {
+        return;
+    }
+
+    // Модель отстаёт от последнего кадра на бюджет задержки; пока она его не догнала,
+    // каждый кадр окна показывает новое промежуточное положение
+    const double presentationTime = sessionTimeNow() - m_liveLatencyBudget;
+    const QVector3D angles = m_liveOrientation.anglesAt(presentationTime);
+    m_headModel.setRotation(angles.x(), angles.z(), angles.y());
+
+    if (presentationTime < m_liveOrientation.lastTime() && m_frameWindow) {
+        m_frameWindow->update();
+    }
+}
+
+qint64 TiltController::playbackFrameTime() const
+{
+    const qint64 now = m_playbackClock.nsecsElapsed();
+    if (!m_frameTick || !m_frameWindow) {
+        return now;
+    }
+
+    // Кадры окна идут с частотой экрана. Время кадра берётся по сетке обновлений экрана
+    // от начала воспроизведения, а не по моменту, когда GUI-поток дошёл до кадра:
+    // каждый кадр сдвигает запись ровно на интервал кадра, без биений с частотой записей.
+    // Кадр, подготовленный сейчас, появится на экране со следующим обновлением
+    const qreal refreshRate = m_frameWindow->screen() ? m_frameWindow->screen()->refreshRate() : 60.0;
+    const qint64 frameInterval = static_cast<qint64>(1e9 / qMax<qreal>(refreshRate, 1.0));
+    const qint64 frames = (now - m_playbackStartClock + frameInterval / 2) / frameInterval;
+    return m_playbackStartClock + (frames + 1) * frameInterval;
+}
+
+void TiltController::showLogSample(bool updateSpeeds, double logTime)
+{
+    const int index = m_logCursor.index();
+    const LogDataEntry entry = m_samples.at(index);
+
+    // Положение между этой и следующей записью на момент показа кадра
+    QVector3D angles(entry.pitch, entry.yaw, entry.roll);
+    if (logTime >= 0.0 && index + 1 < m_samples.size()) {
+        const qint64 nextTime = m_samples.time(index + 1);
+        if (nextTime > entry.time) {
+            const QVector3D next(m_samples.angle(SampleStore::Pitch, index + 1),
+                                 m_samples.angle(SampleStore::Yaw, index + 1),
+                                 m_samples.angle(SampleStore::Roll, index + 1));
+            const float fraction = static_cast<float>((logTime - entry.time) / double(nextTime - entry.time));
+            angles = OrientationInterpolator::interpolate(angles, next, fraction);
+        }
+    }
+
+    if (updateSpeeds) {
+        // ОПТИМИЗАЦИЯ: скорости посчитаны заранее для всей записи (AngularSpeedChannels)
+        float speedPitch = m_logReader.angularSpeedAtIndex(index, SampleStore::Pitch);
+        float speedRoll = m_logReader.angularSpeedAtIndex(index, SampleStore::Roll);
+        float speedYaw = m_logReader.angularSpeedAtIndex(index, SampleStore::Yaw);
+
+        // Обновляем модель с новыми скоростями
+        updateHeadModel(angles.x(), angles.z(), angles.y(),
+                        speedPitch, speedRoll, speedYaw,
+                        entry.dizziness || entry.doctorDizziness);
+    } else {
+        // Обновляем только углы (без пересчета скоростей)
+        updateHeadModel(angles.x(), angles.z(), angles.y(),
+                        m_headModel.speedPitch(), m_headModel.speedRoll(), m_headModel.speedYaw(),
+                        entry.dizziness || entry.doctorDizziness);
+    }
+
+    // ОБНОВЛЯЕМ СВОЙСТВА ГОЛОВОКРУЖЕНИЯ ДЛЯ 3D ВИДА
+    if (m_patientDizziness != entry.dizziness) {
+        m_patientDizziness = entry.dizziness;
+        emit patientDizzinessChanged(m_patientDizziness);
+    }
+
+    if (m_doctorDizziness != entry.doctorDizziness) {
+        m_doctorDizziness = entry.doctorDizziness;
+        emit doctorDizzinessChanged(m_doctorDizziness);
+    }
+
+    // ОБНОВЛЯЕМ ПОЗИЦИЮ ГРАФИКА для отображения текущего момента
+    m_graphDisplayTime = entry.time + 30000;
+
+    // С интерполяцией запись показывается несколько кадров подряд - время
+    // сообщается только при смене записи
+    if (m_currentTime != entry.time) {
+        m_currentTime = entry.time;
+        emit currentTimeChanged(m_currentTime);
+    }
+}
+
+void TiltController::updateGraphDataFromBuffer(bool seeking)
+{
+    if (m_logMode) {
+        // РЕЖИМ ЛОГ-ФАЙЛА: используем отдельную логику
+        updateGraphDataFromLogFile(seeking);
+    } else {
+        // РЕЖИМ COM-ПОРТА: используем восстановленную рабочую логику
+        updateGraphDataFromCOMPort();
+    }
+
+    // Всегда эмитируем сигнал после обновления данных
+    emit graphDataChanged();
+}
+
+void TiltController::updateGraphDataFromCOMPort()
+{
+    if (m_dataBuffer.isEmpty()) {
+        return;
+    }
+
+    const qint64 DISPLAY_DURATION_MS = m_graphDuration * 1000;
+    QVariantList newPitchData, newRollData, newYawData, newDizzinessPatientData, newDizzinessDoctorData;
 
     qint64 currentAbsoluteTime = QDateTime::currentMSecsSinceEpoch();
     qint64 displayStartTime = currentAbsoluteTime - DISPLAY_DURATION_MS;
@@ -1133,9 +1531,10 @@ void TiltController::updateGraphDataFromCOMPort()
     }
 }
 
-void TiltController::updateGraphDataFromLogFile()
+void TiltController::updateGraphDataFromLogFile(bool seeking)
 {
-    if (!m_logLoaded || m_logData.isEmpty()) {
+    // Во время загрузки графики строятся по уже разобранному началу файла
+    if ((!m_logLoaded && !m_loading) || m_samples.isEmpty()) {
         return;
     }
 
@@ -1145,17 +1544,39 @@ void TiltController::updateGraphDataFromLogFile()
 
     // Всегда используем m_graphDisplayTime для определения позиции графика
     qint64 displayEndTime = m_graphDisplayTime;
+
+    // ОПТИМИЗАЦИЯ: окно перемотки, уже построенное для этой позиции, берётся из кэша.
+    // Правый край округляется вниз до шага прореживания (для 30 с - 150 мс): соседние
+    // позиции ползунка дают одно и то же окно. Пока файл загружается, записи меняются,
+    // и окна не кэшируются
+    const bool cacheable = seeking && m_logLoaded && !m_loading;
+    if (cacheable) {
+        const qint64 windowStep = qMax<qint64>(1, DISPLAY_DURATION_MS / (GraphTargetPoints - 1));
+        displayEndTime -= displayEndTime % windowStep;
+    }
     qint64 displayStartTime = displayEndTime - DISPLAY_DURATION_MS;
 
+    const QPair<qint64, int> windowKey(displayEndTime, m_graphDuration);
+    if (cacheable) {
+        if (const GraphWindow *window = m_graphWindowCache.object(windowKey)) {
+            m_pitchGraphData = window->pitch;
+            m_rollGraphData = window->roll;
+            m_yawGraphData = window->yaw;
+            m_dizzinessPatientData = window->patientDizziness;
+            m_dizzinessDoctorData = window->doctorDizziness;
+            return;
+        }
+    }
+
     // Находим диапазон данных для отображения (в оригинальном времени файла)
     int startIndex = findLogIndexByTime(qMax(0LL, displayStartTime - TIME_OFFSET));
     int endIndex = findLogIndexByTime(displayEndTime - TIME_OFFSET);
 
     if (startIndex == -1) startIndex = 0;
-    if (endIndex == -1) endIndex = m_logData.size() - 1;
+    if (endIndex == -1) endIndex = m_samples.size() - 1;
 
     startIndex = qMax(0, startIndex);
-    endIndex = qMin(m_logData.size() - 1, endIndex);
+    endIndex = qMin(m_samples.size() - 1, endIndex);
 
     // СОБИРАЕМ ДАННЫЕ С РАВНОМЕРНЫМ ПРОРЕЖИВАНИЕМ ПО ВРЕМЕНИ
     QVector<DataFrame> displayData;
@@ -1166,7 +1587,7 @@ void TiltController::updateGraphDataFromLogFile()
         if (totalPoints <= 250) {
             // Если точек мало, берем все
             for (int i = startIndex; i <= endIndex; i++) {
-                const LogEntry &entry = m_logData[i];
+                const LogDataEntry entry = m_samples.at(i);
                 DataFrame frame;
                 frame.timestamp = entry.time + TIME_OFFSET;
                 frame.pitch = entry.pitch;
@@ -1178,16 +1599,16 @@ void TiltController::updateGraphDataFromLogFile()
             }
         } else {
             // Равномерное прореживание по времени
-            qint64 startTime = m_logData[startIndex].time + TIME_OFFSET;
-            qint64 endTime = m_logData[endIndex].time + TIME_OFFSET;
+            qint64 startTime = m_samples.time(startIndex) + TIME_OFFSET;
+            qint64 endTime = m_samples.time(endIndex) + TIME_OFFSET;
             qint64 timeRange = endTime - startTime;
 
             // Целевое количество точек после прореживания
-            const int targetPointCount = 200;
+            const int targetPointCount = GraphTargetPoints;
             qint64 timeStep = timeRange / (targetPointCount - 1);
 
             // Добавляем первую точку
-            const LogEntry &firstEntry = m_logData[startIndex];
+            const LogDataEntry firstEntry = m_samples.at(startIndex);
             DataFrame firstFrame;
             firstFrame.timestamp = firstEntry.time + TIME_OFFSET;
             firstFrame.pitch = firstEntry.pitch;
@@ -1197,31 +1618,30 @@ void TiltController::updateGraphDataFromLogFile()
             firstFrame.doctorDizziness = firstEntry.doctorDizziness;
             displayData.append(firstFrame);
 
-            // Для каждого целевого времени находим ближайшую точку
+            // Для каждого целевого времени находим ближайшую точку.
+            // ОПТИМИЗАЦИЯ: целевые времена возрастают, поэтому поиск продолжается
+            // с предыдущей найденной точки - один проход по окну вместо прохода
+            // от его начала для каждой из 200 точек
+            int scanIndex = startIndex;
             for (int i = 1; i < targetPointCount - 1; i++) {
                 qint64 targetTime = startTime + i * timeStep;
 
-                // Ищем ближайшую точку к целевому времени
-                int bestIndex = startIndex;
-                qint64 minTimeDiff = std::abs((m_logData[startIndex].time + TIME_OFFSET) - targetTime);
-
-                for (int j = startIndex + 1; j <= endIndex; j++) {
-                    qint64 currentTime = m_logData[j].time + TIME_OFFSET;
-                    qint64 timeDiff = std::abs(currentTime - targetTime);
-
-                    if (timeDiff < minTimeDiff) {
-                        minTimeDiff = timeDiff;
-                        bestIndex = j;
-                    }
+                // Последняя точка не позже целевого времени и следующая за ней
+                while (scanIndex < endIndex && m_samples.time(scanIndex + 1) + TIME_OFFSET <= targetTime) {
+                    scanIndex++;
+                }
 
-                    // Если начали удаляться от целевого времени, выходим
-                    if (currentTime > targetTime + timeStep / 2) {
-                        break;
+                int bestIndex = scanIndex;
+                if (scanIndex < endIndex) {
+                    const qint64 before = targetTime - (m_samples.time(scanIndex) + TIME_OFFSET);
+                    const qint64 after = (m_samples.time(scanIndex + 1) + TIME_OFFSET) - targetTime;
+                    if (after < before) {
+                        bestIndex = scanIndex + 1;
                     }
                 }
 
                 // Добавляем точку, если она отличается от предыдущей
-                const LogEntry &entry = m_logData[bestIndex];
+                const LogDataEntry entry = m_samples.at(bestIndex);
                 DataFrame frame;
                 frame.timestamp = entry.time + TIME_OFFSET;
                 frame.pitch = entry.pitch;
@@ -1237,7 +1657,7 @@ void TiltController::updateGraphDataFromLogFile()
             }
 
             // Добавляем последнюю точку
-            const LogEntry &lastEntry = m_logData[endIndex];
+            const LogDataEntry lastEntry = m_samples.at(endIndex);
             DataFrame lastFrame;
             lastFrame.timestamp = lastEntry.time + TIME_OFFSET;
             lastFrame.pitch = lastEntry.pitch;
@@ -1288,19 +1708,21 @@ void TiltController::updateGraphDataFromLogFile()
         qint64 doctorStartTime = 0;
 
         // Используем все данные из диапазона для точного определения интервалов
+        // Доступ по индексу: колонки могут подкачиваться страницами (PagedLogFile)
         for (int i = startIndex; i <= endIndex; i++) {
-            const LogEntry &entry = m_logData[i];
+            const bool patientDizziness = m_samples.patientDizziness(i);
+            const bool doctorDizziness = m_samples.doctorDizziness(i);
 
             // Рассчитываем время относительно начала отображаемого окна
-            qint64 frameTime = entry.time + TIME_OFFSET;
+            qint64 frameTime = m_samples.time(i) + TIME_OFFSET;
             qint64 relativeTime = frameTime - displayStartTime;
             relativeTime = qBound(0LL, relativeTime, DISPLAY_DURATION_MS);
 
             // Обработка головокружения пациента
-            if (entry.dizziness && !inPatientDizziness) {
+            if (patientDizziness && !inPatientDizziness) {
                 inPatientDizziness = true;
                 patientStartTime = relativeTime;
-            } else if (!entry.dizziness && inPatientDizziness) {
+            } else if (!patientDizziness && inPatientDizziness) {
                 inPatientDizziness = false;
                 qint64 patientEndTime = relativeTime;
 
@@ -1314,10 +1736,10 @@ void TiltController::updateGraphDataFromLogFile()
             }
 
             // Обработка головокружения врача
-            if (entry.doctorDizziness && !inDoctorDizziness) {
+            if (doctorDizziness && !inDoctorDizziness) {
                 inDoctorDizziness = true;
                 doctorStartTime = relativeTime;
-            } else if (!entry.doctorDizziness && inDoctorDizziness) {
+            } else if (!doctorDizziness && inDoctorDizziness) {
                 inDoctorDizziness = false;
                 qint64 doctorEndTime = relativeTime;
 
@@ -1353,141 +1775,24 @@ void TiltController::updateGraphDataFromLogFile()
     m_yawGraphData = newYawData;
     m_dizzinessPatientData = newDizzinessPatientData;
     m_dizzinessDoctorData = newDizzinessDoctorData;
-}
-
-// Вспомогательная функция для бинарного поиска индекса по времени
-int TiltController::findLogIndexByTime(qint64 targetTime)
-{
-    if (m_logData.isEmpty()) return -1;
-
-    // Используем бинарный поиск для эффективности
-    int left = 0;
-    int right = m_logData.size() - 1;
-    int result = -1;
 
-    while (left <= right) {
-        int mid = left + (right - left) / 2;
-        qint64 midTime = m_logData[mid].time;
-
-        if (midTime == targetTime) {
-            return mid;
-        } else if (midTime < targetTime) {
-            result = mid; // Запоминаем последний подходящий индекс
-            left = mid + 1;
-        } else {
-            right = mid - 1;
-        }
+    if (cacheable) {
+        m_graphWindowCache.insert(windowKey, new GraphWindow{newPitchData, newRollData, newYawData,
+                                                             newDizzinessPatientData, newDizzinessDoctorData});
     }
-
-    // Возвращаем ближайший индекс, не превышающий targetTime
-    return result;
 }
 
-void TiltController::updateCOMAngularSpeeds()
-{
-    if (!m_connected || m_logMode) return;
-
-    // Проверяем, что у нас достаточно данных для расчета
-    // Теперь достаточно хотя бы 2 точек в каждом буфере
-    bool hasEnoughData = (m_comPitchBuffer.size() >= 2) &&
-                         (m_comRollBuffer.size() >= 2) &&
-                         (m_comYawBuffer.size() >= 2);  // ИСПРАВЛЕНО: было m_yawBuffer
-
-    if (!hasEnoughData) {
-        // Если данных недостаточно, используем простой расчет по последним 2 точкам
-        // или устанавливаем нулевые скорости
-        if (m_dataBuffer.size() >= 2) {
-            // Берем последние 2 кадра из основного буфера
-            DataFrame currentFrame = m_dataBuffer.last();
-            DataFrame prevFrame = m_dataBuffer.at(m_dataBuffer.size() - 2);
-
-            qint64 timeDiff = currentFrame.timestamp - prevFrame.timestamp;
-
-            if (timeDiff > 0) {
-                m_currentComSpeedPitch = (currentFrame.pitch - prevFrame.pitch) * 1000.0f / timeDiff;
-                m_currentComSpeedRoll = (currentFrame.roll - prevFrame.roll) * 1000.0f / timeDiff;
-                m_currentComSpeedYaw = (currentFrame.yaw - prevFrame.yaw) * 1000.0f / timeDiff;
-
-                // Ограничиваем скорости
-                const float maxSpeed = 360.0f;
-                m_currentComSpeedPitch = qBound(-maxSpeed, m_currentComSpeedPitch, maxSpeed);
-                m_currentComSpeedRoll = qBound(-maxSpeed, m_currentComSpeedRoll, maxSpeed);
-                m_currentComSpeedYaw = qBound(-maxSpeed, m_currentComSpeedYaw, maxSpeed);
-            }
-        } else {
-            // Если вообще нет данных, устанавливаем нули
-            m_currentComSpeedPitch = 0.0f;
-            m_currentComSpeedRoll = 0.0f;
-            m_currentComSpeedYaw = 0.0f;
-        }
-    } else {
-        // Нормальный расчет с использованием буферов
-        m_currentComSpeedPitch = calculateCOMAngularSpeed(m_comPitchBuffer);
-        m_currentComSpeedRoll = calculateCOMAngularSpeed(m_comRollBuffer);
-        m_currentComSpeedYaw = calculateCOMAngularSpeed(m_comYawBuffer);
-    }
-
-    // Обновляем модель с вычисленными скоростями
-    if (m_dataBuffer.size() > 0) {
-        const DataFrame& lastFrame = m_dataBuffer.last();
-        updateHeadModel(lastFrame.pitch, lastFrame.roll, lastFrame.yaw,
-                        m_currentComSpeedPitch, m_currentComSpeedRoll, m_currentComSpeedYaw,
-                        lastFrame.patientDizziness || lastFrame.doctorDizziness);
-    }
-
-    // Очищаем буферы только если они стали слишком большими
-    const int maxBufferSize = 100;
-    if (m_comPitchBuffer.size() > maxBufferSize) {
-        m_comPitchBuffer.remove(0, m_comPitchBuffer.size() - maxBufferSize / 2);
-    }
-    if (m_comRollBuffer.size() > maxBufferSize) {
-        m_comRollBuffer.remove(0, m_comRollBuffer.size() - maxBufferSize / 2);
-    }
-    if (m_comYawBuffer.size() > maxBufferSize) {
-        m_comYawBuffer.remove(0, m_comYawBuffer.size() - maxBufferSize / 2);
-    }
-}
-
-float TiltController::calculateCOMAngularSpeed(QVector<AngleDataPoint>& dataBuffer)
+// Вспомогательная функция для бинарного поиска индекса по времени
+int TiltController::findLogIndexByTime(qint64 targetTime)
 {
-    if (dataBuffer.size() < 2) {
-        return 0.0f;
-    }
-
-    // Берем первое и последнее значение в буфере
-    const AngleDataPoint& firstPoint = dataBuffer.first();
-    const AngleDataPoint& lastPoint = dataBuffer.last();
-
-    // Вычисляем изменение угла
-    float angleChange = lastPoint.angle - firstPoint.angle;
-
-    // Корректируем переход через ±180 градусов
-    if (angleChange > 180.0f) {
-        angleChange -= 360.0f;
-    } else if (angleChange < -180.0f) {
-        angleChange += 360.0f;
-    }
-
-    // Вычисляем временной интервал в секундах
-    float timeDiff = (lastPoint.timestamp - firstPoint.timestamp) / 1000.0f;
-
-    if (timeDiff <= 0) {
-        return 0.0f;
-    }
-
-    // Вычисляем угловую скорость (градусы/секунду)
-    float angularSpeed = angleChange / timeDiff;
-
-    // Ограничиваем разумными пределами
-    const float maxSpeed = 360.0f;
-    return qBound(-maxSpeed, angularSpeed, maxSpeed);
+    // Ближайший индекс, не превышающий targetTime
+    return m_samples.findIndexByTime(targetTime);
 }
 
 void TiltController::clearCOMBuffers()
 {
-    m_comPitchBuffer.clear();
-    m_comRollBuffer.clear();
-    m_comYawBuffer.clear();
+    m_comSpeedEstimator.clear();
+    m_lastComSpeedDisplay = -1;
 }
 
 void TiltController::setAngularSpeedUpdateFrequency(float frequency)
@@ -1499,217 +1804,187 @@ void TiltController::setAngularSpeedUpdateFrequency(float frequency)
         m_angularSpeedUpdateFrequency = frequency;
         m_logReader.setUpdateFrequency(frequency);
 
-        // Обновляем интервал таймера для COM-порта
-        m_comSpeedUpdateTimer.setInterval(1000 / frequency);
-
-        // Пересчитываем скорости в зависимости от режима
+        // Пересчитываем скорости в режиме лог-файла (в реальном времени они
+        // обновляются с каждым кадром)
         if (m_logMode && m_logLoaded) {
             updateAngularSpeeds();
-        } else if (m_connected) {
-            if (m_comSpeedUpdateTimer.isActive()) {
-                m_comSpeedUpdateTimer.stop();
-            }
-            m_comSpeedUpdateTimer.start();
-            clearCOMBuffers();
         }
 
         emit angularSpeedUpdateFrequencyChanged(frequency);
     }
 }
 
-void TiltController::processDataFrame(const DataFrame& frame)
+bool TiltController::processDataFrame(const DataFrame& frame)
 {
-    // Добавляем данные в буферы для расчета скоростей COM-порта
-    if (m_connected && !m_logMode) {
-        m_comPitchBuffer.append(AngleDataPoint(frame.timestamp, frame.pitch));
-        m_comRollBuffer.append(AngleDataPoint(frame.timestamp, frame.roll));
-        m_comYawBuffer.append(AngleDataPoint(frame.timestamp, frame.yaw));
+    const bool firstFrame = m_prevFrame.timestamp <= 0;
 
-        // Запускаем таймер, если он еще не запущен (дополнительная защита)
-        if (!m_comSpeedUpdateTimer.isActive()) {
-            m_comSpeedUpdateTimer.start();
-        }
+    // Кадр с тем же или более ранним временем не показываем, не записываем
+    // и не учитываем в скорости
+    if (!firstFrame && frame.timestamp - m_prevFrame.timestamp <= 0) {
+        return false;
+    }
 
-        // Если буферы пусты, инициируем немедленный расчет скоростей
-        if (m_comPitchBuffer.size() == 1 && m_comRollBuffer.size() == 1 && m_comYawBuffer.size() == 1) {
-            // Запускаем однократное обновление через короткий интервал
-            QTimer::singleShot(100, this, &TiltController::updateCOMAngularSpeeds);
-        }
+    // ОПТИМИЗАЦИЯ: скорость COM-порта обновляется с каждым кадром за O(1)
+    // (наклон МНК по кадрам последних LiveSpeedWindowMs, см. angular_speed_estimator.h)
+    if (m_connected && !m_logMode && m_comSpeedEstimator.append(frame.timestamp, frame.pitch, frame.roll, frame.yaw)) {
+        const float maxSpeed = 360.0f;
+        m_currentComSpeedPitch = qBound(-maxSpeed, m_comSpeedEstimator.speed(SampleStore::Pitch), maxSpeed);
+        m_currentComSpeedRoll = qBound(-maxSpeed, m_comSpeedEstimator.speed(SampleStore::Roll), maxSpeed);
+        m_currentComSpeedYaw = qBound(-maxSpeed, m_comSpeedEstimator.speed(SampleStore::Yaw), maxSpeed);
     }
 
-    if (m_prevFrame.timestamp > 0) {
-        qint64 timeDiff = frame.timestamp - m_prevFrame.timestamp;
-        if (timeDiff > 0) {
-            // Старый расчет скоростей (оставляем для обратной совместимости)
-            float speedPitch = (frame.pitch - m_prevFrame.pitch) * 1000.0f / timeDiff;
-            float speedRoll = (frame.roll - m_prevFrame.roll) * 1000.0f / timeDiff;
-            float speedYaw = (frame.yaw - m_prevFrame.yaw) * 1000.0f / timeDiff;
-
-            // Ограничиваем максимальную скорость
-            const float maxSpeed = 180.0f;
-            speedPitch = qBound(-maxSpeed, speedPitch, maxSpeed);
-            speedRoll = qBound(-maxSpeed, speedRoll, maxSpeed);
-            speedYaw = qBound(-maxSpeed, speedYaw, maxSpeed);
-
-            // В режиме COM-порта используем усредненные скорости
-            if (m_connected && !m_logMode) {
-                speedPitch = m_currentComSpeedPitch;
-                speedRoll = m_currentComSpeedRoll;
-                speedYaw = m_currentComSpeedYaw;
-            }
+    m_prevFrame = frame;
+    if (firstFrame) {
+        return false;
+    }
 
-            m_prevFrame = frame;
+    // Запись в файл исследования (сброс на диск - один раз на пачку, в drainIngestQueue)
+    if (m_recording && m_researchRecorder.isOpen()) {
+        qint64 researchTime = frame.timestamp - m_researchRecordingStartTime;
+        if (researchTime < 0) {
+            researchTime = 0;
+        }
 
-            // Обновляем свойства головокружения
-            if (m_patientDizziness != frame.patientDizziness) {
-                m_patientDizziness = frame.patientDizziness;
-                emit patientDizzinessChanged(m_patientDizziness);
-            }
+        m_researchRecorder.writeSample(researchTime, frame.pitch, frame.roll, frame.yaw,
+                                       frame.patientDizziness, frame.doctorDizziness);
+        m_researchFrameCounter++;
+    }
 
-            if (m_doctorDizziness != frame.doctorDizziness) {
-                m_doctorDizziness = frame.doctorDizziness;
-                emit doctorDizzinessChanged(m_doctorDizziness);
-            }
+    return true;
+}
 
-            // Обновляем модель
-            bool combinedDizziness = frame.patientDizziness || frame.doctorDizziness;
-            updateHeadModel(frame.pitch, frame.roll, frame.yaw, speedPitch, speedRoll, speedYaw, combinedDizziness);
+void TiltController::publishDataFrame(const DataFrame& frame)
+{
+    // В режиме реального времени показываем сглаженные скорости COM-порта.
+    // Оценка обновляется с каждым кадром, цифры на экране - с выбранной частотой,
+    // чтобы не мелькали
+    float speedPitch = m_headModel.speedPitch();
+    float speedRoll = m_headModel.speedRoll();
+    float speedYaw = m_headModel.speedYaw();
+
+    const qint64 now = m_playbackClock.elapsed();
+    if (m_lastComSpeedDisplay < 0 || now - m_lastComSpeedDisplay >= qint64(1000 / m_angularSpeedUpdateFrequencyCOM)) {
+        speedPitch = m_currentComSpeedPitch;
+        speedRoll = m_currentComSpeedRoll;
+        speedYaw = m_currentComSpeedYaw;
+        m_lastComSpeedDisplay = now;
+    }
+
+    // Обновляем свойства головокружения
+    if (m_patientDizziness != frame.patientDizziness) {
+        m_patientDizziness = frame.patientDizziness;
+        emit patientDizzinessChanged(m_patientDizziness);
+    }
 
-            // Устанавливаем флаг hasData
-            if (!m_headModel.hasData()) {
-                m_headModel.setHasData(true);
-            }
+    if (m_doctorDizziness != frame.doctorDizziness) {
+        m_doctorDizziness = frame.doctorDizziness;
+        emit doctorDizzinessChanged(m_doctorDizziness);
+    }
 
-            // Запись в файл исследования
-            if (m_recording && m_researchStream) {
-                qint64 researchTime = frame.timestamp - m_researchRecordingStartTime;
-                if (researchTime < 0) {
-                    researchTime = 0;
-                }
+    // Обновляем модель; с бюджетом задержки - положением на момент показа (см. updateLiveOrientation)
+    bool combinedDizziness = frame.patientDizziness || frame.doctorDizziness;
+    const QVector3D angles = liveAngles(frame);
+    updateHeadModel(angles.x(), angles.z(), angles.y(), speedPitch, speedRoll, speedYaw, combinedDizziness);
 
-                QString timestamp = QString::number(researchTime).rightJustified(10, '0');
-                QString formattedLine = QString("%1;%2;%3;%4;%5;%6")
-                                            .arg(timestamp)
-                                            .arg(frame.pitch, 0, 'f', 2)
-                                            .arg(frame.roll, 0, 'f', 2)
-                                            .arg(frame.yaw, 0, 'f', 2)
-                                            .arg(frame.patientDizziness ? 1 : 0)
-                                            .arg(frame.doctorDizziness ? 1 : 0);
-
-                *m_researchStream << formattedLine << "\n";
-                m_researchStream->flush();
-                m_researchFrameCounter++;
-            }
-        }
-    } else {
-        m_prevFrame = frame;
+    // Устанавливаем флаг hasData
+    if (!m_headModel.hasData()) {
+        m_headModel.setHasData(true);
     }
 }
 
-bool TiltController::setupCOMPort()
+bool TiltController::setupCOMPort(bool resume)
 {
-    if (m_serialPort) {
-        cleanupCOMPort();
-    }
+    cleanupCOMPort();
 
-    // Очищаем буферы COM-порта
-    clearCOMBuffers();
-    m_currentComSpeedPitch = 0.0f;
-    m_currentComSpeedRoll = 0.0f;
-    m_currentComSpeedYaw = 0.0f;
+    if (!resume) {
+        // Очищаем буферы COM-порта
+        clearCOMBuffers();
+        m_currentComSpeedPitch = 0.0f;
+        m_currentComSpeedRoll = 0.0f;
+        m_currentComSpeedYaw = 0.0f;
 
-    // ОПТИМИЗАЦИЯ: Полная очистка при новом подключении
-    m_dataBuffer.clear();
-    m_prevFrame = DataFrame();
-    m_incompleteData.clear();
+        // ОПТИМИЗАЦИЯ: Полная очистка при новом подключении
+        m_dataBuffer.clear();
+        m_prevFrame = DataFrame();
 
-    // ОПТИМИЗАЦИЯ: Сбрасываем временные метки
-    m_startTime = QDateTime::currentMSecsSinceEpoch();
-    m_lastDataTime = 0;
+        // ОПТИМИЗАЦИЯ: Сбрасываем временные метки
+        m_startTime = QDateTime::currentMSecsSinceEpoch();
+        m_sessionClockOrigin = m_playbackClock.nsecsElapsed();
+        m_liveOrientation.clear();
+        m_lastDataTime = 0;
+
+        // ОПТИМИЗАЦИЯ: Сбрасываем кэши графиков
+        m_lastPitchData.clear();
+        m_lastRollData.clear();
+        m_lastYawData.clear();
+        m_updateCounter = 0;
+        resetStreamInfo();
+    }
+    m_ingestQueue.clear();
+
+    // Порт открывается в потоке приёма; открытие быстрое, поэтому ждём результат.
+    // При продолжении сессии шкала времени m_startTime сохраняется
+    bool opened = false;
+    QString errorString;
+    if (!resume) {
+        m_sessionPort = m_selectedPort;
+    }
+    // Пока порт пропал, список портов может сменить выбранный - переподключаемся к прежнему
+    const QString portName = m_sessionPort;
+    const qint64 sessionStart = m_startTime;
+    QMetaObject::invokeMethod(m_ingestWorker, [&]() {
+        opened = m_ingestWorker->openSerialPort(portName, sessionStart, &errorString);
+    }, Qt::BlockingQueuedConnection);
+
+    if (!opened) {
+        if (!resume) {
+            addNotification("Ошибка подключения к " + m_selectedPort + ": " + errorString);
+        }
+        cleanupCOMPort();
+        m_connectionManager.handleOpenFailed(errorString);
+        return false;
+    }
 
-    // ОПТИМИЗАЦИЯ: Сбрасываем кэши графиков
-    m_lastPitchData.clear();
-    m_lastRollData.clear();
-    m_lastYawData.clear();
-    m_updateCounter = 0;
-
-    m_serialPort = new QSerialPort(this);
-    m_serialPort->setPortName(m_selectedPort);
-    m_serialPort->setBaudRate(QSerialPort::Baud115200);
-    m_serialPort->setDataBits(QSerialPort::Data8);
-    m_serialPort->setParity(QSerialPort::NoParity);
-    m_serialPort->setStopBits(QSerialPort::OneStop);
-    m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
-
-    // ОПТИМИЗАЦИЯ: Настраиваем размеры буферов
-    m_serialPort->setReadBufferSize(2048);
-
-    connect(m_serialPort, &QSerialPort::readyRead, this, &TiltController::readCOMPortData, Qt::QueuedConnection);
-    connect(m_serialPort, &QSerialPort::errorOccurred, this, &TiltController::handleCOMPortError, Qt::QueuedConnection);
-
-    try {
-        if (m_serialPort->open(QIODevice::ReadOnly)) {
-            m_connected = true;
-            m_autoConnectTimer.stop();
-            m_safetyTimer.start();
-
-            if (m_logMode) {
-                stopLog();
-                m_logMode = false;
-                emit logModeChanged(m_logMode);
-                emit logControlsEnabledChanged(logControlsEnabled());
-            }
+    const bool wasConnected = m_connected;
+    m_connected = true;
+    m_autoConnectTimer.stop();
+
+    if (m_logMode) {
+        stopLog();
+        m_logMode = false;
+        emit logModeChanged(m_logMode);
+        emit logControlsEnabledChanged(logControlsEnabled());
+    }
 
-            m_incompleteData.clear();
-            m_dataBuffer.clear();
-            m_prevFrame = DataFrame();
+    m_ingestDrainTimer.start();
 
-            // ДОБАВЛЯЕМ ЗАПУСК ТАЙМЕРА ДЛЯ COM-СКОРОСТЕЙ
-            if (!m_comSpeedUpdateTimer.isActive()) {
-                m_comSpeedUpdateTimer.start();
-            }
+    if (!resume) {
+        addNotification("Успешное подключение к " + m_selectedPort);
+    }
+    m_connectionManager.handleOpened();
 
-            addNotification("Успешное подключение к " + m_selectedPort);
-            emit connectedChanged(m_connected);
-            return true;
-        } else {
-            addNotification("Ошибка подключения к " + m_selectedPort + ": " + m_serialPort->errorString());
-            cleanupCOMPort();
-            return false;
-        }
-    } catch (const std::exception& e) {
-        addNotification("Исключение при подключении к COM-порту: " + QString(e.what()));
-        cleanupCOMPort();
-        return false;
+    if (!wasConnected) {
+        emit connectedChanged(m_connected);
     }
+    return true;
 }
 
 void TiltController::cleanupCOMPort()
 {
-    m_safetyTimer.stop();
-
-    // Останавливаем таймер COM-порта
-    if (m_comSpeedUpdateTimer.isActive()) {
-        m_comSpeedUpdateTimer.stop();
-    }
-
-    if (m_serialPort) {
-        disconnect(m_serialPort, nullptr, this, nullptr);
+    closeIngestTransport();
+}
 
-        if (m_serialPort->isOpen()) {
-            try {
-                m_serialPort->close();
-            } catch (const std::exception& e) {
-                qDebug() << "Exception while closing port:" << e.what();
-            }
-        }
+void TiltController::closeIngestTransport()
+{
+    m_ingestDrainTimer.stop();
 
-        m_serialPort->deleteLater();
-        m_serialPort = nullptr;
+    // Закрываем порт/сокет в потоке приёма и дожидаемся, чтобы новые кадры больше не поступали
+    if (m_ingestWorker && m_ingestThread.isRunning()) {
+        QMetaObject::invokeMethod(m_ingestWorker, &IngestWorker::closeTransport, Qt::BlockingQueuedConnection);
     }
 
     // ДОПОЛНИТЕЛЬНАЯ ОЧИСТКА ДАННЫХ
-    m_incompleteData.clear();
+    m_ingestQueue.clear();
 }
 
 void TiltController::setAngularSpeedUpdateFrequencyCOM(float frequency)
@@ -1721,19 +1996,8 @@ void TiltController::setAngularSpeedUpdateFrequencyCOM(float frequency)
 
         m_angularSpeedUpdateFrequencyCOM = frequency;
 
-        // Обновляем интервал таймера для COM-порта
-        m_comSpeedUpdateTimer.setInterval(1000 / frequency);
-
-        // Пересчитываем скорости для COM-порта
-        if (m_connected && !m_logMode) {
-            if (m_comSpeedUpdateTimer.isActive()) {
-                m_comSpeedUpdateTimer.stop();
-            }
-            m_comSpeedUpdateTimer.start();
-
-            // Немедленно обновляем скорости при изменении частоты
-            QTimer::singleShot(50, this, &TiltController::updateCOMAngularSpeeds);
-        }
+        // Скорость выводится с новой частотой начиная со следующего кадра
+        m_lastComSpeedDisplay = -1;
 
         emit angularSpeedUpdateFrequencyCOMChanged(frequency);
     }
@@ -1792,8 +2056,10 @@ void TiltController::setAngularSpeedSmoothingLog(float smoothing)
         // Обновляем LogReader с новым окном сглаживания
         m_logReader.setSmoothingWindow(smoothing);
 
-        // Пересчитываем скорости при изменении сглаживания
+        // Пересчитываем скорости при изменении сглаживания: каналы - в фоне,
+        // до их готовности текущая скорость считается по окну
         if (m_logMode && m_logLoaded) {
+            updateSpeedChannels();
             updateAngularSpeeds();
         }
 
@@ -1831,18 +2097,58 @@ void TiltController::setAngularSpeedDisplayRateLog(float rate)
     }
 }
 
-void TiltController::processCOMPortData(const QByteArray &data)
+void TiltController::drainIngestQueue()
 {
-    m_incompleteData.append(data);
+    if (!m_connected || m_logMode || m_isCleaningUp) {
+        return;
+    }
 
-    // Ограничиваем размер буфера неполных данных
-    if (m_incompleteData.size() > 2048) {
-        m_incompleteData = m_incompleteData.right(1024); // Оставляем последние данные
+    // Забираем всё, что поток приёма успел положить в очередь с прошлого кадра.
+    // ОПТИМИЗАЦИЯ: каждый кадр попадает в буфер, расчёт скоростей и запись исследования,
+    // а модель головы и графики обновляются один раз - по самому новому кадру пачки.
+    // Иначе пачка из 20 кадров WiFi 20 раз подряд пересчитывает привязки QML
+    DataFrame frame;
+    DataFrame newest;
+    bool received = false;
+    bool hasNewest = false;
+
+    // Глубина очереди показывает, успевает ли GUI-поток за приёмом
+    m_ingestBacklog = static_cast<int>(m_ingestQueue.size());
+    m_maxIngestBacklog = qMax(m_maxIngestBacklog, m_ingestBacklog);
+
+    while (m_ingestQueue.pop(frame)) {
+        received = true;
+        if (processIngestedFrame(frame)) {
+            m_liveOrientation.append(frame.timestamp, QVector3D(frame.pitch, frame.yaw, frame.roll));
+            newest = frame;
+            hasNewest = true;
+        }
     }
 
-    int processedLines = 0;
-    const int MAX_LINES_PER_CYCLE = 100; // Защита от зацикливания
+    if (!received) {
+        return;
+    }
 
+    if (hasNewest) {
+        publishDataFrame(newest);
+
+        if (m_recording) {
+            m_researchRecorder.flush();
+
+            // Ошибка диска видна сразу, а не при остановке записи через несколько часов
+            if (m_researchRecorder.hasError() && !m_recordingErrorReported) {
+                m_recordingErrorReported = true;
+                addNotification("Ошибка записи файла исследования: " + m_researchRecorder.errorString());
+            }
+        }
+    }
+
+    m_lastDataTime = QDateTime::currentMSecsSinceEpoch();
+    m_connectionManager.handleDataReceived();
+}
+
+bool TiltController::processIngestedFrame(DataFrame &frame)
+{
     // Вспомогательная функция для нормализации угла в диапазон [-180, 180]
     auto normalizeAngle = [](float angle) -> float {
         // Нормализуем угол в диапазон [-180, 180]
@@ -1851,93 +2157,26 @@ void TiltController::processCOMPortData(const QByteArray &data)
         return angle;
     };
 
-    while (processedLines < MAX_LINES_PER_CYCLE) {
-        int newlinePos = m_incompleteData.indexOf('\n');
-        if (newlinePos == -1) {
-            break;
-        }
-
-        QByteArray completeLine = m_incompleteData.left(newlinePos).trimmed();
-        m_incompleteData = m_incompleteData.mid(newlinePos + 1);
-        processedLines++;
-
-        if (completeLine.isEmpty()) {
-            continue;
-        }
-
-        QString dataString = QString::fromUtf8(completeLine);
-
-        // ОПТИМИЗАЦИЯ: Более эффективная очистка строки
-        QString cleanedString = dataString;
-        cleanedString.remove(QRegularExpression("[^0-9;.-]"));
+    const float rawPitch = frame.pitch;
+    const float rawRoll = frame.roll;
+    const float rawYaw = frame.yaw;
 
-        if (!cleanedString.contains(';') || cleanedString.count(';') < 5) {
-            continue;
-        }
-
-        QStringList parts = cleanedString.split(';');
-
-        if (parts.size() >= 6) {
-            bool ok1, ok2, ok3, ok4, ok5, ok6;
-
-            qint64 timestamp;
-            if (m_useRelativeTime) {
-                timestamp = QDateTime::currentMSecsSinceEpoch() - m_startTime;
-            } else {
-                timestamp = parts[0].toLongLong(&ok1);
-                if (!ok1) {
-                    timestamp = QDateTime::currentMSecsSinceEpoch() - m_startTime;
-                }
-            }
-
-            // ПРИМЕНЯЕМ КАЛИБРОВКУ К СЫРЫМ ДАННЫМ
-            float rawPitch = parts[1].replace(',', '.').toFloat(&ok2);
-            float rawRoll = parts[2].replace(',', '.').toFloat(&ok3);
-            float rawYaw = parts[3].replace(',', '.').toFloat(&ok4);
-
-            float calibratedPitch = rawPitch - m_calibrationPitch;
-            float calibratedRoll = rawRoll - m_calibrationRoll;
-            float calibratedYaw = rawYaw - m_calibrationYaw;
-
-            bool patientDizziness = (parts[4].toInt(&ok5) == 1);
-            bool doctorDizziness = (parts[5].toInt(&ok6) == 1);
-
-            if (ok2 && ok3 && ok4 && ok5 && ok6) {
-                // Проверяем корректность калиброванных данных
-                if (qIsNaN(calibratedPitch) || qIsNaN(calibratedRoll) || qIsNaN(calibratedYaw) ||
-                    qIsInf(calibratedPitch) || qIsInf(calibratedRoll) || qIsInf(calibratedYaw)) {
-                    continue;
-                }
+    // ПРИМЕНЯЕМ КАЛИБРОВКУ К СЫРЫМ ДАННЫМ И НОРМАЛИЗУЕМ УГЛЫ В ДИАПАЗОН [-180, 180]
+    frame.pitch = normalizeAngle(rawPitch - m_calibrationPitch);
+    frame.roll = normalizeAngle(rawRoll - m_calibrationRoll);
+    frame.yaw = normalizeAngle(rawYaw - m_calibrationYaw);
 
-                // НОРМАЛИЗУЕМ УГЛЫ В ДИАПАЗОН [-180, 180] ВМЕСТО ОТБРАСЫВАНИЯ
-                calibratedPitch = normalizeAngle(calibratedPitch);
-                calibratedRoll = normalizeAngle(calibratedRoll);
-                calibratedYaw = normalizeAngle(calibratedYaw);
-
-                // Дополнительная проверка для отладки (необязательно)
-                if (rawPitch < -180 || rawPitch > 180 ||
-                    rawRoll < -180 || rawRoll > 180 ||
-                    rawYaw < -180 || rawYaw > 180) {
-                    qDebug() << "Raw angles out of range (will be normalized):"
-                             << rawPitch << rawRoll << rawYaw
-                             << "->" << calibratedPitch << calibratedRoll << calibratedYaw;
-                }
-
-                DataFrame frame;
-                frame.timestamp = timestamp;
-                frame.pitch = calibratedPitch;    // ЗАПИСЫВАЕМ КАЛИБРОВАННЫЕ И НОРМАЛИЗОВАННЫЕ ДАННЫЕ
-                frame.roll = calibratedRoll;
-                frame.yaw = calibratedYaw;
-                frame.patientDizziness = patientDizziness;
-                frame.doctorDizziness = doctorDizziness;
-
-                m_dataBuffer.add(frame);
-                processDataFrame(frame);
-
-                m_lastDataTime = QDateTime::currentMSecsSinceEpoch();
-            }
-        }
+    // Дополнительная проверка для отладки (необязательно)
+    if (rawPitch < -180 || rawPitch > 180 ||
+        rawRoll < -180 || rawRoll > 180 ||
+        rawYaw < -180 || rawYaw > 180) {
+        qDebug() << "Raw angles out of range (will be normalized):"
+                 << rawPitch << rawRoll << rawYaw
+                 << "->" << frame.pitch << frame.roll << frame.yaw;
     }
+
+    m_dataBuffer.add(frame);
+    return processDataFrame(frame);
 }
 
 void TiltController::calibrateDevice()
@@ -1987,6 +2226,9 @@ void TiltController::safeDisconnect()
 
     m_isCleaningUp = true;
 
+    // Отключение окончательное: попытки переподключения прекращаются
+    m_connectionManager.stop();
+
     // Останавливаем запись исследования если она активна
     if (m_recording) {
         stopResearchRecording();
@@ -1995,7 +2237,7 @@ void TiltController::safeDisconnect()
     // Отключаем в зависимости от типа соединения
     if (m_connectionType == "COM") {
         cleanupCOMPort();
-    } else if (m_connectionType == "WiFi") {
+    } else if (m_connectionType == "WiFi" || m_connectionType == "UDP") {
         cleanupWiFiConnection();
     }
 
@@ -2049,7 +2291,7 @@ void TiltController::safeDisconnect()
     emit graphDataChanged();
 
     // ИСПРАВЛЕННАЯ СТРОКА - используем QString::arg()
-    QString message = QString("Отключено от %1. Данные сброшены.").arg(m_connectionType == "COM" ? "COM-порта" : "WiFi");
+    QString message = QString("Отключено от %1. Данные сброшены.").arg(m_connectionType == "COM" ? "COM-порта" : m_connectionType);
     addNotification(message);
 
     emit connectedChanged(m_connected);
@@ -2058,10 +2300,13 @@ void TiltController::safeDisconnect()
 
 void TiltController::setConnectionType(const QString &type)
 {
-    if (m_connectionType != type && (type == "COM" || type == "WiFi")) {
-        // Отключаем текущее соединение при смене типа
+    if (m_connectionType != type && (type == "COM" || type == "WiFi" || type == "UDP")) {
+        // Отключаем текущее соединение (или прерываем подключение) при смене типа
         if (m_connected) {
             safeDisconnect();
+        } else if (m_connectionManager.state() != ConnectionManager::Disconnected) {
+            m_connectionManager.stop();
+            cleanupWiFiConnection();
         }
 
         m_connectionType = type;
@@ -2092,52 +2337,118 @@ void TiltController::setWifiPort(int port)
     }
 }
 
-void TiltController::setupWiFiConnection()
+void TiltController::setupWiFiConnection(bool resume)
 {
-    // ЕСЛИ МЫ В РЕЖИМЕ ЛОГ-ФАЙЛА, ПРЕДВАРИТЕЛЬНО ПЕРЕКЛЮЧАЕМСЯ В РЕЖИМ РЕАЛЬНОГО ВРЕМЕНИ
-    if (m_logMode) {
-        switchToRealtimeMode();
+    if (!resume) {
+        // ЕСЛИ МЫ В РЕЖИМЕ ЛОГ-ФАЙЛА, ПРЕДВАРИТЕЛЬНО ПЕРЕКЛЮЧАЕМСЯ В РЕЖИМ РЕАЛЬНОГО ВРЕМЕНИ
+        if (m_logMode) {
+            switchToRealtimeMode();
+        }
+
+        // ПОЛНЫЙ СБРОС ДАННЫХ ПЕРЕД ПОДКЛЮЧЕНИЕМ
+        resetAllData();
     }
 
-    if (m_tcpSocket->state() == QAbstractSocket::ConnectedState) {
-        m_tcpSocket->disconnectFromHost();
+    closeIngestTransport();
+
+    // Подключение (с таймаутом 5 секунд) выполняется в потоке приёма без ожидания,
+    // результат приходит в handleWiFiConnectFinished
+    m_wifiConnecting = true;
+    m_wifiResuming = resume;
+    IngestWorker *worker = m_ingestWorker;
+    const QString address = m_wifiAddress;
+    const int port = m_wifiPort;
+    const qint64 sessionStart = m_startTime;
+    QMetaObject::invokeMethod(m_ingestWorker, [worker, address, port, sessionStart]() {
+        worker->connectToHost(address, port, sessionStart);
+    }, Qt::QueuedConnection);
+}
+
+void TiltController::setupUdpConnection(bool resume)
+{
+    if (!resume) {
+        if (m_logMode) {
+            switchToRealtimeMode();
+        }
+
+        // ПОЛНЫЙ СБРОС ДАННЫХ ПЕРЕД ПОДКЛЮЧЕНИЕМ
+        resetAllData();
     }
 
-    cleanupWiFiConnection();
+    closeIngestTransport();
+
+    // UDP не устанавливает соединение: сокет только привязывается к порту,
+    // это быстро, поэтому результат ждём так же, как при открытии COM-порта
+    bool opened = false;
+    QString errorString;
+    quint16 localPort = 0;
+    const QString address = m_wifiAddress;
+    const int port = m_wifiPort;
+    const qint64 sessionStart = m_startTime;
+    QMetaObject::invokeMethod(m_ingestWorker, [&]() {
+        opened = m_ingestWorker->openUdpSocket(address, port, sessionStart, &errorString);
+        localPort = m_ingestWorker->udpLocalPort();
+    }, Qt::BlockingQueuedConnection);
+
+    if (!opened) {
+        if (!resume) {
+            addNotification("Ошибка открытия UDP-порта: " + errorString);
+        }
+        closeIngestTransport();
+        m_connectionManager.handleOpenFailed(errorString);
+        return;
+    }
 
-    // ПОЛНЫЙ СБРОС ДАННЫХ ПЕРЕД ПОДКЛЮЧЕНИЕМ
-    resetAllData();
+    if (!resume) {
+        addNotification(QString("Приём UDP на порту %1 от %2 (порт устройства %3)")
+                            .arg(localPort).arg(m_wifiAddress).arg(m_wifiPort));
+    }
+    completeWiFiOpen();
+}
 
-    m_tcpSocket->connectToHost(m_wifiAddress, m_wifiPort);
+void TiltController::handleWiFiConnectFinished(bool ok, const QString &errorString)
+{
+    // Подключение могли отменить, пока поток приёма ждал ответа
+    if (!m_wifiConnecting) {
+        return;
+    }
+    m_wifiConnecting = false;
 
-    // Таймаут подключения - 5 секунд
-    if (!m_tcpSocket->waitForConnected(5000)) {
-        addNotification("Ошибка подключения к WiFi: " + m_tcpSocket->errorString());
-        cleanupWiFiConnection();
+    if (!ok) {
+        if (!m_wifiResuming) {
+            addNotification("Ошибка подключения к WiFi: " + errorString);
+        }
+        closeIngestTransport();
+        m_connectionManager.handleOpenFailed(errorString);
         return;
     }
 
+    if (!m_wifiResuming) {
+        addNotification(QString("Успешное подключение к WiFi: %1:%2").arg(m_wifiAddress).arg(m_wifiPort));
+    }
+    completeWiFiOpen();
+}
+
+void TiltController::completeWiFiOpen()
+{
     m_wifiConnected = true;
+    const bool wasConnected = m_connected;
     m_connected = true;
 
-    // Запускаем таймер для обновления скоростей
-    if (!m_comSpeedUpdateTimer.isActive()) {
-        m_comSpeedUpdateTimer.start();
-    }
+    m_ingestDrainTimer.start();
 
-    addNotification(QString("Успешное подключение к WiFi: %1:%2").arg(m_wifiAddress).arg(m_wifiPort));
-    emit connectedChanged(m_connected);
+    m_connectionManager.handleOpened();
+
+    if (!wasConnected) {
+        emit connectedChanged(m_connected);
+    }
     emit wifiConnectedChanged(m_wifiConnected);
 }
 
 void TiltController::cleanupWiFiConnection()
 {
-    if (m_tcpSocket) {
-        if (m_tcpSocket->state() == QAbstractSocket::ConnectedState) {
-            m_tcpSocket->disconnectFromHost();
-        }
-        m_tcpSocket->close();
-    }
+    m_wifiConnecting = false;
+    closeIngestTransport();
 
     m_wifiConnected = false;
     m_connected = false;
@@ -2146,44 +2457,196 @@ void TiltController::cleanupWiFiConnection()
     emit wifiConnectedChanged(m_wifiConnected);
 }
 
-void TiltController::readWiFiData()
+void TiltController::handleWiFiError(const QString &errorString)
 {
-    if (!m_tcpSocket || m_tcpSocket->state() != QAbstractSocket::ConnectedState) {
-        return;
+    if (m_wifiConnected && m_connectionManager.isLinkUp()) {
+        // Сессию не сбрасываем: менеджер подключения попробует восстановить связь
+        m_connectionManager.handleLinkLost("ошибка WiFi соединения: " + errorString);
     }
+}
 
-    QByteArray data = m_tcpSocket->readAll();
+void TiltController::handleWiFiDisconnected()
+{
+    if (m_wifiConnected && m_connectionManager.isLinkUp()) {
+        m_connectionManager.handleLinkLost("WiFi соединение разорвано");
+    }
+}
 
-    if (data.isEmpty()) {
-        return;
+void TiltController::openTransport(bool resume)
+{
+    // Пауза оказалась слишком длинной, чтобы продолжить сессию: начинаем новую,
+    // а запись исследования закрываем, чтобы в файле не было разрыва во времени
+    if (!resume && m_connectionManager.state() == ConnectionManager::Reconnecting && m_recording) {
+        stopResearchRecording();
+    }
+
+    if (resume) {
+        m_lostPacketsBase = m_lostPackets;
+
+        // Поток приёма начнёт счёт заново: переносим накопленное в базу сессии
+        refreshIngestStats();
+        m_ingestStatsBase += m_ingestStats;
+        m_ingestStats = IngestStats();
     }
 
-    // Обрабатываем данные так же, как и с COM-порта
-    processCOMPortData(data);
+    if (m_connectionType == "COM") {
+        setupCOMPort(resume);
+    } else if (m_connectionType == "WiFi") {
+        setupWiFiConnection(resume);
+    } else if (m_connectionType == "UDP") {
+        setupUdpConnection(resume);
+    }
 }
 
-void TiltController::handleWiFiError(QAbstractSocket::SocketError error)
+void TiltController::handleLinkLost(const QString &reason)
 {
-    Q_UNUSED(error)
+    // Уже принятые кадры остаются в сессии, транспорт закрываем до следующей попытки
+    drainIngestQueue();
+    m_wifiConnecting = false;
+    closeIngestTransport();
 
     if (m_wifiConnected) {
-        addNotification("Ошибка WiFi соединения: " + m_tcpSocket->errorString());
+        m_wifiConnected = false;
+        emit wifiConnectedChanged(m_wifiConnected);
+    }
+
+    addNotification("Связь с устройством потеряна (" + reason + "). Переподключение...");
+}
+
+void TiltController::handleSessionResumed(int attempts)
+{
+    addNotification(QString("Связь восстановлена (попыток: %1). Сессия продолжена.").arg(attempts));
+}
+
+void TiltController::handleSessionRestarted(int attempts)
+{
+    addNotification(QString("Связь восстановлена (попыток: %1). Пауза была дольше %2 с - начата новая сессия.")
+                        .arg(attempts)
+                        .arg(ConnectionManager::ResumeWindowMs / 1000));
+}
+
+void TiltController::handleConnectFailed(const QString &errorString)
+{
+    Q_UNUSED(errorString)
+
+    // Сообщение об ошибке уже показано при открытии транспорта
+    if (m_connectionType == "COM") {
+        cleanupCOMPort();
+    } else {
         cleanupWiFiConnection();
+    }
+}
 
-        // Полный сброс данных как при отключении COM-порта
-        safeDisconnect();
+void TiltController::handleReconnectGaveUp()
+{
+    addNotification("Не удалось восстановить связь с устройством");
+    safeDisconnect();
+}
+
+void TiltController::handleConnectionStateChanged()
+{
+    emit connectionStateChanged(m_connectionManager.stateName());
+}
+
+void TiltController::handleStreamFormatDetected(int format)
+{
+    QString streamFormat;
+    if (format == FrameParser::AsciiFormat) {
+        streamFormat = "ASCII";
+    } else if (format == FrameParser::BinaryFormat) {
+        streamFormat = "Binary";
+    }
+
+    if (m_streamFormat != streamFormat) {
+        m_streamFormat = streamFormat;
+        emit streamFormatChanged(m_streamFormat);
+
+        if (!m_streamFormat.isEmpty()) {
+            addNotification("Формат данных устройства: " + m_streamFormat);
+        }
     }
 }
 
-void TiltController::handleWiFiStateChanged(QAbstractSocket::SocketState state)
+void TiltController::handleLostPacketsChanged(quint64 lostPackets)
 {
-    if (state == QAbstractSocket::UnconnectedState && m_wifiConnected) {
-        addNotification("WiFi соединение разорвано");
-        cleanupWiFiConnection();
-        safeDisconnect();
+    // Поток приёма считает потери заново после каждого переподключения
+    const qint64 total = m_lostPacketsBase + static_cast<qint64>(lostPackets);
+    if (m_lostPackets != total) {
+        m_lostPackets = total;
+        emit lostPacketsChanged(m_lostPackets);
     }
 }
 
+void TiltController::handleTimebaseUpdated(double jitterMs, double driftPpm)
+{
+    m_timingJitter = jitterMs;
+    m_clockDrift = driftPpm;
+    emit timebaseChanged();
+}
+
+void TiltController::handleIngestStats(const IngestStats &stats)
+{
+    m_ingestStats = stats;
+    emit ingestStatsChanged();
+}
+
+IngestStats TiltController::sessionIngestStats() const
+{
+    IngestStats total = m_ingestStatsBase;
+    total += m_ingestStats;
+    return total;
+}
+
+void TiltController::refreshIngestStats()
+{
+    // Сигнал statsUpdated приходит раз в секунду; для итогов берём точные значения
+    if (m_ingestWorker && m_ingestThread.isRunning()) {
+        IngestStats stats;
+        QMetaObject::invokeMethod(m_ingestWorker, [&]() {
+            stats = m_ingestWorker->stats();
+        }, Qt::BlockingQueuedConnection);
+        m_ingestStats = stats;
+    }
+}
+
+QVariantMap TiltController::framesRejectedByReason() const
+{
+    const IngestStats stats = sessionIngestStats();
+
+    QVariantMap reasons;
+    reasons["crc"] = static_cast<qint64>(stats.rejectedPackets);
+    reasons["malformed"] = static_cast<qint64>(stats.rejectedLines);
+    reasons["invalidValue"] = static_cast<qint64>(stats.invalidValues);
+    reasons["queueOverflow"] = static_cast<qint64>(stats.queueOverflow);
+    reasons["late"] = static_cast<qint64>(stats.lateFrames);
+    reasons["duplicate"] = static_cast<qint64>(stats.duplicateFrames);
+    return reasons;
+}
+
+void TiltController::resetStreamInfo()
+{
+    if (!m_streamFormat.isEmpty()) {
+        m_streamFormat.clear();
+        emit streamFormatChanged(m_streamFormat);
+    }
+
+    m_ingestStats = IngestStats();
+    m_ingestStatsBase = IngestStats();
+    m_ingestBacklog = 0;
+    m_maxIngestBacklog = 0;
+    emit ingestStatsChanged();
+
+    m_lostPacketsBase = 0;
+    if (m_lostPackets != 0) {
+        m_lostPackets = 0;
+        emit lostPacketsChanged(m_lostPackets);
+    }
+
+    m_timingJitter = 0.0;
+    m_clockDrift = 0.0;
+    emit timebaseChanged();
+}
+
 // Добавляем метод для полного сброса данных
 void TiltController::resetAllData()
 {
@@ -2220,8 +2683,12 @@ void TiltController::resetAllData()
 
     // Сбрасываем временные метки
     m_startTime = QDateTime::currentMSecsSinceEpoch();
+    m_sessionClockOrigin = m_playbackClock.nsecsElapsed();
+    m_liveOrientation.clear();
     m_lastDataTime = 0;
 
+    resetStreamInfo();
+
     // Форсируем обновление графиков
     emit graphDataChanged();
 }
@@ -3,6 +3,9 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
+#include <QtCore/QCache>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPointer>
 #include <QtCore/QVector>
 #include <QtCore/QUrl>
 #include <QtCore/QDateTime>
@@ -12,30 +15,29 @@
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVariantMap>
 #include <QTcpSocket>
 #include <QHostAddress>
 #include <QDesktopServices>
 #include "headmodel.h"
+#include "orientation_interpolator.h"
 #include "log_reader.h"
-
-// Структура для хранения одного кадра данных
-struct DataFrame {
-    qint64 timestamp;        // Время в мс
-    float pitch;             // Угол по pitch
-    float roll;              // Угол по roll
-    float yaw;               // Угол по yaw
-    bool patientDizziness;   // Головокружение пациента (0 или 1)
-    bool doctorDizziness;    // Головокружение врача (0 или 1)
-
-    DataFrame() : timestamp(0), pitch(0), roll(0), yaw(0),
-        patientDizziness(false), doctorDizziness(false) {}
-};
-
-struct AngleDataPoint {
-    qint64 timestamp;
-    float angle;
-    AngleDataPoint(qint64 t, float a) : timestamp(t), angle(a) {}
-};
+#include "angular_speed_estimator.h"
+#include "sample_store.h"
+#include "log_file_loader.h"
+#include "playback_cursor.h"
+#include "data_frame.h"
+#include "spsc_ring_buffer.h"
+#include "ingest_worker.h"
+#include "connection_manager.h"
+#include "port_watcher.h"
+#include "research_catalog.h"
+#include "research_recorder.h"
+
+class QQuickWindow;
 
 // Кольцевой буфер на 1800 кадров
 class CircularBuffer {
@@ -109,16 +111,24 @@ class TiltController : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(HeadModel* headModel READ headModel CONSTANT)
+    Q_PROPERTY(ResearchCatalog* researchCatalog READ researchCatalog CONSTANT)
     Q_PROPERTY(bool connected READ connected NOTIFY connectedChanged)
     Q_PROPERTY(int currentTime READ currentTime NOTIFY currentTimeChanged)
     Q_PROPERTY(int totalTime READ totalTime NOTIFY totalTimeChanged)
     Q_PROPERTY(bool logPlaying READ logPlaying NOTIFY logPlayingChanged)
+    Q_PROPERTY(double playbackRate READ playbackRate WRITE setPlaybackRate NOTIFY playbackRateChanged)  // 0.1x - 32x
+    Q_PROPERTY(bool playbackReverse READ playbackReverse WRITE setPlaybackReverse NOTIFY playbackReverseChanged)
+    Q_PROPERTY(bool orientationInterpolation READ orientationInterpolation WRITE setOrientationInterpolation NOTIFY orientationInterpolationChanged)
+    Q_PROPERTY(int liveLatencyBudget READ liveLatencyBudget WRITE setLiveLatencyBudget NOTIFY liveLatencyBudgetChanged)  // мс, 0 - без сглаживания
     Q_PROPERTY(QString notification READ notification NOTIFY notificationChanged)
     Q_PROPERTY(QStringList availablePorts READ availablePorts NOTIFY availablePortsChanged)
     Q_PROPERTY(QString selectedPort READ selectedPort WRITE setSelectedPort NOTIFY selectedPortChanged)
     Q_PROPERTY(bool logLoaded READ logLoaded NOTIFY logLoadedChanged)
     Q_PROPERTY(bool logMode READ logMode NOTIFY logModeChanged)
     Q_PROPERTY(bool logControlsEnabled READ logControlsEnabled NOTIFY logControlsEnabledChanged)
+    Q_PROPERTY(bool loading READ loading NOTIFY loadingChanged)
+    Q_PROPERTY(double loadProgress READ loadProgress NOTIFY loadProgressChanged)
+    Q_PROPERTY(int logMemoryBudget READ logMemoryBudget WRITE setLogMemoryBudget NOTIFY logMemoryBudgetChanged)  // МБ
     Q_PROPERTY(QString studyInfo READ studyInfo NOTIFY studyInfoChanged)
     Q_PROPERTY(int graphDuration READ graphDuration WRITE setGraphDuration NOTIFY graphDurationChanged)
     Q_PROPERTY(QVariantList pitchGraphData READ pitchGraphData NOTIFY graphDataChanged)
@@ -128,6 +138,7 @@ class TiltController : public QObject
     Q_PROPERTY(int updateFrequency READ updateFrequency NOTIFY updateFrequencyChanged)
     Q_PROPERTY(QString researchNumber READ researchNumber NOTIFY researchNumberChanged)
     Q_PROPERTY(bool recording READ recording NOTIFY recordingChanged)
+    Q_PROPERTY(bool compressedRecording READ compressedRecording WRITE setCompressedRecording NOTIFY compressedRecordingChanged)
     Q_PROPERTY(QVariantList dizzinessPatientData READ dizzinessPatientData NOTIFY graphDataChanged)
     Q_PROPERTY(QVariantList dizzinessDoctorData READ dizzinessDoctorData NOTIFY graphDataChanged)
     Q_PROPERTY(bool patientDizziness READ patientDizziness NOTIFY patientDizzinessChanged)
@@ -148,22 +159,49 @@ class TiltController : public QObject
     Q_PROPERTY(QString wifiAddress READ wifiAddress WRITE setWifiAddress NOTIFY wifiAddressChanged)
     Q_PROPERTY(int wifiPort READ wifiPort WRITE setWifiPort NOTIFY wifiPortChanged)
     Q_PROPERTY(bool wifiConnected READ wifiConnected NOTIFY wifiConnectedChanged)
+    Q_PROPERTY(QString streamFormat READ streamFormat NOTIFY streamFormatChanged)
+    Q_PROPERTY(qint64 lostPackets READ lostPackets NOTIFY lostPacketsChanged)
+    Q_PROPERTY(double timingJitter READ timingJitter NOTIFY timebaseChanged)
+    Q_PROPERTY(double clockDrift READ clockDrift NOTIFY timebaseChanged)
+    Q_PROPERTY(QString connectionState READ connectionState NOTIFY connectionStateChanged)
+
+    // Статистика приёма за сессию подключения
+    Q_PROPERTY(qint64 bytesReceived READ bytesReceived NOTIFY ingestStatsChanged)
+    Q_PROPERTY(qint64 framesParsed READ framesParsed NOTIFY ingestStatsChanged)
+    Q_PROPERTY(qint64 framesRejected READ framesRejected NOTIFY ingestStatsChanged)
+    Q_PROPERTY(QVariantMap framesRejectedByReason READ framesRejectedByReason NOTIFY ingestStatsChanged)
+    Q_PROPERTY(qint64 bytesDiscarded READ bytesDiscarded NOTIFY ingestStatsChanged)
+    Q_PROPERTY(int ingestBacklog READ ingestBacklog NOTIFY ingestStatsChanged)
+    Q_PROPERTY(int maxIngestBacklog READ maxIngestBacklog NOTIFY ingestStatsChanged)
 
 public:
     explicit TiltController(QObject *parent = nullptr);
     ~TiltController();
 
     HeadModel* headModel() { return &m_headModel; }
+    ResearchCatalog* researchCatalog() { return &m_researchCatalog; }
     bool connected() const { return m_connected; }
     int currentTime() const { return m_currentTime; }
     int totalTime() const { return m_totalTime; }
     bool logPlaying() const { return m_logPlaying; }
+    double playbackRate() const { return m_playbackRate; }
+    void setPlaybackRate(double rate);
+    bool playbackReverse() const { return m_playbackReverse; }
+    void setPlaybackReverse(bool reverse);
+    bool orientationInterpolation() const { return m_orientationInterpolation; }
+    void setOrientationInterpolation(bool enabled);
+    int liveLatencyBudget() const { return m_liveLatencyBudget; }
+    void setLiveLatencyBudget(int milliseconds);
     QString notification() const { return m_notification; }
     QStringList availablePorts() const { return m_availablePorts; }
     QString selectedPort() const { return m_selectedPort; }
     bool logLoaded() const { return m_logLoaded; }
     bool logMode() const { return m_logMode; }
     bool logControlsEnabled() const { return m_logMode && m_logLoaded; }
+    bool loading() const { return m_loading; }
+    double loadProgress() const { return m_loadProgress; }
+    int logMemoryBudget() const { return m_logMemoryBudget; }
+    void setLogMemoryBudget(int megabytes);
     QString studyInfo() const { return m_studyInfo; }
     int graphDuration() const { return m_graphDuration; }
     void setGraphDuration(int duration);
@@ -175,6 +213,8 @@ public:
     int updateFrequency() const { return m_updateFrequency; }
     QString researchNumber() const { return m_researchNumber; }
     bool recording() const { return m_recording; }
+    bool compressedRecording() const { return m_compressedRecording; }
+    void setCompressedRecording(bool compressed);
 
     QVariantList dizzinessPatientData() const { return m_dizzinessPatientData; }
     QVariantList dizzinessDoctorData() const { return m_dizzinessDoctorData; }
@@ -209,16 +249,40 @@ public:
     int wifiPort() const { return m_wifiPort; }
     bool wifiConnected() const { return m_wifiConnected; }
 
-    QStringList availablePorts();
+    // Формат потока от устройства ("ASCII"/"Binary") и потери по номерам пакетов
+    QString streamFormat() const { return m_streamFormat; }
+    qint64 lostPackets() const { return m_lostPackets; }
+
+    // Оценки по часам устройства: джиттер доставки (мс) и дрейф часов (ppm)
+    double timingJitter() const { return m_timingJitter; }
+    double clockDrift() const { return m_clockDrift; }
+
+    // "disconnected", "connecting", "connected", "degraded" или "reconnecting"
+    QString connectionState() const { return m_connectionManager.stateName(); }
+
+    qint64 bytesReceived() const { return static_cast<qint64>(sessionIngestStats().bytesReceived); }
+    qint64 framesParsed() const { return static_cast<qint64>(sessionIngestStats().framesParsed); }
+    qint64 framesRejected() const { return static_cast<qint64>(sessionIngestStats().framesRejected()); }
+    QVariantMap framesRejectedByReason() const;
+    qint64 bytesDiscarded() const { return static_cast<qint64>(sessionIngestStats().bytesDiscarded); }
+    // Кадров в очереди из потока приёма на момент последней выборки и максимум за сессию
+    int ingestBacklog() const { return m_ingestBacklog; }
+    int maxIngestBacklog() const { return m_maxIngestBacklog; }
+
+    // Окно, по кадрам которого идёт воспроизведение лога. Без окна - таймер 16 мс
+    void setFrameSource(QQuickWindow *window);
 
 public slots:
     void connectDevice();
     void disconnectDevice();
     void loadLogFile(const QString &filePath);
+    void cancelLogLoading();
     void playLog();
     void pauseLog();
     void stopLog();
     void seekLog(int time);
+    // Покадровый шаг (отрицательный - назад); воспроизведение при этом приостанавливается
+    void stepLog(int frames);
     void setSelectedPort(const QString &port);
     void refreshPorts();
     void autoConnect();
@@ -236,8 +300,10 @@ public slots:
 
 private slots:
     void updateLogPlayback();
-    void readCOMPortData();
-    void handleCOMPortError(QSerialPort::SerialPortError error);
+    void onPlaybackTimer();
+    void drainIngestQueue();
+    void updateLoadProgress();
+    void handleCOMPortError(QSerialPort::SerialPortError error, const QString &errorString);
     void updateDataDisplay();
     void setAngularSpeedUpdateFrequencyCOM(float frequency);
     void setAngularSpeedUpdateFrequencyLog(float frequency);
@@ -245,27 +311,49 @@ private slots:
 private:
     void updateHeadModel(float pitch, float roll, float yaw, float speedPitch, float speedRoll, float speedYaw, bool dizziness);
     void addNotification(const QString &message);
-    bool setupCOMPort();
+    bool setupCOMPort(bool resume = false);
     void cleanupCOMPort();
+    void closeIngestTransport();
     void safeDisconnect();
-    void processCOMPortData(const QByteArray &data);
+    // Калибровка кадра из очереди приёма; true - кадр принят и может быть показан
+    bool processIngestedFrame(DataFrame &frame);
     void calculateSpeeds(float pitch, float roll, float yaw, bool dizziness);
 
     // Новые методы для работы с кольцевым буфером
-    void updateGraphDataFromBuffer();
-    void processDataFrame(const DataFrame& frame);
+    // seeking - график перестраивается для перемотки (окна лог-файла кэшируются)
+    void updateGraphDataFromBuffer(bool seeking = false);
+    bool processDataFrame(const DataFrame& frame);
+    void publishDataFrame(const DataFrame& frame);
     QString generateResearchFileName(const QString &number);
     void writeResearchHeader();
 
+    // Фоновая загрузка лог-файла: первый экран и окончательный результат
+    void applyLogPreview(quint64 generation, const QStringList &headerLines, const SampleStore &preview);
+    void finishLogLoad(quint64 generation, const QString &fileName, bool ok,
+                       const QSharedPointer<LogFileContents> &contents);
+
     // Новые методы для работы с LogReader
     void updateAngularSpeeds();
     void setupLogReader();
+    // Фоновый расчёт скоростей по всей записи для текущего окна сглаживания
+    void updateSpeedChannels();
+    void cancelSpeedChannels();
+    // Показ записи под курсором воспроизведения: модель, головокружение, время.
+    // logTime >= 0 - момент показа кадра: положение головы интерполируется к нему
+    void showLogSample(bool updateSpeeds, double logTime = -1.0);
+    // Живой режим с бюджетом задержки: положение на (сейчас - задержка) между принятыми кадрами
+    QVector3D liveAngles(const DataFrame &newest) const;
+    void updateLiveOrientation();
+    double sessionTimeNow() const;  // мс от m_startTime по монотонным часам
+    // Графики перестраиваются не чаще раза в interval мс; один счётчик на все режимы
+    void updateGraphsThrottled(qint64 interval);
+    // Время (нс по m_playbackClock), к которому относится текущий кадр воспроизведения
+    qint64 playbackFrameTime() const;
 
     HeadModel m_headModel;
+    ResearchCatalog m_researchCatalog;
     QTimer m_logTimer;
     QTimer m_autoConnectTimer;
-    QTimer m_safetyTimer;
-    QSerialPort *m_serialPort = nullptr;
 
     bool m_connected = false;
     bool m_logPlaying = false;
@@ -276,33 +364,45 @@ private:
     QString m_notification;
     QStringList m_availablePorts;
     QString m_selectedPort;
+    QString m_sessionPort;      // Порт текущей сессии, к нему идёт переподключение
     QString m_studyInfo;
 
     // Кольцевой буфер для хранения данных
     CircularBuffer m_dataBuffer;
 
-    struct LogEntry {
-        int time;
-        float pitch;
-        float roll;
-        float yaw;
-        float speedPitch;
-        float speedRoll;
-        float speedYaw;
-        bool dizziness;
-        bool doctorDizziness;  // Добавляем поле для головокружения врача
-
-        LogEntry() : time(0), pitch(0), roll(0), yaw(0),
-            speedPitch(0), speedRoll(0), speedYaw(0),
-            dizziness(false), doctorDizziness(false) {}
-    };
-
-    QVector<LogEntry> m_logData;
-    int m_currentLogIndex = 0;
+    // Загруженное исследование (колонки общие с LogReader)
+    SampleStore m_samples;
+
+    // Фоновая загрузка лог-файла
+    QThreadPool m_loadPool;
+    QSharedPointer<LogLoadControl> m_loadControl;
+    QTimer m_loadProgressTimer;
+    quint64 m_loadGeneration = 0;   // Номер последней начатой загрузки
+    quint64 m_speedChannelsGeneration = 0;  // Номер последнего расчёта AngularSpeedChannels
+    QSharedPointer<std::atomic<bool>> m_speedChannelsCancelled;
+    bool m_loading = false;
+    double m_loadProgress = 0.0;
+    // Бюджет памяти под записи исследования, МБ. Файлы больше него открываются постранично
+    int m_logMemoryBudget = 512;
+    // Текущая запись воспроизведения
+    PlaybackCursor m_logCursor;
+    double m_playbackRate = 1.0;
+    bool m_playbackReverse = false;
+
+    // Плавное движение 3D-модели между записями (orientation_interpolator.h)
+    bool m_orientationInterpolation = true;
+    int m_liveLatencyBudget = 0;
+    OrientationInterpolator m_liveOrientation;
+    qint64 m_sessionClockOrigin = 0;    // m_playbackClock (нс) в момент m_startTime
 
-    QByteArray m_incompleteData;
     bool m_isCleaningUp = false;
 
+    // Приём данных в отдельном потоке: воркер -> SPSC-очередь -> GUI-поток
+    SpscRingBuffer<DataFrame> m_ingestQueue{4096};
+    QThread m_ingestThread;
+    IngestWorker *m_ingestWorker = nullptr;
+    QTimer m_ingestDrainTimer;  // Выборка очереди один раз за кадр отрисовки
+
     // Данные для графиков
     int m_graphDuration = 30;
     QVariantList m_pitchGraphData;
@@ -326,8 +426,9 @@ private:
     // Исследование
     bool m_recording = false;
     QString m_researchNumber = "000001";
-    QFile *m_researchFile = nullptr;
-    QTextStream *m_researchStream = nullptr;
+    ResearchRecorder m_researchRecorder;
+    bool m_compressedRecording = false;     // Запись в сжатый архив .mha
+    bool m_recordingErrorReported = false;  // Об ошибке записи уже сообщено
     QDateTime m_researchStartTime;
     int m_researchFrameCounter = 1;
 
@@ -348,14 +449,13 @@ private:
 
     qint64 m_startTime; // Время начала работы для относительных временных меток
     qint64 m_lastDataTime; // Время последних полученных данных
-    bool m_useRelativeTime; // Флаг использования относительного времени
 
     bool m_patientDizziness = false;
     bool m_doctorDizziness = false;
 
     qint64 m_researchRecordingStartTime;  // Время начала записи исследования (в мс от начала подключения)
 
-    void updateGraphDataFromLogFile();
+    void updateGraphDataFromLogFile(bool seeking = false);
     void updateGraphDataFromCOMPort();
 
     // Оптимизация для лог-файла: работаем напрямую с данными, без кольцевого буфера
@@ -363,12 +463,42 @@ private:
 
     int findLogIndexByTime(qint64 targetTime);
 
+    // Перемотка: ползунок присылает позицию на каждое движение мыши, выполняется
+    // не чаще раза за кадр отрисовки и только последняя запрошенная позиция
+    static const int SeekIntervalMs = 16;
+    void applyPendingSeek();
+    QTimer m_seekTimer;
+    QElapsedTimer m_seekClock;
+    int m_pendingSeekTime = -1;     // -1 - перемотка не запрошена
+
+    // Точек графика лог-файла после прореживания
+    static const int GraphTargetPoints = 200;
+
+    // Построенные окна графика лог-файла по (правому краю окна, длительности).
+    // Кэшируются только окна перемотки: правый край округляется до шага прореживания,
+    // поэтому при перетаскивании ползунка туда-обратно ключи повторяются, и окно берётся
+    // из кэша без прохода по записям. Воспроизведение сдвигает окно на каждом кадре
+    // и кэш не заполняет
+    struct GraphWindow {
+        QVariantList pitch;
+        QVariantList roll;
+        QVariantList yaw;
+        QVariantList patientDizziness;
+        QVariantList doctorDizziness;
+    };
+    QCache<QPair<qint64, int>, GraphWindow> m_graphWindowCache{32};
+
     int m_logUpdateFrequency;  // Частота обновления для лог-режима
 
-    // Для синхронизации времени воспроизведения
-    qint64 m_playbackStartRealTime;  // Реальное время начала воспроизведения
+    // Для синхронизации времени воспроизведения. Часы монотонные (QElapsedTimer):
+    // не скачут при коррекции системного времени и точнее миллисекунды
+    QElapsedTimer m_playbackClock;
+    qint64 m_playbackStartClock = 0; // Время часов (нс) начала воспроизведения
     qint64 m_playbackStartLogTime;   // Время в логе на момент начала воспроизведения
     bool m_playbackTimeInitialized;  // Флаг инициализации времени
+    QPointer<QQuickWindow> m_frameWindow;
+    bool m_frameTick = false;        // Обновление вызвано кадром окна, а не таймером
+    qint64 m_lastGraphUpdate = 0;    // мс по m_playbackClock
 
     qint64 m_graphDisplayTime;  // Время для отображения графика (независимо от воспроизведения)
 
@@ -398,17 +528,15 @@ private:
 
     Q_PROPERTY(float angularSpeedUpdateFrequency READ angularSpeedUpdateFrequency WRITE setAngularSpeedUpdateFrequency NOTIFY angularSpeedUpdateFrequencyChanged)
 
-    // Для усреднения данных COM-порта
-    QVector<AngleDataPoint> m_comPitchBuffer;
-    QVector<AngleDataPoint> m_comRollBuffer;
-    QVector<AngleDataPoint> m_comYawBuffer;
-    QTimer m_comSpeedUpdateTimer;
+    // Скорость в реальном времени: оценка обновляется с каждым кадром,
+    // на экран выводится с частотой m_angularSpeedUpdateFrequencyCOM
+    static const qint64 LiveSpeedWindowMs = 500;   // Как окно сглаживания при воспроизведении по умолчанию
+    AngularSpeedEstimator m_comSpeedEstimator;
+    qint64 m_lastComSpeedDisplay = -1;  // m_playbackClock, мс
     float m_currentComSpeedPitch = 0.0f;
     float m_currentComSpeedRoll = 0.0f;
     float m_currentComSpeedYaw = 0.0f;
 
-    void updateCOMAngularSpeeds();
-    float calculateCOMAngularSpeed(QVector<AngleDataPoint>& dataBuffer);
     void clearCOMBuffers();
 
     float m_angularSpeedUpdateFrequencyCOM = 4.0f;  // для COM-порта
@@ -431,18 +559,58 @@ private:
     bool m_calibrationActive = false;
 
     // WiFi соединение
-    QTcpSocket *m_tcpSocket = nullptr;
     QString m_wifiAddress = "192.168.4.1";
     int m_wifiPort = 8080;
     bool m_wifiConnected = false;
-    QString m_connectionType = "COM"; // "COM" или "WiFi"
+    bool m_wifiConnecting = false;  // Ожидается результат подключения из потока приёма
+    bool m_wifiResuming = false;    // Ожидаемое подключение продолжает прерванную сессию
+
+    QString m_streamFormat;
+    qint64 m_lostPackets = 0;
+    qint64 m_lostPacketsBase = 0;   // Потери до переподключения в той же сессии
+    double m_timingJitter = 0.0;
+    double m_clockDrift = 0.0;
+    QString m_connectionType = "COM"; // "COM", "WiFi" (TCP) или "UDP"
 
     // Сигналы для WiFi
-    void setupWiFiConnection();
+    void setupWiFiConnection(bool resume = false);
+    void setupUdpConnection(bool resume = false);
+    void completeWiFiOpen();
     void cleanupWiFiConnection();
-    void readWiFiData();
-    void handleWiFiError(QAbstractSocket::SocketError error);
-    void handleWiFiStateChanged(QAbstractSocket::SocketState state);
+    void handleWiFiConnectFinished(bool ok, const QString &errorString);
+    void handleWiFiError(const QString &errorString);
+    void handleWiFiDisconnected();
+    void handleStreamFormatDetected(int format);
+    void handleLostPacketsChanged(quint64 lostPackets);
+    void handleTimebaseUpdated(double jitterMs, double driftPpm);
+    void resetStreamInfo();
+
+    // Наблюдение за COM-портами (поток наблюдателя, список кэшируется здесь)
+    QThread m_portWatcherThread;
+    PortWatcher *m_portWatcher = nullptr;
+    void handlePortsChanged(const QStringList &ports);
+
+    // Состояние подключения и переподключение с паузами
+    ConnectionManager m_connectionManager;
+    void openTransport(bool resume);
+    void handleLinkLost(const QString &reason);
+    void handleSessionResumed(int attempts);
+    void handleSessionRestarted(int attempts);
+    void handleConnectFailed(const QString &errorString);
+    void handleReconnectGaveUp();
+    void handleConnectionStateChanged();
+
+    // Статистика приёма: последняя копия из потока приёма плюс сессии до переподключений
+    IngestStats m_ingestStats;
+    IngestStats m_ingestStatsBase;
+    IngestStats m_researchStatsStart;   // На момент начала записи исследования
+    qint64 m_researchLostPacketsStart = 0;
+    int m_ingestBacklog = 0;
+    int m_maxIngestBacklog = 0;
+    IngestStats sessionIngestStats() const;
+    void refreshIngestStats();
+    void handleIngestStats(const IngestStats &stats);
+    void writeResearchTrailer();
 
     void resetAllData();
 
@@ -453,18 +621,26 @@ signals:
     void currentTimeChanged(int time);
     void totalTimeChanged(int time);
     void logPlayingChanged(bool playing);
+    void playbackRateChanged(double rate);
+    void playbackReverseChanged(bool reverse);
+    void orientationInterpolationChanged(bool enabled);
+    void liveLatencyBudgetChanged(int milliseconds);
     void notificationChanged(const QString &message);
     void availablePortsChanged();
     void selectedPortChanged();
     void logLoadedChanged(bool loaded);
     void logModeChanged(bool logMode);
     void logControlsEnabledChanged(bool enabled);
+    void loadingChanged(bool loading);
+    void loadProgressChanged(double progress);
+    void logMemoryBudgetChanged(int megabytes);
     void studyInfoChanged(const QString &studyInfo);
     void graphDurationChanged(int duration);
     void graphDataChanged();
     void updateFrequencyChanged(int frequency);
     void researchNumberChanged(const QString &researchNumber);
     void recordingChanged(bool recording);
+    void compressedRecordingChanged(bool compressed);
     void patientDizzinessChanged(bool patientDizziness);
     void doctorDizzinessChanged(bool doctorDizziness);
     void angularSpeedUpdateFrequencyChanged(float frequency);
@@ -479,9 +655,14 @@ signals:
     void calibrationChanged();
 
     void connectionTypeChanged(const QString &type);
+    void connectionStateChanged(const QString &state);
+    void ingestStatsChanged();
     void wifiAddressChanged(const QString &address);
     void wifiPortChanged(int port);
     void wifiConnectedChanged(bool connected);
+    void streamFormatChanged(const QString &format);
+    void lostPacketsChanged(qint64 lostPackets);
+    void timebaseChanged();
 };
 
 #endif // TILTCONTROLLER_H